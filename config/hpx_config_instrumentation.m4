@@ -9,12 +9,15 @@ AC_DEFUN([HPX_CONFIG_INSTRUMENTATION], [
 
  AS_IF([test "x$enable_instrumentation" != xno],
   [AC_DEFINE([ENABLE_INSTRUMENTATION], [1], [Enable instrumentationging stuff])
-   have_instrumentation=yes],
- AC_CONFIG_COMMANDS([include/libhpx/event_stubs.h],
+   have_instrumentation=yes])
+
+ # Generate the EVENT_<class>_<event>(...) macros from events.def, since the
+ # preprocessor can't. See include/libhpx/events.h.
+ AC_CONFIG_COMMANDS([include/libhpx/event_macros.h],
   [mkdir -p "${objroot}include/libhpx/"
-   cat "${srcdir}/include/libhpx/events.def" | grep -v "//" | tr -d '\n' | sed 's/LIBHPX_EVENT/\'$'\nLIBHPX_EVENT/g' | sed 's/LIBHPX_EVENT([[ ]]*\([[a-zA-Z0-9_]]*\),[[ ]]*\([[a-zA-Z0-9_]]*\).*)/#define EVENT_\1_\2(...)/g' > "${objroot}include/libhpx/event_stubs.h"]
+   cat "${srcdir}/include/libhpx/events.def" | grep -v "//" | tr -d '\n' | sed 's/LIBHPX_EVENT/\'$'\nLIBHPX_EVENT/g' | sed 's/LIBHPX_EVENT([[ ]]*\([[a-zA-Z0-9_]]*\),[[ ]]*\([[a-zA-Z0-9_]]*\).*)/#define EVENT_\1_\2(...) LIBHPX_EMIT(\1, \2, __VA_ARGS__)/g' > "${objroot}include/libhpx/event_macros.h"],
   [srcdir="${srcdir}"
-   objroot="${objroot}"]))
+   objroot="${objroot}"])
 
  AM_CONDITIONAL([ENABLE_INSTRUMENTATION], [test "x$enable_instrumentation" != xno])
 ])
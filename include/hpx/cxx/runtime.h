@@ -131,6 +131,20 @@ inline void print_version(void) {
   hpx_print_version();
 }
 
+/// Write the per-action profiles for this locality as CSV.
+///
+/// @param     filename The file to write, or nullptr to write to stdout.
+inline int profile_dump(const char* filename = nullptr) {
+  return hpx_profile_dump(filename);
+}
+
+/// Write the per-worker scheduler accounting for this locality as CSV.
+///
+/// @param     filename The file to write, or nullptr to write to stdout.
+inline int sched_dump(const char* filename = nullptr) {
+  return hpx_sched_dump(filename);
+}
+
 /// @}
 } // namespace hpx
 
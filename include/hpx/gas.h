@@ -38,6 +38,13 @@ typedef hpx_addr_t (*hpx_gas_dist_t)(uint32_t i, size_t n, size_t bsize);
 #define HPX_GAS_DIST_CYCLIC  (hpx_gas_dist_t)0x2  //!< Cyclic distribution type
 #define HPX_GAS_DIST_BLOCKED (hpx_gas_dist_t)0x4  //!< Blocked distribution type
 
+// GAS affinity range policies.
+typedef enum {
+  HPX_AFFINITY_CYCLIC = 0, //!< Block i is bound to worker i % nworkers.
+  HPX_AFFINITY_BLOCKED,    //!< Contiguous chunks of blocks per worker.
+  HPX_AFFINITY_NUMA        //!< Contiguous chunks per NUMA node, cyclic within.
+} hpx_affinity_policy_t;
+
 // GAS Attributes.
 #define HPX_GAS_ATTR_NONE  0x0  //!< Empty attribute.
 #define HPX_GAS_ATTR_RO    0x1  //!< This block is read-only.
@@ -647,9 +654,7 @@ void hpx_gas_rebalance(hpx_addr_t async, hpx_addr_t psync, hpx_addr_t msync)
 /// results in undefined behavior. Implementations are encouraged to provide
 /// debug builds that check for these conditions dynamically.
 ///
-/// Future versions of this interface may provide the ability to set the
-/// affinity for a range of addresses, to allow parcel sends to "internal"
-/// addresses rather than simple unique targets.
+/// See hpx_gas_set_affinity_range() to bind a whole array at once.
 ///
 /// @param         addr The address to bind.
 /// @param       worker The computation resource id to bind affinity to.
@@ -671,6 +676,36 @@ void hpx_gas_set_affinity(hpx_addr_t addr, int worker)
 void hpx_gas_clear_affinity(hpx_addr_t addr)
   HPX_PUBLIC;
 
+/// Set the (soft) affinity for a range of blocks.
+///
+/// This binds each of the @p n blocks of @p bsize bytes starting at @p base to
+/// a worker chosen by @p policy, without creating a per-block binding. The
+/// range must be a contiguous, local allocation, such as one returned by
+/// hpx_gas_alloc_local(). Lookups cost O(log r) in the number of bound ranges,
+/// independent of @p n.
+///
+/// Bindings set with hpx_gas_set_affinity() take precedence over range
+/// bindings. Binding a range that overlaps an existing range replaces it. The
+/// same restrictions on locality and movement apply as for
+/// hpx_gas_set_affinity().
+///
+/// @param         base The address of the first block.
+/// @param            n The number of blocks in the range.
+/// @param        bsize The number of bytes per block.
+/// @param       policy The policy used to map blocks to workers.
+void hpx_gas_set_affinity_range(hpx_addr_t base, size_t n, size_t bsize,
+                                hpx_affinity_policy_t policy)
+  HPX_PUBLIC;
+
+/// Clear the (soft) affinity for a range of blocks.
+///
+/// This clears a binding created with hpx_gas_set_affinity_range(). It is not
+/// an error to clear a range that is not bound.
+///
+/// @param         base The address of the first block in the range.
+void hpx_gas_clear_affinity_range(hpx_addr_t base)
+  HPX_PUBLIC;
+
 /// @}
 
 #ifdef __cplusplus
@@ -27,6 +27,7 @@ extern "C" {
 
 #include <hpx/addr.h>
 #include <hpx/attributes.h>
+#include <hpx/gas.h>
 #include <hpx/types.h>
 
 /// These are the operations associated with the generic LCO class.
@@ -302,8 +303,8 @@ hpx_addr_t hpx_lco_sema_new(unsigned init)
 
 /// Standard semaphore V (signal) operation.
 ///
-/// Increments the count in the semaphore, signaling the LCO if the increment
-/// transitions from 0 to 1.
+/// If threads are waiting on the semaphore, hands the permit directly to the
+/// one that has waited longest, otherwise increments the count.
 ///
 /// This is locally asynchronous, it will potentially return before the
 /// operation completes. Clients that need a signal when the set operation has
@@ -316,8 +317,8 @@ void hpx_lco_sema_v(hpx_addr_t sema, hpx_addr_t rsync)
 
 /// Standard semaphore V (signal) operation.
 ///
-/// Increments the count in the semaphore, signaling the LCO if the increment
-/// transitions from 0 to 1.
+/// If threads are waiting on the semaphore, hands the permit directly to the
+/// one that has waited longest, otherwise increments the count.
 ///
 /// @param        sema The global address of a semaphore.
 void hpx_lco_sema_v_sync(hpx_addr_t sema)
@@ -326,6 +327,7 @@ void hpx_lco_sema_v_sync(hpx_addr_t sema)
 /// Standard semaphore P (wait) operation.
 ///
 /// Attempts to decrement the count in the semaphore; blocks if the count is 0.
+/// Blocked threads are granted permits in the order in which they arrived.
 ///
 /// @param        sema the global address of a semaphore
 ///
@@ -344,6 +346,23 @@ hpx_status_t hpx_lco_sema_p(hpx_addr_t sema)
 hpx_addr_t hpx_lco_and_new(int64_t inputs)
   HPX_PUBLIC;
 
+/// Create an "and" LCO as a combining tree.
+///
+/// The tree has a node at every locality. Sets from a remote locality are
+/// counted at that locality's node, and the counts are sent up the tree toward
+/// the root in batches. The returned address is the root and can be used
+/// anywhere an hpx_lco_and_new() LCO can be used. A set with a remote
+/// completion, e.g., hpx_lco_set_rsync(), isn't batched, so that it can report
+/// whether it completed the tree.
+///
+/// @param inputs the number of inputs to the and (must be >= 0)
+/// @param  arity the fan-in of each interior node (must be > 1)
+///
+/// @returns The global address of the root of the tree, or HPX_NULL if the
+///          tree could not be allocated.
+hpx_addr_t hpx_lco_and_tree_new(int64_t inputs, int arity)
+  HPX_PUBLIC;
+
 /// Join an "and" LCO, triggering it (i.e. setting it) if appropriate.
 ///
 /// If this set is the last one the "and" LCO is waiting on, the "and" LCO
@@ -406,6 +425,64 @@ hpx_addr_t hpx_lco_future_array_at(hpx_addr_t base, int i, int size, int bsize)
 hpx_addr_t hpx_lco_array_at(hpx_addr_t base, int i, size_t size)
   HPX_PUBLIC;
 
+/// The number of bytes reserved for a stack-resident waiter.
+#define HPX_LCO_WAITER_BYTES 64
+
+/// A stack-resident, single-use waiter LCO.
+///
+/// Waiters replace the common "allocate a future, wait on it, delete it"
+/// pattern for synchronous operations. A waiter lives in the caller's stack
+/// frame rather than in the global heap, but it has a global address that
+/// can be used as an lsync, rsync, or continuation target from any locality,
+/// and with the generic hpx_lco_* operations.
+///
+/// @code
+///   int value;
+///   hpx_lco_waiter_t waiter;
+///   hpx_addr_t sync = hpx_lco_waiter_init(&waiter, sizeof(value), &value);
+///   hpx_call(addr, action, sync, ...);
+///   hpx_status_t status = hpx_lco_waiter_wait(&waiter);
+///   hpx_lco_waiter_fini(&waiter);
+/// @endcode
+///
+/// A waiter must be finalized with hpx_lco_waiter_fini() before the frame it
+/// lives in returns, and must never be passed to hpx_lco_delete().
+typedef struct {
+  char opaque[HPX_LCO_WAITER_BYTES];
+} HPX_ALIGNED(HPX_LCO_WAITER_BYTES) hpx_lco_waiter_t;
+
+/// Initialize a waiter.
+///
+/// The value set on the waiter is written directly to @p out, truncated to
+/// @p size bytes.
+///
+/// @param   waiter The waiter to initialize.
+/// @param     size The number of bytes available at @p out (may be 0).
+/// @param      out The buffer to receive the waiter's value (may be NULL).
+///
+/// @returns The global address of the waiter.
+hpx_addr_t hpx_lco_waiter_init(hpx_lco_waiter_t *waiter, size_t size,
+                               void *out)
+  HPX_PUBLIC;
+
+/// Wait for a waiter to be set.
+///
+/// @param   waiter The waiter to wait for.
+///
+/// @returns HPX_SUCCESS, or the error code that was set on the waiter.
+hpx_status_t hpx_lco_waiter_wait(hpx_lco_waiter_t *waiter)
+  HPX_PUBLIC;
+
+/// Finalize a waiter.
+///
+/// Setters don't touch the waiter once it is set, so its storage may be reused
+/// as soon as hpx_lco_waiter_wait() returns. A waiter that may still be set
+/// must not be finalized.
+///
+/// @param   waiter The waiter to finalize.
+void hpx_lco_waiter_fini(hpx_lco_waiter_t *waiter)
+  HPX_PUBLIC;
+
 /// Allocate a new generation counter.
 ///
 /// A generation counter allows an application programmer to efficiently wait
@@ -465,6 +542,24 @@ hpx_addr_t hpx_lco_reduce_new(int inputs, size_t size, hpx_action_t id,
                               hpx_action_t op)
   HPX_PUBLIC;
 
+/// Allocate a new reduce LCO as a combining tree.
+///
+/// This is the tree version of hpx_lco_reduce_new(). Inputs are reduced at
+/// the node on the setting locality, and only the partial results move up the
+/// tree. The returned address is the root.
+///
+/// @param inputs       The static number of inputs to the reduction.
+/// @param size         The size of the data being reduced.
+/// @param id           An initialization function for the data.
+/// @param op           The commutative-associative operation we're performing.
+/// @param arity        The fan-in of each interior node (must be > 1).
+///
+/// @returns The global address of the root of the tree, or HPX_NULL if the
+///          tree could not be allocated.
+hpx_addr_t hpx_lco_reduce_tree_new(int inputs, size_t size, hpx_action_t id,
+                                   hpx_action_t op, int arity)
+  HPX_PUBLIC;
+
 /// Allocate a new allreduce LCO.
 ///
 /// The reduction is allocated in reduce-mode, i.e., it expects @p participants
@@ -489,6 +584,29 @@ hpx_addr_t hpx_lco_allreduce_new(size_t participants, size_t readers, size_t siz
                                  hpx_action_t id, hpx_action_t op)
   HPX_PUBLIC;
 
+/// Allocate a new persistent allreduce LCO.
+///
+/// A persistent allreduce is meant for iterative codes that reduce the same
+/// kind of value with the same participants every iteration. Each of the @p
+/// participants joins exactly once per epoch through one of the
+/// hpx_lco_allreduce_join() interfaces, and must have the result of an epoch
+/// before it joins the next one. Joins combine their values through a
+/// combining tree that is fixed when the LCO is allocated and never take the
+/// LCO's lock, so back-to-back epochs are cheap.
+///
+/// The results are double-buffered. hpx_lco_getref() returns a pointer to the
+/// latest result without a copy, which remains valid until the epoch after
+/// next completes. hpx_lco_get() copies out the latest result.
+///
+/// @param participants The static number of participants in the reduction.
+/// @param         size The size of the data being reduced.
+/// @param           op The commutative-associative operation we're performing.
+///
+/// @returns            The newly allocated LCO, or HPX_NULL on error.
+hpx_addr_t hpx_lco_allreduce_persistent_new(size_t participants, size_t size,
+                                            hpx_action_t op)
+  HPX_PUBLIC;
+
 /// Join an allreduce LCO.
 ///
 /// This version of the join operation allows an arbitrary continuation for the
@@ -612,6 +730,51 @@ hpx_status_t hpx_lco_alltoall_getid(hpx_addr_t alltoall, unsigned id, int size,
 hpx_addr_t hpx_lco_alltoall_new(size_t inputs, size_t size)
   HPX_PUBLIC;
 
+/// Allocate a distributed, pairwise alltoall.
+///
+/// The pairwise alltoall has the same interface as the alltoall LCO, but
+/// keeps a separate receive buffer for each participant, allocated cyclically.
+/// Setting a row puts each of its elements directly into the receiver's
+/// buffer, so no single locality handles all of the data. Each participant
+/// must alternate between hpx_lco_alltoall_pairwise_setid() and
+/// hpx_lco_alltoall_pairwise_getid() with its own id. The collective is freed
+/// with hpx_lco_delete().
+///
+/// @param inputs The number of participants in the alltoall.
+/// @param size   The size of each participant's row, a multiple of @p inputs.
+hpx_addr_t hpx_lco_alltoall_pairwise_new(size_t inputs, size_t size)
+  HPX_PUBLIC;
+
+/// Scatter a row to a pairwise alltoall.
+///
+/// The @p rsync LCO is set once every element of the row has been handed off
+/// to the network; the receivers observe completion through getid.
+///
+/// @param alltoall    The pairwise alltoall.
+/// @param id          The ID of our rank.
+/// @param size        The size of the row in @p value.
+/// @param value       A pointer to @p size bytes to scatter, which need not be
+///                    registered.
+/// @param lsync       An LCO to test for local completion.
+/// @param rsync       An LCO to test for remote completion.
+hpx_status_t hpx_lco_alltoall_pairwise_setid(hpx_addr_t alltoall, unsigned id,
+                                             int size, const void *value,
+                                             hpx_addr_t lsync, hpx_addr_t rsync)
+  HPX_PUBLIC;
+
+/// Gather the row for @p id from a pairwise alltoall.
+///
+/// This waits until every participant has scattered to @p id for the current
+/// epoch.
+///
+/// @param   alltoall    The pairwise alltoall.
+/// @param   id          The ID of our rank.
+/// @param   size        The size of the row.
+/// @param   value       Address of the value buffer.
+hpx_status_t hpx_lco_alltoall_pairwise_getid(hpx_addr_t alltoall, unsigned id,
+                                             int size, void *value)
+  HPX_PUBLIC;
+
 /// Allocate a user-defined LCO.
 ///
 /// @param size         The size of the LCO buffer.
@@ -653,6 +816,54 @@ int _hpx_lco_dataflow_add(hpx_addr_t lco, hpx_action_t action,
   _hpx_lco_dataflow_add(lco, action, out, __HPX_NARGS(__VA_ARGS__) , \
                         ##__VA_ARGS__)
 
+/// Add a task to the graph of a dataflow LCO.
+///
+/// The tasks added with this interface form a graph that can be run any number
+/// of times with hpx_lco_dataflow_run(). A task runs @p action once each of
+/// its @p n input tasks has produced an output in the current run. The action
+/// is called like the actions given to hpx_lco_dataflow_add(), with an array of
+/// pointers to the outputs of the input tasks, in order, and must continue
+/// exactly @p size bytes. Tasks with no inputs start each run.
+///
+/// Each task runs at the locality that owns @p at, or next to its largest
+/// input if @p at is HPX_NULL. Tasks can be added from concurrent threads, but
+/// the graph must not be modified while it is running.
+///
+/// @param lco      The dataflow LCO.
+/// @param action   The action to run.
+/// @param size     The number of bytes that @p action continues.
+/// @param n        The number of input tasks.
+/// @param inputs   The ids of the input tasks.
+/// @param at       An address to place the task near, or HPX_NULL.
+///
+/// @returns        The id of the new task, or -1 on error.
+int hpx_lco_dataflow_task(hpx_addr_t lco, hpx_action_t action, size_t size,
+                          int n, const int inputs[], hpx_addr_t at)
+  HPX_PUBLIC;
+
+/// Start a run of the task graph of a dataflow LCO.
+///
+/// The LCO is reset, and is set again when every task without consumers has
+/// run, so the run can be waited for with hpx_lco_wait().
+///
+/// @param lco      The dataflow LCO.
+///
+/// @returns        HPX_SUCCESS, or an error code.
+hpx_status_t hpx_lco_dataflow_run(hpx_addr_t lco)
+  HPX_PUBLIC;
+
+/// Get the output of a task without consumers from the last run.
+///
+/// @param lco      The dataflow LCO.
+/// @param task     The id of the task.
+/// @param size     The size of the task's output.
+/// @param out      The buffer for the output.
+///
+/// @returns        HPX_SUCCESS, or an error code.
+hpx_status_t hpx_lco_dataflow_get_output(hpx_addr_t lco, int task, size_t size,
+                                         void *out)
+  HPX_PUBLIC;
+
 /// LCO reduction operators.
 ///
 /// The commutative-associative (monoid) operation type.
@@ -664,13 +875,23 @@ typedef void (*hpx_monoid_op_t)(void *lhs, const void *rhs, size_t bytes);
 
 /// Helper macro to declare the monoid operators for an LCO @p
 /// reduction of a given @p TYPE.
-#define _HPX_MONOID_DECL(TYPE,REDUCTION,dtype)                      \
-  void HPX_##TYPE##REDUCTION##ID(dtype *, size_t);                  \
-  void HPX_##TYPE##REDUCTION##OP(dtype *, const dtype *, size_t);
+///
+/// The operators treat the buffer as an array of bytes / sizeof(dtype)
+/// elements, so they can be used for both scalar and vector reductions. Each
+/// operator is also registered as a function action, named with an _ACTION
+/// suffix, that can be passed directly to the reduction LCO constructors.
+#define _HPX_MONOID_DECL(TYPE,REDUCTION,dtype)                          \
+  void HPX_##TYPE##REDUCTION##ID(dtype *, size_t) HPX_PUBLIC;           \
+  void HPX_##TYPE##REDUCTION##OP(dtype *, const dtype *, size_t)        \
+    HPX_PUBLIC;                                                         \
+  HPX_PUBLIC extern HPX_ACTION_DECL(HPX_##TYPE##REDUCTION##ID_ACTION);  \
+  HPX_PUBLIC extern HPX_ACTION_DECL(HPX_##TYPE##REDUCTION##OP_ACTION);
 
 /// Helper macro to declare a LCO @p reduction for a list of types.
 #define _HPX_REDUCTION_DECL(R)               \
   _HPX_MONOID_DECL(INT_,    R, int)          \
+  _HPX_MONOID_DECL(INT32_,  R, int32_t)      \
+  _HPX_MONOID_DECL(INT64_,  R, int64_t)      \
   _HPX_MONOID_DECL(DOUBLE_, R, double)       \
   _HPX_MONOID_DECL(FLOAT_,  R, float)
 
@@ -769,6 +990,76 @@ hpx_addr_t hpx_lco_user_local_array_new(int n, size_t size,
                                         hpx_action_t predicate, void *init,
                                         size_t init_size)
   HPX_PUBLIC;
+
+/// Sharded LCO arrays.
+///
+/// These allocate arrays of LCOs local to the calling locality. Each element is
+/// padded to a whole number of cachelines and is bound to a worker with
+/// hpx_gas_set_affinity_range() using @p policy, so that parcels that target
+/// an element run on its worker. With the blocked and NUMA policies, the
+/// pages that hold each worker's elements are also placed on that worker's
+/// NUMA node. Elements are constructed by their worker.
+///
+/// Sharded arrays must be indexed with hpx_lco_sharded_array_at() and deleted
+/// with hpx_lco_sharded_array_delete().
+///
+/// Allocate a sharded array of futures.
+/// @param          n The (total) number of lcos to allocate
+/// @param       size The size of each future's value
+/// @param     policy The policy that maps elements to workers
+///
+/// @returns the global address of the allocated array lco.
+hpx_addr_t hpx_lco_future_sharded_array_new(int n, int size,
+                                            hpx_affinity_policy_t policy)
+  HPX_PUBLIC;
+
+/// Allocate a sharded array of and LCOs.
+/// @param          n The (total) number of lcos to allocate
+/// @param     inputs number of inputs to the and (must be >= 0)
+/// @param     policy The policy that maps elements to workers
+///
+/// @returns the global address of the allocated array lco.
+hpx_addr_t hpx_lco_and_sharded_array_new(int n, int inputs,
+                                         hpx_affinity_policy_t policy)
+  HPX_PUBLIC;
+
+/// Allocate a sharded array of reduce LCOs.
+/// @param          n The (total) number of lcos to allocate
+/// @param     inputs The static number of inputs to the reduction.
+/// @param       size The size of the data being reduced.
+/// @param         id An initialization function for the data.
+/// @param         op The commutative-associative operation we're
+///                   performing.
+/// @param     policy The policy that maps elements to workers
+///
+/// @returns the global address of the allocated array lco.
+hpx_addr_t hpx_lco_reduce_sharded_array_new(int n, int inputs, size_t size,
+                                            hpx_action_t id, hpx_action_t op,
+                                            hpx_affinity_policy_t policy)
+  HPX_PUBLIC;
+
+/// Get the address of an element in a sharded LCO array.
+///
+/// @param      base The base address of the array.
+/// @param         i The index of the element.
+/// @param      size The size of the value stored with each element.
+///
+/// @returns The address of the ith element.
+hpx_addr_t hpx_lco_sharded_array_at(hpx_addr_t base, int i, size_t size)
+  HPX_PUBLIC;
+
+/// Delete a sharded LCO array.
+///
+/// This destroys each of the @p n elements, clears the array's affinity
+/// binding, and frees the array.
+///
+/// @param      base The base address of the array.
+/// @param         n The number of elements in the array.
+/// @param      size The size of the value stored with each element.
+/// @param     rsync An LCO to set when the array has been freed.
+void hpx_lco_sharded_array_delete(hpx_addr_t base, int n, size_t size,
+                                  hpx_addr_t rsync)
+  HPX_PUBLIC;
 /// @}
 
 #ifdef __cplusplus
@@ -152,6 +152,38 @@ void hpx_print_help(void)
 void hpx_print_version(void)
   HPX_PUBLIC;
 
+/// Write the per-action profiles for this locality as CSV.
+///
+/// When the runtime is built with instrumentation, each worker keeps
+/// histograms of handler execution time, queueing delay, and payload size for
+/// every action that it runs. This merges them and writes one row per action
+/// and metric, with the count, mean, 50th/90th/99th percentiles, maximum, and
+/// runs per second. With --hpx-trace-counters it also writes each hardware
+/// counter's mean per run. It can be called at any time.
+///
+/// @param     filename The file to write, or NULL to write to stdout.
+///
+/// @returns            HPX_SUCCESS, or an error if the file can't be opened.
+int hpx_profile_dump(const char *filename)
+  HPX_PUBLIC;
+
+/// Write the per-worker scheduler accounting for this locality as CSV.
+///
+/// When the runtime is built with instrumentation, each worker charges its
+/// time to the scheduler state that it's in (user, sched, network, steal, or
+/// sleep), and to idle when its scheduling passes find no work. It also counts
+/// its steal attempts and successes by the distance to the victim (core, numa,
+/// or remote). This writes one row per worker and metric, with the share of
+/// the worker's time or the steal success ratio, followed by the totals for
+/// all workers. It can be called at any time, including after hpx_run()
+/// returns.
+///
+/// @param     filename The file to write, or NULL to write to stdout.
+///
+/// @returns            HPX_SUCCESS, or an error if the file can't be opened.
+int hpx_sched_dump(const char *filename)
+  HPX_PUBLIC;
+
 /// @}
 
 #ifdef __cplusplus
@@ -15,6 +15,7 @@
 #define LIBHPX_GAS_H
 
 #include "libhpx/config.h"
+#include "libhpx/gpa.h"
 #include "libhpx/MemoryOps.h"
 #include "libhpx/StringOps.h"
 #include "libhpx/gas/Affinity.h"
@@ -47,6 +48,69 @@ class GAS : public virtual libhpx::gas::Affinity, public StringOps,
   virtual uint32_t getAttribute(hpx_addr_t gva) const = 0;
   virtual void setAttribute(hpx_addr_t gva, uint32_t attr) = 0;
   virtual void move(hpx_addr_t src, hpx_addr_t dst, hpx_addr_t lco) = 0;
+
+  /// Find the owner of a global address without going through the vtable.
+  ///
+  /// The concrete GAS type is fixed once in Create(), so the SMP and PGAS
+  /// address translations can be resolved inline. Only AGAS needs the virtual
+  /// ownerOf() call.
+  uint32_t owner(hpx_addr_t gva) const {
+    switch (type_) {
+     case HPX_GAS_SMP:
+      return 0;
+     case HPX_GAS_PGAS:
+      return gpa_to_rank(gva);
+     default:
+      return (isWaiter(gva)) ? WaiterRank(gva) : ownerOf(gva);
+    }
+  }
+
+  /// Stack-resident waiters (hpx_lco_waiter_t) are named with a reserved
+  /// address form rather than a heap allocation.
+  ///
+  /// In the distributed GASes the waiter's address carries the owning rank in
+  /// the top 16 bits, a tag in the next 6 bits, and the cacheline index of the
+  /// waiter in the low 42 bits. The tag overlaps heap offsets of WAITER_TAG and
+  /// above in PGAS, so its heap is limited to WAITER_TAG bytes, and cyclic
+  /// blocks larger than 1GB in AGAS (the 5-bit size field and the cyclic bit),
+  /// so its cyclic allocators reject them. In the SMP GAS addresses are already
+  /// local pointers so the waiter's address is simply its pointer.
+  /// @{
+  hpx_addr_t waiterToGVA(uint32_t rank, const void* lva) const {
+    uintptr_t ptr = reinterpret_cast<uintptr_t>(lva);
+    if (type_ == HPX_GAS_SMP) {
+      return ptr;
+    }
+    dbg_assert(!(ptr & (WAITER_ALIGN - 1)));
+    dbg_assert((ptr >> WAITER_LG_ALIGN) < WAITER_INDEX_MASK);
+    return (uint64_t(rank) << WAITER_RANK_SHIFT) | WAITER_TAG |
+      (ptr >> WAITER_LG_ALIGN);
+  }
+
+  bool isWaiter(hpx_addr_t gva) const {
+    return (type_ != HPX_GAS_SMP) &&
+      ((gva & WAITER_TAG) == WAITER_TAG) &&
+      ((gva & WAITER_INDEX_MASK) != WAITER_INDEX_MASK);
+  }
+
+  static uint32_t WaiterRank(hpx_addr_t gva) {
+    return uint32_t(gva >> WAITER_RANK_SHIFT);
+  }
+
+  static void* WaiterLVA(hpx_addr_t gva) {
+    return reinterpret_cast<void*>((gva & WAITER_INDEX_MASK) << WAITER_LG_ALIGN);
+  }
+
+  static constexpr uintptr_t WAITER_LG_ALIGN = 6;
+  static constexpr uintptr_t   WAITER_ALIGN = uintptr_t(1) << WAITER_LG_ALIGN;
+  static constexpr uint64_t      WAITER_TAG = UINT64_C(0x3F) << 42;
+  /// @}
+
+ private:
+  static constexpr unsigned   WAITER_RANK_SHIFT = 48;
+  static constexpr uint64_t   WAITER_INDEX_MASK = (UINT64_C(1) << 42) - 1;
+
+  libhpx_gas_t type_ = HPX_GAS_DEFAULT;         //!< cached type()
 };
 
 static const char* const GAS_ATTR_TO_STRING[] = {
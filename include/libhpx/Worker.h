@@ -49,6 +49,17 @@ class Worker : public libhpx::util::Aligned<HPX_CACHELINE_SIZE>
     RUN,
     STOP
   };
+
+  /// Where the scheduler found the thread that it switched to, this is the
+  /// source reported with EVENT_SCHED_END.
+  enum Source {
+    SOURCE_NONE,
+    SOURCE_MAIL,
+    SOURCE_LIFO,
+    SOURCE_NETWORK,
+    SOURCE_STEAL,
+    SOURCE_SPAWN                                //!< work-first spawn
+  };
   using Thread = libhpx::scheduler::Thread;
 
  public:
@@ -142,6 +153,18 @@ class Worker : public libhpx::util::Aligned<HPX_CACHELINE_SIZE>
   /// @returns            LIBHPX_OK or an error
   hpx_status_t wait(scheduler::LCO& lco, scheduler::Condition& cond);
 
+  /// Wait for a condition that is used without a lock.
+  ///
+  /// This suspends the current user level thread and pushes it onto @p cond
+  /// after it has been switched out, using the condition's lock-free
+  /// interface. If the condition was closed in the meantime the thread is
+  /// relaunched immediately.
+  ///
+  /// @param         cond The condition to wait for.
+  ///
+  /// @returns            The condition's status once it has been closed.
+  hpx_status_t wait(scheduler::Condition& cond);
+
   /// Create a random integer bounded by @p mod.
   ///
   /// @todo: now that we are using C++11 we should switch to standard random
@@ -158,6 +181,10 @@ class Worker : public libhpx::util::Aligned<HPX_CACHELINE_SIZE>
     return id_;
   }
 
+  int getNumaNode() const {
+    return numaNode_;
+  }
+
   hpx_parcel_t* getCurrentParcel() const {
     return current_;
   }
@@ -278,6 +305,15 @@ class Worker : public libhpx::util::Aligned<HPX_CACHELINE_SIZE>
   /// The main entry point for the worker thread.
   void enter();
 
+  /// Record where the next thread came from, for EVENT_SCHED_END.
+  void found(Source source) {
+    source_ = source;
+  }
+
+  /// Emit EVENT_SCHED_END with the source of the thread that we're running
+  /// and the number of scheduling passes that found no work before it.
+  void schedEnd();
+
   /// The primary schedule loop.
   ///
   /// This will continue to try and schedule lightweight threads while the
@@ -411,6 +447,8 @@ class Worker : public libhpx::util::Aligned<HPX_CACHELINE_SIZE>
   unsigned                   seed_;             //!< my random seed
   int                   workFirst_;             //!< this worker's mode
   Worker*              lastVictim_;             //!< last successful victim
+  Source                   source_;             //!< for EVENT_SCHED_END
+  uint64_t                  spins_;             //!< for EVENT_SCHED_END
   void                  *profiler_;             //!< reference to the profiler
  public:
   void                        *bst;            //!< the block statistics table
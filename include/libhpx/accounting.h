@@ -0,0 +1,104 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifndef LIBHPX_ACCOUNTING_H
+#define LIBHPX_ACCOUNTING_H
+
+/// @file include/libhpx/accounting.h
+/// @brief Per-worker scheduler state accounting.
+///
+/// When instrumentation is enabled every worker charges its time, in trace
+/// clock ticks, to the scheduler state that it's in: running user code,
+/// scheduling (checking mail and the work queue and switching contexts),
+/// progressing the network, stealing, or sleeping between hpx_run() epochs.
+/// Scheduling passes that find no work are also charged to idle, so idle time
+/// is the part of the sched, network and steal time that was spent spinning.
+///
+/// Workers also count their steal attempts and successes by the distance to
+/// the victim: a worker on the same core, on the same NUMA node, or on another
+/// node. Distances come from the cpu that each worker is pinned to, and are
+/// only nominal when the workers aren't pinned.
+///
+/// The counters are written by their worker and can be read at any time, with
+/// hpx_sched_dump() or through the stats backend's metrics.
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  ACCOUNTING_USER = 0,                          //!< running lightweight threads
+  ACCOUNTING_SCHED,                             //!< selecting and switching
+  ACCOUNTING_NETWORK,                           //!< network progress and probe
+  ACCOUNTING_STEAL,                             //!< stealing
+  ACCOUNTING_SLEEP,                             //!< stopped between epochs
+  ACCOUNTING_STATES
+} accounting_state_t;
+
+typedef enum {
+  ACCOUNTING_CORE = 0,                          //!< the same core
+  ACCOUNTING_NUMA,                              //!< the same numa node
+  ACCOUNTING_REMOTE,                            //!< another numa node
+  ACCOUNTING_DISTANCES
+} accounting_distance_t;
+
+/// The number of workers being accounted, 0 if accounting is off.
+unsigned accounting_workers(void);
+
+const char *accounting_state_name(int state);
+const char *accounting_distance_name(int distance);
+
+/// Read worker @p w's counters, these can be read at any time.
+/// @{
+uint64_t accounting_ticks(int w, int state);
+uint64_t accounting_idle_ticks(int w);
+uint64_t accounting_steal_attempts(int w, int distance);
+uint64_t accounting_steal_hits(int w, int distance);
+/// @}
+
+/// Write the accounting for this locality as CSV.
+///
+/// This only writes the header when instrumentation is disabled.
+void accounting_dump(FILE *file);
+
+#ifdef ENABLE_INSTRUMENTATION
+/// Allocate the per-worker counters, before the workers start.
+void accounting_init(unsigned workers);
+
+/// Free the per-worker counters.
+void accounting_fini(void);
+
+/// Charge worker @p w's time since its last transition to its current state,
+/// and switch to @p state.
+///
+/// @returns            The time of the transition.
+uint64_t accounting_enter(int w, accounting_state_t state);
+
+/// Charge worker @p w's time since @p start to idle.
+void accounting_idle(int w, uint64_t start);
+
+/// Count a steal attempt by worker @p w from worker @p victim.
+void accounting_steal(int w, int victim, int hit);
+#else
+static inline void accounting_init(unsigned workers) {}
+static inline void accounting_fini(void) {}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBHPX_ACCOUNTING_H
@@ -240,6 +240,40 @@ static const char * const HPX_GAS_AFFINITY_TO_STRING[] = {
   "INVALID_ID"
 };
 
+//! Configuration options for huge page backing of the heaps.
+typedef enum {
+  HPX_HEAP_HUGEPAGES_DEFAULT = 0, //!< Use hugetlbfs if it was configured.
+  HPX_HEAP_HUGEPAGES_NONE,        //!< Use normal pages.
+  HPX_HEAP_HUGEPAGES_THP,         //!< Use transparent huge pages.
+  HPX_HEAP_HUGEPAGES_2M,          //!< Use 2MB hugetlb pages.
+  HPX_HEAP_HUGEPAGES_1G,          //!< Use 1GB hugetlb pages.
+  HPX_HEAP_HUGEPAGES_MAX
+} libhpx_heap_hugepages_t;
+
+static const char * const HPX_HEAP_HUGEPAGES_TO_STRING[] = {
+  "DEFAULT",
+  "NONE",
+  "THP",
+  "2M",
+  "1G",
+  "INVALID_ID"
+};
+
+//! Configuration options for NUMA placement of the global heap.
+typedef enum {
+  HPX_GAS_NUMA_NONE = 0,      //!< Leave placement to the OS (first touch).
+  HPX_GAS_NUMA_LOCAL,         //!< Prefer the allocating worker's node.
+  HPX_GAS_NUMA_INTERLEAVE,    //!< Interleave chunks across all nodes.
+  HPX_GAS_NUMA_MAX
+} libhpx_gas_numa_t;
+
+static const char * const HPX_GAS_NUMA_TO_STRING[] = {
+  "NONE",
+  "LOCAL",
+  "INTERLEAVE",
+  "INVALID_ID"
+};
+
 /// The HPX configuration type.
 ///
 /// This configuration is used to control some of the runtime
@@ -71,19 +71,26 @@ static const int TRACE_EVENT_NUM_FIELDS[] = {
 /// Total number of trace events.
 #define TRACE_NUM_EVENTS _HPX_NELEM(TRACE_EVENT_TO_STRING)
 
-/// Trace event macros.
+/// Trace event emitters.
 ///
-/// The trace event macros are generated automatically from their
-/// definitions in the events.def file. When instrumentation is
-/// disabled, we use empty stubs declared in event_stubs.h that is
-/// generated at configure-time (since the C preprocessor disallows
-/// generating macros from other macros). Otherwise, we generate the
-/// event macros from the event definitions using the helper macros
-/// _DECL and _ARGS. These macros take the variadic type arguments to
-/// an event, and uses identifiers to instantiate the types.
+/// Each event in events.def has an EVENT_<class>_<event>(...) macro, generated
+/// at configure time in event_macros.h (since the C preprocessor disallows
+/// generating macros from other macros), that expands to LIBHPX_EMIT(). When
+/// instrumentation is disabled LIBHPX_EMIT() is empty. Otherwise it checks the
+/// event's class against the compile-time and runtime class masks before its
+/// arguments are evaluated, and then calls a typed inline emitter, generated
+/// here using the helper macros _DECL and _ARRAY, that writes a fixed-size
+/// record.
 #ifndef ENABLE_INSTRUMENTATION
-# include <libhpx/event_stubs.h>
+# define LIBHPX_EMIT(class, event, ...) ((void)0)
 #else
+# define LIBHPX_EMIT(class, event, ...) do {                          \
+    if (unlikely(LIBHPX_TRACE_CLASSES & HPX_TRACE_##class &           \
+                 trace_mask())) {                                     \
+      _EVENT_##class##_##event(__VA_ARGS__);                          \
+    }                                                                 \
+  } while (0)
+
 # define _DECL0() void
 # define _DECL2(t0,n0) t0 u0
 # define _DECL4(t0,n0,t1,n1) t0 u0, t1 u1
@@ -91,28 +98,32 @@ static const int TRACE_EVENT_NUM_FIELDS[] = {
 # define _DECL8(t0,n0,t1,n1,t2,n2,t3,n3) t0 u0, t1 u1, t2 u2, t3 u3
 # define _DECL10(t0,n0,t1,n1,t2,n2,t3,n3,t4,n4) t0 u0, t1 u1, t2 u2, t3 u3, t4 u4
 # define _DECLN(...) _HPX_CAT2(_DECL, __HPX_NARGS(__VA_ARGS__))(__VA_ARGS__)
-# define _ARGS0()
-# define _ARGS2(t0,n0) , u0
-# define _ARGS4(t0,n0,t1,n1) , u0, u1
-# define _ARGS6(t0,n0,t1,n1,t2,n2) , u0, u1, u2
-# define _ARGS8(t0,n0,t1,n1,t2,n2,t3,n3) , u0, u1, u2, u3
-# define _ARGS10(t0,n0,t1,n1,t2,n2,t3,n3,t4,n4) , u0, u1, u2, u3, u4
-# define _ARGSN(...) _HPX_CAT2(_ARGS, __HPX_NARGS(__VA_ARGS__))(__VA_ARGS__)
+# define _U(u) (uint64_t)(u)
+# define _ARRAY0() { 0 }
+# define _ARRAY2(t0,n0) { _U(u0) }
+# define _ARRAY4(t0,n0,t1,n1) { _U(u0), _U(u1) }
+# define _ARRAY6(t0,n0,t1,n1,t2,n2) { _U(u0), _U(u1), _U(u2) }
+# define _ARRAY8(t0,n0,t1,n1,t2,n2,t3,n3) { _U(u0), _U(u1), _U(u2), _U(u3) }
+# define _ARRAY10(t0,n0,t1,n1,t2,n2,t3,n3,t4,n4)                        \
+  { _U(u0), _U(u1), _U(u2), _U(u3), _U(u4) }
+# define _ARRAYN(...) _HPX_CAT2(_ARRAY, __HPX_NARGS(__VA_ARGS__))(__VA_ARGS__)
 # define LIBHPX_EVENT(class, event, ...)                                \
   static inline void                                                    \
-  EVENT_##class##_##event(_DECLN(__VA_ARGS__)) {                        \
-    trace_append(HPX_TRACE_##class, TRACE_EVENT_##class##_##event       \
-                 _ARGSN(__VA_ARGS__));                                  \
+  _EVENT_##class##_##event(_DECLN(__VA_ARGS__)) {                       \
+    const uint64_t args[] = _ARRAYN(__VA_ARGS__);                       \
+    trace_record(TRACE_EVENT_##class##_##event,                         \
+                 __HPX_NARGS(__VA_ARGS__)/2, args);                     \
   }
 # include "events.def"
 # undef LIBHPX_EVENT
-# undef _ARGS0
-# undef _ARGS2
-# undef _ARGS4
-# undef _ARGS6
-# undef _ARGS8
-# undef _ARGS10
-# undef _ARGSN
+# undef _ARRAY0
+# undef _ARRAY2
+# undef _ARRAY4
+# undef _ARRAY6
+# undef _ARRAY8
+# undef _ARRAY10
+# undef _ARRAYN
+# undef _U
 # undef _DECL0
 # undef _DECL2
 # undef _DECL4
@@ -122,6 +133,8 @@ static const int TRACE_EVENT_NUM_FIELDS[] = {
 # undef _DECLN
 #endif
 
+#include <libhpx/event_macros.h>
+
 #ifdef __cplusplus
 }
 #endif
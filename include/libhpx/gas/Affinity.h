@@ -17,6 +17,10 @@
 #include "hpx/hpx.h"
 #include <cuckoohash_map.hh>
 #include <city_hasher.hh>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 extern "C" struct cds_lfht;
 
@@ -27,12 +31,75 @@ class Affinity {
   virtual void setAffinity(hpx_addr_t gva, int worker) = 0;
   virtual void clearAffinity(hpx_addr_t gva) = 0;
   virtual int getAffinity(hpx_addr_t gva) const = 0;
+  virtual void setAffinityRange(hpx_addr_t base, size_t n, size_t bsize,
+                                hpx_affinity_policy_t policy) = 0;
+  virtual void clearAffinityRange(hpx_addr_t base) = 0;
+
+  /// Check to see if any address currently has an affinity binding.
+  ///
+  /// Most applications never set affinity, so the scheduler checks this before
+  /// paying for the virtual getAffinity() call and the hash lookup behind it.
+  static bool HasBindings() {
+    return (Bindings_.load(std::memory_order_relaxed) != 0);
+  }
 
  protected:
   virtual ~Affinity();
+
+  /// The number of active bindings (points and ranges), and the number of
+  /// active per-address bindings, maintained by the concrete policies.
+  static std::atomic<unsigned long> Bindings_;
+  static std::atomic<unsigned long> Points_;
 };
 
 namespace affinity {
+/// A set of bound address ranges.
+///
+/// Ranges are kept in an immutable array sorted by base address, so lookups
+/// are a lock-free binary search followed by O(1) arithmetic for the policy.
+/// Updates are rare and serialized: they copy the array and publish the new
+/// version, and retire the old version until the map is destroyed because
+/// concurrent lookups may still be reading it.
+class RangeMap {
+ public:
+  RangeMap();
+  ~RangeMap();
+
+  /// Bind a range, replacing any ranges that it overlaps.
+  ///
+  /// @returns          The change in the number of bound ranges.
+  int insert(hpx_addr_t base, size_t n, size_t bsize,
+              hpx_affinity_policy_t policy);
+
+  /// Remove the range starting at @p base, returning true if it was bound.
+  bool remove(hpx_addr_t base);
+
+  /// Find the worker bound to @p gva, or -1 if it is not in a range.
+  int lookup(hpx_addr_t gva) const;
+
+ private:
+  struct Range {
+    hpx_addr_t lo;                              //!< the first byte
+    hpx_addr_t hi;                              //!< one past the last byte
+    size_t bsize;                               //!< the block size
+    size_t n;                                   //!< the number of blocks
+    hpx_affinity_policy_t policy;
+  };
+
+  using Ranges = std::vector<Range>;
+
+  void publish(std::unique_ptr<Ranges> next);
+  void initNUMA();
+  int map(const Range& r, size_t i) const;
+
+  std::atomic<const Ranges*> ranges_;           //!< the current version
+  std::mutex lock_;                             //!< serializes updates
+  std::vector<std::unique_ptr<const Ranges>> retired_;
+  int workers_;                                 //!< the number of workers
+  std::vector<int> numaWorkers_;                //!< workers sorted by node
+  std::vector<int> numaOffsets_;                //!< node offsets in the above
+};
+
 class None : public virtual libhpx::gas::Affinity {
  public:
   None();
@@ -41,6 +108,9 @@ class None : public virtual libhpx::gas::Affinity {
   void setAffinity(hpx_addr_t gva, int worker) { }
   void clearAffinity(hpx_addr_t gva) { }
   int getAffinity(hpx_addr_t gva) const { return -1; }
+  void setAffinityRange(hpx_addr_t base, size_t n, size_t bsize,
+                        hpx_affinity_policy_t policy) { }
+  void clearAffinityRange(hpx_addr_t base) { }
 };
 
 class URCU : public virtual libhpx::gas::Affinity {
@@ -51,6 +121,9 @@ class URCU : public virtual libhpx::gas::Affinity {
   void setAffinity(hpx_addr_t gva, int worker);
   void clearAffinity(hpx_addr_t gva);
   int getAffinity(hpx_addr_t gva) const;
+  void setAffinityRange(hpx_addr_t base, size_t n, size_t bsize,
+                        hpx_affinity_policy_t policy);
+  void clearAffinityRange(hpx_addr_t base);
 
  private:
   typedef unsigned long hash_t;
@@ -62,6 +135,7 @@ class URCU : public virtual libhpx::gas::Affinity {
   int lookup(hash_t hash, hpx_addr_t key) const;
 
   struct cds_lfht * const ht;
+  RangeMap ranges_;
 };
 
 class CuckooHash : public virtual libhpx::gas::Affinity {
@@ -72,9 +146,13 @@ class CuckooHash : public virtual libhpx::gas::Affinity {
   void setAffinity(hpx_addr_t gva, int worker);
   void clearAffinity(hpx_addr_t gva);
   int getAffinity(hpx_addr_t gva) const;
+  void setAffinityRange(hpx_addr_t base, size_t n, size_t bsize,
+                        hpx_affinity_policy_t policy);
+  void clearAffinityRange(hpx_addr_t base);
 
  private:
   cuckoohash_map<hpx_addr_t, int, CityHasher<hpx_addr_t> > map_;
+  RangeMap ranges_;
 };
 }
 }
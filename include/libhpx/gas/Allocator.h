@@ -47,6 +47,17 @@ class Allocator {
 
   virtual hpx_addr_t calloc_user(size_t n, size_t bsize, uint32_t boundary,
                                  hpx_gas_dist_t dist, uint32_t attr) = 0;
+
+  /// Apply the --hpx-gas-numa policy to a newly allocated heap chunk.
+  ///
+  /// Chunks are allocated by the worker whose jemalloc arena needs them, so
+  /// the "local" policy places non-cyclic chunks on the calling worker's NUMA
+  /// node. Cyclic chunks are only interleaved.
+  ///
+  /// @param      chunk The base of the chunk.
+  /// @param          n The number of bytes in the chunk.
+  /// @param     cyclic True if the chunk backs cyclic allocations.
+  static void PlaceChunk(void* chunk, size_t n, bool cyclic);
 };
 }
 }
@@ -14,6 +14,8 @@
 #ifndef INSTRUMENTATION_H
 #define INSTRUMENTATION_H
 
+#include <libhpx/time.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -26,12 +28,21 @@ extern "C" {
 #include <libhpx/locality.h>
 
 /// INST will do @p stmt only if instrumentation is enabled
+///
+/// INST_FOR does @p stmt, which raises events about parcel @p p, as if the
+/// thread were running @p p (see trace_sample_bind()).
 #ifdef ENABLE_INSTRUMENTATION
 # define INST(stmt) stmt;
 # define INST_IF(S) if (S)
+# define INST_FOR(p, stmt) do {                                 \
+    uint64_t _filter = trace_sample_bind((p)->sampled);         \
+    stmt;                                                       \
+    trace_sample_restore(_filter);                              \
+  } while (0)
 #else
 # define INST(stmt)
 # define INST_IF(S) if (false)
+# define INST_FOR(p, stmt) stmt
 #endif
 
 /// Initialize tracing. This is usually called in hpx_init().
@@ -50,36 +61,99 @@ void trace_start(void *obj);
 /// @param      obj The trace object to delete.
 void trace_destroy(void *obj);
 
-/// vappend
-void trace_vappend(void* obj, int UNUSED, int n, int id, ...);
+/// The classes that are compiled into the event emitters.
+///
+/// Events in classes that aren't in this mask compile to nothing, even when
+/// instrumentation is enabled. Override it with -DLIBHPX_TRACE_CLASSES=<mask>.
+#ifndef LIBHPX_TRACE_CLASSES
+# define LIBHPX_TRACE_CLASSES LIBHPX_OPT_BITSET_ALL
+#endif
 
-static inline bool inst_trace_class(int type) {
-  return config_trace_classes_isset(here->config, type);
+/// The classes that are currently being traced at this locality.
+///
+/// This is 0 unless there is a tracer and it is in an active phase, so it's
+/// the only thing that the event emitters check before evaluating their
+/// arguments.
+extern uint64_t libhpx_trace_mask;
+
+/// The sampling period from --hpx-trace-sample=1/N, or 0 to trace everything.
+extern uint32_t libhpx_trace_sample;
+
+/// The classes that this thread traces.
+///
+/// This is all of them unless tracing is sampled. Then a worker traces the
+/// events raised while it's running a sampled parcel, and none otherwise.
+extern __thread uint64_t libhpx_trace_filter;
+
+static inline uint64_t trace_mask(void) {
+  return __atomic_load_n(&libhpx_trace_mask, __ATOMIC_RELAXED) &
+         libhpx_trace_filter;
 }
 
-/// Utility to consolidate a check to see if a trace event is currently being
-/// traced.
+/// Decide if a new root parcel, one that isn't spawned by a parcel, is traced.
 ///
-/// @param           id The trace event ID.
+/// When tracing is sampled this picks 1/N of them at random, the rest of the
+/// parcels inherit the decision from the parcel that spawns them.
+uint16_t trace_sample_root(void);
+
+/// Trace this thread's events if @p sampled, when tracing is sampled.
 ///
-/// @returns            true if the event should be appended, false otherwise
-int inst_check_vappend(int id, ...);
+/// @returns            The previous filter, for trace_sample_restore().
+static inline uint64_t trace_sample_bind(uint16_t sampled) {
+  uint64_t filter = libhpx_trace_filter;
+  if (libhpx_trace_sample) {
+    libhpx_trace_filter = (sampled) ? UINT64_MAX : 0;
+  }
+  return filter;
+}
 
-/// Record an event to the log
+static inline void trace_sample_restore(uint64_t filter) {
+  libhpx_trace_filter = filter;
+}
+
+/// A worker's direct trace buffer.
 ///
-/// @param        type Type this event is part of (see hpx_inst_class_type_t)
-/// @param            n The number of user arguments to log, < 5.
-/// @param           id The event id (see hpx_inst_event_type_t)
-#ifdef ENABLE_INSTRUMENTATION
-# define trace_append(type, ...) do {                           \
-    if (inst_check_vappend(__VA_ARGS__)) {                      \
-      trace_vappend(here->tracer, type, __HPX_NARGS(__VA_ARGS__) - 1,   \
-          __VA_ARGS__);                                         \
-    }                                                           \
-  } while (0)
-#else
-# define trace_append(type, id, ...)
-#endif
+/// Backends that write records into memory bind one of these to each worker
+/// thread, and the event emitters write records into it directly, without
+/// calling into the backend. A record is a uint32_t event id, a uint32_t size
+/// of the rest of the record, a uint64_t timestamp and the uint64_t arguments.
+typedef struct {
+  char *next;                                   //!< the next record
+  char  *end;                                   //!< the end of the buffer
+} trace_buffer_t;
+
+extern __thread trace_buffer_t *libhpx_trace_buffer;
+
+static inline bool inst_trace_class(int type) {
+  return config_trace_classes_isset(here->config, type);
+}
+
+/// Hand a record to the tracer when it can't be written directly.
+void trace_record_slow(int id, int n, const uint64_t args[]);
+
+/// Record an event to the log.
+///
+/// @param           id The event id (see libhpx_trace_events_t)
+/// @param            n The number of arguments to log.
+/// @param         args The arguments.
+static inline void trace_record(int id, int n, const uint64_t args[]) {
+  trace_buffer_t *buffer = libhpx_trace_buffer;
+  const size_t bytes = 2 * sizeof(uint32_t) + (n + 1) * sizeof(uint64_t);
+  if (!buffer || buffer->next + bytes > buffer->end) {
+    trace_record_slow(id, n, args);
+    return;
+  }
+
+  uint32_t *header = (uint32_t*)buffer->next;
+  header[0] = id;
+  header[1] = bytes - 2 * sizeof(uint32_t);
+  uint64_t *record = (uint64_t*)(header + 2);
+  record[0] = libhpx_trace_time();
+  for (int i = 0; i < n; ++i) {
+    record[i + 1] = args[i];
+  }
+  buffer->next += bytes;
+}
 
 // Constructor for a "file" tracer object.
 void *trace_file_new(const config_t *cfg);
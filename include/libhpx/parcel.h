@@ -73,17 +73,16 @@ struct hpx_parcel {
   uint32_t            src;         //!< The src rank for the parcel.
   uint32_t           size;         //!< The data size in bytes.
   parcel_state_t    state;         //!< The parcel's state bits.
-  uint16_t         offset;         //!< Reserved for future use.
   hpx_action_t     action;         //!< The target action identifier.
   hpx_action_t   c_action;         //!< The continuation action identifier.
+  uint16_t        sampled;         //!< Traced when tracing is sampled.
   hpx_addr_t       target;         //!< The target address for parcel_send().
   hpx_addr_t     c_target;         //!< The target address for the continuation.
   hpx_pid_t           pid;         //!< The process ID.
   uint64_t         credit;         //!< Credit held by the parcel.
 #ifdef ENABLE_INSTRUMENTATION
   uint64_t             id;         //!< A unique identifier for parcel tracing.
-  uint64_t        padding;         //!< Ensure consistent buffer alignment with
-                                                //!< instrumentation.
+  uint64_t          stamp;         //!< When it became runnable (see profile.h).
 #endif
   char           buffer[];        //!< Either an in-place payload, or a pointer.
 };
@@ -140,6 +139,14 @@ void parcel_launch_error(hpx_parcel_t *p, int error);
 
 void parcel_launch_through(hpx_parcel_t *p, hpx_addr_t gate);
 
+/// Find the local node of a combining-tree LCO.
+///
+/// @param        root The address of the tree's root.
+///
+/// @returns The address of this locality's node in the tree, or HPX_NULL if
+///          @p root is not a tree with a node here.
+hpx_addr_t lco_tree_local(hpx_addr_t root);
+
 void parcel_set_state(hpx_parcel_t *p, parcel_state_t state);
 
 parcel_state_t parcel_get_state(const hpx_parcel_t *p);
@@ -0,0 +1,81 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifndef LIBHPX_PERF_H
+#define LIBHPX_PERF_H
+
+/// @file include/libhpx/perf.h
+/// @brief Hardware performance counters.
+///
+/// When instrumentation is enabled, --hpx-trace-counters opens a group of Linux
+/// perf counters for each worker thread. The worker reads the group at every
+/// context switch and charges the change to the parcel that it switched away
+/// from (see profile_counters()). The per-action sums are reported with the
+/// profiles, and the per-worker totals by the stats backend.
+///
+/// Counters only count user-level events, so they work with the default
+/// perf_event_paranoid setting. Counters that the machine doesn't support are
+/// dropped with a warning when the runtime starts.
+
+#include <stdint.h>
+#include <libhpx/config.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The most counters that can be opened at once.
+#define PERF_MAX_COUNTERS 4
+
+/// The number of counters that each worker reads, 0 if counting is off.
+extern unsigned libhpx_perf_counters;
+
+/// The name of counter @p i.
+const char *perf_counter_name(unsigned i);
+
+/// The total of counter @p i at worker @p w, this can be read at any time.
+uint64_t perf_total(int w, unsigned i);
+
+#ifdef ENABLE_INSTRUMENTATION
+/// Parse --hpx-trace-counters and allocate the per-worker state.
+void perf_init(const config_t *cfg, unsigned workers);
+
+/// Free the per-worker state.
+void perf_fini(void);
+
+/// Open the calling worker thread's counters.
+void perf_thread_init(int w);
+
+/// Close the calling worker thread's counters.
+void perf_thread_fini(int w);
+
+/// Read worker @p w's counters.
+///
+/// This must be called by the worker itself. It stores the change in each
+/// counter since the last call in @p delta, and adds it to the worker's
+/// totals.
+///
+/// @returns            false if the worker's counters aren't open.
+bool perf_sample(int w, uint64_t delta[PERF_MAX_COUNTERS]);
+#else
+static inline void perf_init(const config_t *cfg, unsigned workers) {}
+static inline void perf_fini(void) {}
+static inline void perf_thread_init(int w) {}
+static inline void perf_thread_fini(int w) {}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBHPX_PERF_H
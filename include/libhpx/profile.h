@@ -0,0 +1,90 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifndef LIBHPX_PROFILE_H
+#define LIBHPX_PROFILE_H
+
+/// @file include/libhpx/profile.h
+/// @brief Per-action execution profiles.
+///
+/// When instrumentation is enabled every worker keeps log-bucketed histograms
+/// of handler execution time, queueing delay, and payload size for each action
+/// that it runs. These are independent of the trace backend and are always
+/// collected. They are merged on demand by hpx_profile_dump().
+///
+/// A parcel's queueing delay is measured from when it was created, or from when
+/// it arrived if it was sent from another locality. Its execution time excludes
+/// the time that it spends suspended.
+///
+/// With --hpx-trace-counters the profiles also sum the hardware counters (see
+/// perf.h) that each action's parcels accumulate while they run.
+
+#include <stdio.h>
+#include <libhpx/parcel.h>
+#include <libhpx/time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Write the profiles for this locality as CSV.
+///
+/// This only writes the header when instrumentation is disabled.
+void profile_dump(FILE *file);
+
+#ifdef ENABLE_INSTRUMENTATION
+/// Allocate the profile tables, once the actions are finalized.
+void profile_init(unsigned workers);
+
+/// Free the profile tables.
+void profile_fini(void);
+
+/// Record that worker @p w is starting to run @p p.
+void profile_run(int w, hpx_parcel_t *p);
+
+/// Record that worker @p w has finished running @p p.
+void profile_end(int w, hpx_parcel_t *p);
+
+/// Charge worker @p w's hardware counters since its last context switch to
+/// @p p, or to nothing if @p p is NULL.
+void profile_counters(int w, hpx_parcel_t *p);
+
+/// Mark the time that @p p became runnable at this locality.
+static inline void profile_stamp(hpx_parcel_t *p) {
+  p->stamp = libhpx_trace_time();
+}
+
+/// Account for a suspension of @p p.
+///
+/// While a parcel runs its stamp holds the time it would have started running
+/// if it had never been suspended. While it's suspended the stamp holds the
+/// time it has run so far. Suspend and resume just switch between the two.
+static inline void profile_suspend(hpx_parcel_t *p) {
+  p->stamp = libhpx_trace_time() - p->stamp;
+}
+
+static inline void profile_resume(hpx_parcel_t *p) {
+  p->stamp = libhpx_trace_time() - p->stamp;
+}
+#else
+static inline void profile_init(unsigned workers) {}
+static inline void profile_fini(void) {}
+static inline void profile_stamp(hpx_parcel_t *p) {}
+static inline void profile_counters(int w, hpx_parcel_t *p) {}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBHPX_PROFILE_H
@@ -77,6 +77,17 @@ void system_munmap_huge_pages(void *obj, void *addr, size_t size);
 
 typedef void (*system_munmap_t)(void *, void *, size_t);
 
+/// Set the NUMA placement policy for a range of memory.
+///
+/// Pages that have already been touched are migrated if possible. Placement is
+/// only a hint, so failures are logged and otherwise ignored.
+///
+/// @param         addr The page-aligned base of the range.
+/// @param            n The number of bytes in the range.
+/// @param         node The (OS) node to prefer, or -1 to interleave.
+/// @param        nodes The number of NUMA nodes to interleave across.
+void system_numa_place(void *addr, size_t n, int node, int nodes);
+
 /// Sleep for microseconds.
 void system_usleep(size_t useconds);
 
@@ -14,6 +14,13 @@
 #ifndef LIBHPX_TIME_H
 #define LIBHPX_TIME_H
 
+#include <stdint.h>
+#include <hpx/hpx.h>
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+# define LIBHPX_HAVE_TSC 1
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -29,6 +36,43 @@ void libhpx_time_start(void);
 /// are counting time from the same start time.
 hpx_time_t libhpx_beginning_of_time(void);
 
+/// The clock used to timestamp trace records.
+///
+/// When the TSC is invariant, trace timestamps are raw ticks, offset so that
+/// zero is the beginning of time, and are converted to nanoseconds offline
+/// using @p ticks_per_ns. Otherwise they are nanoseconds and ticks_per_ns is 1.
+typedef struct {
+  int               tsc;                   //!< true if we're using the TSC
+  uint64_t         zero;                   //!< the TSC at the beginning of time
+  double   ticks_per_ns;
+} libhpx_trace_clock_t;
+
+extern libhpx_trace_clock_t libhpx_trace_clock;
+
+/// Calibrate the TSC against the system clock.
+///
+/// This is only done when instrumentation is enabled, because it takes a few
+/// milliseconds. If the TSC isn't invariant then the trace clock stays on
+/// clock_gettime(). Calibrating more than once has no effect.
+void libhpx_time_calibrate(void);
+
+/// Check that the calling worker's TSC agrees with the calibration.
+///
+/// This logs a warning if the worker's TSC is skewed relative to the one that
+/// was calibrated, which means that its timestamps can't be compared directly
+/// with those of other workers.
+void libhpx_time_check(int worker);
+
+/// Read the trace clock.
+static inline uint64_t libhpx_trace_time(void) {
+#ifdef LIBHPX_HAVE_TSC
+  if (libhpx_trace_clock.tsc) {
+    return __rdtsc() - libhpx_trace_clock.zero;
+  }
+#endif
+  return hpx_time_from_start_ns(hpx_time_now());
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -43,12 +43,13 @@ static int _call_by_parcel_lsync(const void *o, hpx_addr_t addr,
 static int _call_by_parcel_rsync(const void *o, hpx_addr_t addr, void *rout,
                                  size_t rbytes, int n, va_list *args) {
   const action_t *a = static_cast<const action_t *>(o);
-  hpx_addr_t rsync = hpx_lco_future_new(rbytes);
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t rsync = hpx_lco_waiter_init(&waiter, rbytes, rout);
   hpx_action_t rop = hpx_lco_set_action;
   hpx_parcel_t *p = a->parcel_class->new_parcel(a, addr, rsync, rop, n, args);
   parcel_launch(p);
-  int e = hpx_lco_get(rsync, rbytes, rout);
-  hpx_lco_delete_sync(rsync);
+  int e = hpx_lco_waiter_wait(&waiter);
+  hpx_lco_waiter_fini(&waiter);
   return e;
 }
 
@@ -79,14 +80,15 @@ static int _call_by_parcel_when_rsync(const void *o, hpx_addr_t addr,
   dbg_assert(gate);
 
   const action_t *a = static_cast<const action_t *>(o);
-  hpx_addr_t rsync = hpx_lco_future_new(rbytes);
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t rsync = hpx_lco_waiter_init(&waiter, rbytes, rout);
   hpx_action_t rop = hpx_lco_set_action;
   hpx_parcel_t *p = a->parcel_class->new_parcel(a, addr, rsync, rop, n, args);
   int e = hpx_parcel_send_through(p, gate, HPX_NULL);
   if (e == HPX_SUCCESS) {
-    e = hpx_lco_get(rsync, rbytes, rout);
+    e = hpx_lco_waiter_wait(&waiter);
   }
-  hpx_lco_delete_sync(rsync);
+  hpx_lco_waiter_fini(&waiter);
   return e;
 }
 
@@ -16,8 +16,39 @@
 #endif
 
 #include "libhpx/gas/Allocator.h"
+#include "libhpx/config.h"
+#include "libhpx/locality.h"
+#include "libhpx/system.h"
+#include "libhpx/Topology.h"
+#include "libhpx/Worker.h"
 
 /// Provide a place for the compiler to put the affinity vtable.
 libhpx::gas::Allocator::~Allocator()
 {
 }
+
+void
+libhpx::gas::Allocator::PlaceChunk(void* chunk, size_t n, bool cyclic)
+{
+  const Topology* topo = here->topology;
+  if (!topo || topo->nnodes < 2) {
+    return;
+  }
+
+  switch (here->config->gas_numa) {
+   case HPX_GAS_NUMA_LOCAL:
+    // Chunks allocated outside of a worker (e.g., during startup) don't have a
+    // meaningful home, so we leave them to first touch.
+    if (!cyclic && self) {
+      int node = self->getNumaNode();
+      int os = (topo->numa_nodes) ? topo->numa_nodes[node]->os_index : node;
+      system_numa_place(chunk, n, os, topo->nnodes);
+    }
+    return;
+   case HPX_GAS_NUMA_INTERLEAVE:
+    system_numa_place(chunk, n, -1, topo->nnodes);
+    return;
+   default:
+    return;
+  }
+}
@@ -132,5 +132,6 @@ GAS::Create(config_t *cfg, const boot::Network* const boot) {
   //     a C-style const cast during initialization to set it up.
   dbg_assert(gas);
   HPX_GAS_BLOCK_BYTES_MAX = gas->maxBlockSize();
+  gas->type_ = gas->type();
   return gas;
 }
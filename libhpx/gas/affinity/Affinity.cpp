@@ -17,6 +17,9 @@
 
 #include "libhpx/gas/Affinity.h"
 
+std::atomic<unsigned long> libhpx::gas::Affinity::Bindings_(0);
+std::atomic<unsigned long> libhpx::gas::Affinity::Points_(0);
+
 /// Provide a place for the compiler to put the affinity vtable.
 libhpx::gas::Affinity::~Affinity()
 {
@@ -26,7 +26,7 @@ using libhpx::gas::Affinity;
 using libhpx::gas::affinity::CuckooHash;
 }
 
-CuckooHash::CuckooHash() : Affinity(), map_()
+CuckooHash::CuckooHash() : Affinity(), map_(), ranges_()
 {
 }
 
@@ -49,7 +49,10 @@ CuckooHash::setAffinity(hpx_addr_t gva, int worker)
   // @todo: Should we be pinning gva? The interface doesn't require it, but it
   //        could prevent usage errors in AGAS? On the other hand, it could
   //        result in debugging issues with pin reference counting.
-  map_.insert(gva, worker);
+  if (map_.insert(gva, worker)) {
+    Points_.fetch_add(1, std::memory_order_relaxed);
+    Bindings_.fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
 void
@@ -59,13 +62,38 @@ CuckooHash::clearAffinity(hpx_addr_t gva)
     dbg_error("Attempt to clear affinity of %" PRIu64 " at %d (owned by %d)\n",
               gva, here->rank, here->gas->ownerOf(gva));
   }
-  map_.erase(gva);
+  if (map_.erase(gva)) {
+    Points_.fetch_sub(1, std::memory_order_relaxed);
+    Bindings_.fetch_sub(1, std::memory_order_relaxed);
+  }
 }
 
 int
 CuckooHash::getAffinity(hpx_addr_t gva) const
 {
   int worker = -1;
-  map_.find(gva, worker);
-  return worker;
+  if (Points_.load(std::memory_order_relaxed) && map_.find(gva, worker)) {
+    return worker;
+  }
+  return ranges_.lookup(gva);
+}
+
+void
+CuckooHash::setAffinityRange(hpx_addr_t base, size_t n, size_t bsize,
+                             hpx_affinity_policy_t policy)
+{
+  DEBUG_IF(here->gas->ownerOf(base) != here->rank) {
+    dbg_error("Attempt to set affinity of %" PRIu64 " at %d (owned by %d)\n",
+              base, here->rank, here->gas->ownerOf(base));
+  }
+  Bindings_.fetch_add(ranges_.insert(base, n, bsize, policy),
+                      std::memory_order_relaxed);
+}
+
+void
+CuckooHash::clearAffinityRange(hpx_addr_t base)
+{
+  if (ranges_.remove(base)) {
+    Bindings_.fetch_sub(1, std::memory_order_relaxed);
+  }
 }
@@ -0,0 +1,184 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "libhpx/gas/Affinity.h"
+#include "libhpx/debug.h"
+#include "libhpx/locality.h"
+#include "libhpx/Scheduler.h"
+#include "libhpx/Topology.h"
+#include <algorithm>
+#include <cinttypes>
+
+namespace {
+using libhpx::gas::affinity::RangeMap;
+}
+
+RangeMap::RangeMap()
+    : ranges_(nullptr),
+      lock_(),
+      retired_(),
+      workers_(0),
+      numaWorkers_(),
+      numaOffsets_()
+{
+}
+
+RangeMap::~RangeMap()
+{
+  delete ranges_.load(std::memory_order_relaxed);
+}
+
+int
+RangeMap::insert(hpx_addr_t base, size_t n, size_t bsize,
+                 hpx_affinity_policy_t policy)
+{
+  DEBUG_IF(n == 0 || bsize == 0) {
+    dbg_error("Attempt to set affinity of an empty range at %" PRIu64 "\n",
+              base);
+  }
+
+  std::lock_guard<std::mutex> _(lock_);
+  if (!workers_) {
+    workers_ = here->sched->getNWorkers();
+    initNUMA();
+  }
+
+  Range range = { base, base + n * bsize, bsize, n, policy };
+  std::unique_ptr<Ranges> next(new Ranges());
+  int delta = 1;
+  if (const Ranges* ranges = ranges_.load(std::memory_order_relaxed)) {
+    next->reserve(ranges->size() + 1);
+    for (const Range& r : *ranges) {
+      if (r.hi <= range.lo || range.hi <= r.lo) {
+        next->push_back(r);
+      }
+      else {
+        --delta;
+      }
+    }
+  }
+
+  auto it = std::upper_bound(next->begin(), next->end(), range,
+                             [](const Range& lhs, const Range& rhs) {
+                               return lhs.lo < rhs.lo;
+                             });
+  next->insert(it, range);
+  publish(std::move(next));
+  return delta;
+}
+
+bool
+RangeMap::remove(hpx_addr_t base)
+{
+  std::lock_guard<std::mutex> _(lock_);
+  const Ranges* ranges = ranges_.load(std::memory_order_relaxed);
+  if (!ranges) {
+    return false;
+  }
+
+  std::unique_ptr<Ranges> next(new Ranges(*ranges));
+  auto it = std::find_if(next->begin(), next->end(), [base](const Range& r) {
+      return r.lo == base;
+    });
+  if (it == next->end()) {
+    return false;
+  }
+  next->erase(it);
+  publish(std::move(next));
+  return true;
+}
+
+int
+RangeMap::lookup(hpx_addr_t gva) const
+{
+  const Ranges* ranges = ranges_.load(std::memory_order_acquire);
+  if (!ranges) {
+    return -1;
+  }
+
+  auto it = std::upper_bound(ranges->begin(), ranges->end(), gva,
+                             [](hpx_addr_t addr, const Range& r) {
+                               return addr < r.lo;
+                             });
+  if (it == ranges->begin()) {
+    return -1;
+  }
+
+  const Range& r = *--it;
+  if (r.hi <= gva) {
+    return -1;
+  }
+  return map(r, (gva - r.lo) / r.bsize);
+}
+
+void
+RangeMap::publish(std::unique_ptr<Ranges> next)
+{
+  // We can't free the previous version because lookups don't synchronize with
+  // updates. Range updates are expected to be rare (during setup), so we just
+  // keep them around until the map is destroyed.
+  const Ranges* prev = ranges_.exchange(next.release(),
+                                        std::memory_order_acq_rel);
+  if (prev) {
+    retired_.emplace_back(prev);
+  }
+}
+
+/// Group the workers by NUMA node so that the NUMA policy can pick a worker on
+/// a given node in constant time.
+void
+RangeMap::initNUMA()
+{
+  const libhpx::Topology* topo = here->topology;
+  int nodes = (topo && topo->cpu_to_numa) ? std::max(topo->nnodes, 1) : 1;
+
+  numaOffsets_.assign(nodes + 1, 0);
+  numaWorkers_.resize(workers_);
+
+  std::vector<int> node(workers_);
+  for (int i = 0; i < workers_; ++i) {
+    node[i] = (nodes > 1) ? topo->cpu_to_numa[i % topo->ncpus] : 0;
+    numaOffsets_[node[i] + 1]++;
+  }
+  for (int i = 0; i < nodes; ++i) {
+    numaOffsets_[i + 1] += numaOffsets_[i];
+  }
+
+  std::vector<int> next(numaOffsets_.begin(), numaOffsets_.end() - 1);
+  for (int i = 0; i < workers_; ++i) {
+    numaWorkers_[next[node[i]]++] = i;
+  }
+}
+
+int
+RangeMap::map(const Range& r, size_t i) const
+{
+  switch (r.policy) {
+   case HPX_AFFINITY_BLOCKED:
+    return (i * workers_) / r.n;
+   case HPX_AFFINITY_NUMA: {
+     size_t nodes = numaOffsets_.size() - 1;
+     size_t n = (i * nodes) / r.n;
+     int first = numaOffsets_[n];
+     int count = numaOffsets_[n + 1] - first;
+     return (count) ? numaWorkers_[first + i % count] : i % workers_;
+   }
+   case HPX_AFFINITY_CYCLIC:
+   default:
+    return i % workers_;
+  }
+}
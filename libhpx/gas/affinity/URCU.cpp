@@ -75,7 +75,8 @@ struct URCU::Node : public cds_lfht_node {
 
 URCU::URCU()
     : Affinity(),
-      ht(cds_lfht_new(1, 1, 0, CDS_LFHT_AUTO_RESIZE, NULL))
+      ht(cds_lfht_new(1, 1, 0, CDS_LFHT_AUTO_RESIZE, NULL)),
+      ranges_()
 {
 }
 
@@ -101,18 +102,46 @@ URCU::setAffinity(hpx_addr_t k, int v)
     synchronize_rcu();
     delete n;
   }
+  else {
+    Points_.fetch_add(1, std::memory_order_relaxed);
+    Bindings_.fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
 int
 URCU::getAffinity(hpx_addr_t k) const
 {
-  return lookup(Hash(k), k);
+  if (Points_.load(std::memory_order_relaxed)) {
+    int worker = lookup(Hash(k), k);
+    if (0 <= worker) {
+      return worker;
+    }
+  }
+  return ranges_.lookup(k);
+}
+
+void
+URCU::setAffinityRange(hpx_addr_t base, size_t n, size_t bsize,
+                       hpx_affinity_policy_t policy)
+{
+  Bindings_.fetch_add(ranges_.insert(base, n, bsize, policy),
+                      std::memory_order_relaxed);
+}
+
+void
+URCU::clearAffinityRange(hpx_addr_t base)
+{
+  if (ranges_.remove(base)) {
+    Bindings_.fetch_sub(1, std::memory_order_relaxed);
+  }
 }
 
 void
 URCU::clearAffinity(hpx_addr_t k)
 {
   if (Node *n = remove(Hash(k), k)) {
+    Points_.fetch_sub(1, std::memory_order_relaxed);
+    Bindings_.fetch_sub(1, std::memory_order_relaxed);
     synchronize_rcu();
     delete n;
   }
@@ -25,6 +25,7 @@
 #include "libhpx/rebalancer.h"
 #include "libhpx/Worker.h"                      // self->getCurrentParcel()
 #include "libhpx/util/math.h"
+#include <cinttypes>
 #include <cstdlib>
 #include <cstring>
 
@@ -34,6 +35,15 @@ using libhpx::util::ceil_log2;
 using libhpx::gas::agas::AGAS;
 using libhpx::gas::agas::ChunkAllocator;
 using libhpx::gas::agas::GlobalVirtualAddress;
+using libhpx::gas::agas::GVA_OFFSET_BITS;
+using libhpx::gas::agas::GVA_SIZE_BITS;
+
+/// The largest cyclic block. A cyclic address with an all-ones size field has
+/// all of the waiter tag's bits set (see GAS::waiterToGVA()).
+constexpr uint64_t MAX_CYCLIC_BSIZE = UINT64_C(1) << ((1 << GVA_SIZE_BITS) - 2);
+static_assert(libhpx::GAS::WAITER_TAG ==
+              (((UINT64_C(1) << (GVA_SIZE_BITS + 1)) - 1) << GVA_OFFSET_BITS),
+              "the waiter tag must be the size field and the cyclic bit");
 
 LIBHPX_ACTION(HPX_DEFAULT, 0, InsertTranslation, AGAS::InsertTranslationHandler,
               HPX_ADDR, HPX_UINT, HPX_SIZE_T, HPX_UINT32);
@@ -60,7 +70,7 @@ AGAS* AGAS::Instance_;
 AGAS::AGAS(const config_t* config, const boot::Network* const boot)
     : btt_(0),
       chunks_(0),
-      global_(chunks_, HEAP_SIZE),
+      global_(chunks_, HEAP_SIZE, false),
       cyclic_(nullptr),
       rank_(boot->getRank()),
       ranks_(boot->getNRanks())
@@ -69,7 +79,7 @@ AGAS::AGAS(const config_t* config, const boot::Network* const boot)
   Instance_ = this;
 
   if (rank_ == 0) {
-    cyclic_ = new ChunkAllocator(chunks_, HEAP_SIZE);
+    cyclic_ = new ChunkAllocator(chunks_, HEAP_SIZE, true);
   }
 
   initAllocators(rank_);
@@ -418,7 +428,7 @@ GlobalVirtualAddress
 AGAS::allocateCyclic(size_t n, size_t bsize, uint32_t, uint32_t attr, int zero)
 {
   dbg_assert(rank_ == 0);
-  dbg_assert(bsize <= maxBlockSize());
+  dbg_assert(bsize <= MAX_CYCLIC_BSIZE);
 
   // Figure out how many blocks per node we need, and what the size is.
   auto blocks = ceil_div(n, size_t(ranks_));
@@ -448,6 +458,11 @@ AGAS::allocateCyclic(size_t n, size_t bsize, uint32_t, uint32_t attr, int zero)
 
 hpx_addr_t
 AGAS::alloc_cyclic(size_t n, size_t bsize, uint32_t boundary, uint32_t attr) {
+  if (bsize > MAX_CYCLIC_BSIZE) {
+    log_error("cyclic blocks are limited to %" PRIu64 " bytes\n",
+              MAX_CYCLIC_BSIZE);
+    return HPX_NULL;
+  }
   int zero = 0;
   GVA gva;
   if (hpx_call_sync(HPX_THERE(0), AllocateCyclic, &gva, sizeof(gva), &n, &bsize,
@@ -459,6 +474,11 @@ AGAS::alloc_cyclic(size_t n, size_t bsize, uint32_t boundary, uint32_t attr) {
 
 hpx_addr_t
 AGAS::calloc_cyclic(size_t n, size_t bsize, uint32_t boundary, uint32_t attr) {
+  if (bsize > MAX_CYCLIC_BSIZE) {
+    log_error("cyclic blocks are limited to %" PRIu64 " bytes\n",
+              MAX_CYCLIC_BSIZE);
+    return HPX_NULL;
+  }
   int zero = 1;
   GVA gva;
   if (hpx_call_sync(HPX_THERE(0), AllocateCyclic, &gva, sizeof(gva), &n, &bsize,
@@ -598,10 +618,11 @@ void
 AGAS::memcpy(hpx_addr_t to, hpx_addr_t from, size_t size)
 {
   if (size) {
-    hpx_addr_t sync = hpx_lco_future_new(0);
+    hpx_lco_waiter_t waiter;
+    hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
     memcpy(to, from, size, sync);
-    dbg_check(hpx_lco_wait(sync));
-    hpx_lco_delete(sync, HPX_NULL);
+    dbg_check(hpx_lco_waiter_wait(&waiter));
+    hpx_lco_waiter_fini(&waiter);
   }
 }
 
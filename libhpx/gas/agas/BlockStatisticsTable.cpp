@@ -21,13 +21,18 @@
 #include "libhpx/config.h"
 #include "libhpx/debug.h"
 #include "libhpx/Worker.h"
+#include "libhpx/util/math.h"
 #include "rebalancer.h"
+#include <algorithm>
+#include <cstring>
 
 namespace {
 using libhpx::self;
+using libhpx::util::ceil2;
 using GVA = libhpx::gas::agas::GlobalVirtualAddress;
 using BST = libhpx::gas::agas::BlockStatisticsTable;
 using HierarchicalBST = libhpx::gas::agas::HierarchicalBST;
+using SampledBST = libhpx::gas::agas::SampledBST;
 }
 
 BST::BlockStatisticsTable()
@@ -45,20 +50,16 @@ void
 BST::add(GVA gva, unsigned src, int count, size_t size)
 {
   auto fn = [&](Entry& e) {
-    e.counts[src] += count;
-    e.sizes[src]  += size;
+    e.add(src, count, size);
   };
-  map_.upsert(gva, fn, Entry(here->ranks, src, count, size));
+  map_.upsert(gva, fn, Entry(src, count, size));
 }
 
 void
 BST::add(GVA gva, Entry& entry)
 {
   auto fn = [&](Entry& e) {
-    for (unsigned i = 0; i < e.n; ++i) {
-      e.counts[i] += entry.counts[i];
-      e.sizes[i]  += entry.sizes[i];
-    }
+    e.add(entry);
   };
   map_.upsert(gva, fn, entry);
 }
@@ -78,29 +79,36 @@ BST::clear()
 // vsizes : nvtxs
 // xadj   : nvtxs
 // nedges : 1
-// adjncy : max(ranks * nvtxs)
-// adjwgt : max(ranks * nvtxs)
+// adjncy : nedges
+// adjwgt : nedges
 // lsizes : ranks
-// lnbrs  : max(ranks * nvtxs)
+// lnbrs  : nedges
+//
+// where nedges is the total number of (block, source) pairs, which is
+// bounded by ranks * nvtxs but is usually much smaller.
 
 size_t
-BST::serializeMaxBytes(void) const
+BST::serializeMaxBytes(const LockedTable& lt) const
 {
-  const size_t n = map_.size();
+  const size_t n = lt.size();
   const unsigned ranks = here->ranks;
-  size_t count = 
+  size_t nedges = 0;
+  for (const auto& item : lt) {
+    nedges += item.second.sources.size();
+  }
+  size_t count =
       2                   // nvtx, nedges
       + 4 * n             // vtxs, vwgts, vsizes, xadj
-      + 3 * ranks * n     // adjncy, adjwgt, lnbrs
+      + 3 * nedges        // adjncy, adjwgt, lnbrs
       + ranks;            // lsizes
   return count * sizeof(uint64_t);
 }
 
 size_t
-BST::toBuffer(unsigned char* output)
+BST::toBuffer(LockedTable& lt, unsigned char* output)
 {
   const unsigned ranks = here->ranks;
-  const size_t map_size = map_.size();
+  const size_t map_size = lt.size();
 
   uint64_t* buf = reinterpret_cast<uint64_t*>(output);
 
@@ -123,31 +131,32 @@ BST::toBuffer(unsigned char* output)
   int nbrs = 0;
   std::vector<uint64_t> adjwgt;
   std::vector<uint64_t> lnbrs[ranks];
-  {
-    auto lt = map_.lock_table();
-    for (const auto& item : lt) {
-      auto& entry = item.second;
-      uint64_t total_vwgt  = 0;
-      uint64_t total_vsize = 0;
-      int prev_nbrs = nbrs;
-      for (unsigned k = 0; k < ranks; ++k) {
-        uint64_t count = entry.counts[k];
-        uint64_t size = entry.sizes[k];
-        if (count != 0) {
-          lnbrs[k].push_back(id);
-          adjncy[nbrs++] = k;
-          adjwgt.push_back(count * size);
-          total_vwgt  += count;
-          total_vsize += size;
-        }
-      }
+  for (auto& item : lt) {
+    auto& sources = item.second.sources;
+    uint64_t total_vwgt  = 0;
+    uint64_t total_vsize = 0;
+    int prev_nbrs = nbrs;
 
-      vtxs[id]   = item.first;
-      vwgt[id]   = total_vwgt;
-      vsizes[id] = total_vsize;
-      xadj[id]   = nbrs - prev_nbrs;
-      id++;
+    // emit the neighbors in rank order, as the partitioner expects
+    std::sort(sources.begin(), sources.end(),
+              [](const Entry::Source& a, const Entry::Source& b) {
+                return a.rank < b.rank;
+              });
+    for (const auto& s : sources) {
+      if (s.count != 0) {
+        lnbrs[s.rank].push_back(id);
+        adjncy[nbrs++] = s.rank;
+        adjwgt.push_back(s.count * s.size);
+        total_vwgt  += s.count;
+        total_vsize += s.size;
+      }
     }
+
+    vtxs[id]   = item.first;
+    vwgt[id]   = total_vwgt;
+    vsizes[id] = total_vsize;
+    xadj[id]   = nbrs - prev_nbrs;
+    id++;
   }
 
   // copy edge data into the serialized buffer
@@ -169,11 +178,11 @@ hpx_parcel_t*
 BST::toParcel()
 {
   auto lt = map_.lock_table();
-  size_t max_bytes = serializeMaxBytes();
+  size_t max_bytes = serializeMaxBytes(lt);
   hpx_parcel_t* p = hpx_parcel_acquire(NULL, max_bytes);
   unsigned char* buf = static_cast<unsigned char*>(hpx_parcel_get_data(p));
-  p->size = toBuffer(buf);
-  map_.clear();
+  p->size = toBuffer(lt, buf);
+  lt.clear();
   return p;
 }
 
@@ -205,13 +214,11 @@ HierarchicalBST::add(GVA gva, unsigned src, int count, size_t size)
   auto& map = mapArray_[id].map_;
   auto it = map.find(block);
   if (it != map.end()) {
-    auto entry = it->second;
-    entry.counts[src] += count;
-    entry.sizes[src]  += size;
+    it->second.add(src, count, size);
     return;
   }
 
-  map[block] = Entry(here->ranks, src, count, size);
+  map[block] = Entry(src, count, size);
 }
 
 // This function takes the thread-local BST and merges it with the
@@ -236,3 +243,133 @@ HierarchicalBST::toParcel()
   hpx_par_for_sync(mergeBST, 0, HPX_THREADS, this);
   return BST::toParcel();
 }
+
+constexpr unsigned SampledBST::WAYS;
+constexpr unsigned SampledBST::SOURCES;
+
+SampledBST::SampledBST(unsigned blocks, unsigned period)
+    : BlockStatisticsTable(),
+      period_(std::max(1u, period)),
+      sets_(ceil2(std::max(1u, blocks / WAYS))),
+      sketches_(nullptr)
+{
+  const int n = here->config->threads;
+  void* ptr;
+  if (posix_memalign(&ptr, HPX_CACHELINE_SIZE, n * sizeof(Sketch))) {
+    throw std::bad_alloc();
+  }
+  sketches_ = static_cast<Sketch*>(ptr);
+
+  const size_t bytes = sets_ * WAYS * sizeof(Record);
+  for (int i = 0; i < n; ++i) {
+    if (posix_memalign(&ptr, HPX_CACHELINE_SIZE, bytes)) {
+      throw std::bad_alloc();
+    }
+    std::memset(ptr, 0, bytes);
+    sketches_[i].records = static_cast<Record*>(ptr);
+    sketches_[i].countdown = period_;
+  }
+
+  log_gas("Sampled BST using %zu bytes per worker (1 in %u accesses).\n",
+          bytes, period_);
+}
+
+SampledBST::~SampledBST()
+{
+  for (int i = 0, e = here->config->threads; i < e; ++i) {
+    free(sketches_[i].records);
+  }
+  free(sketches_);
+}
+
+void
+SampledBST::Record::add(unsigned src, int count, size_t size)
+{
+  // space-saving over the sources: a new source replaces the lightest one
+  // and inherits its count
+  Source* victim = &sources[0];
+  for (auto& s : sources) {
+    if (s.rank == src && s.count) {
+      s.count += count;
+      s.size  += size;
+      return;
+    }
+    if (s.count < victim->count) {
+      victim = &s;
+    }
+  }
+  victim->rank   = src;
+  victim->count += count;
+  victim->size  += size;
+}
+
+void
+SampledBST::add(GVA gva, unsigned src, int count, size_t size)
+{
+  if (!self) return;
+
+  const uint64_t block = gva.getAddr();
+  Record* set = getSet(sketches_[self->getId()], block);
+  Record* victim = set;
+  for (unsigned i = 0; i < WAYS; ++i) {
+    Record& r = set[i];
+    if (r.block == block) {
+      r.count += count;
+      r.add(src, count, size);
+      return;
+    }
+    if (r.count < victim->count) {
+      victim = &r;
+    }
+  }
+
+  // space-saving over the blocks: evict the lightest block in the set, the
+  // new block inherits its count so that it is not evicted right away but
+  // the evicted block's sources are not attributed to it
+  victim->block = block;
+  victim->count += count;
+  std::memset(victim->sources, 0, sizeof(victim->sources));
+  victim->add(src, count, size);
+}
+
+void
+SampledBST::merge(unsigned id)
+{
+  // The records are plain data, so a concurrent add() from the owning worker
+  // can at worst perturb a count.
+  Record* records = sketches_[id].records;
+  unsigned count = 0;
+  for (unsigned i = 0, e = sets_ * WAYS; i < e; ++i) {
+    Record& r = records[i];
+    if (!r.block) {
+      continue;
+    }
+
+    Entry entry;
+    for (const auto& s : r.sources) {
+      if (s.count) {
+        entry.add(s.rank, uint64_t(s.count) * period_, s.size * period_);
+      }
+    }
+    BST::add(GVA(r.block), entry);
+    ++count;
+  }
+  std::memset(records, 0, sets_ * WAYS * sizeof(Record));
+  log_gas("Adding %u entries from %d thread-local sketch to global BST.\n",
+          count, id);
+}
+
+// This function merges the thread-local sketch with the per-node global BST.
+static int
+mergeSketch(int id, void* b)
+{
+  static_cast<SampledBST*>(b)->merge(id);
+  return HPX_SUCCESS;
+}
+
+hpx_parcel_t*
+SampledBST::toParcel()
+{
+  hpx_par_for_sync(mergeSketch, 0, HPX_THREADS, this);
+  return BST::toParcel();
+}
@@ -18,11 +18,13 @@
 #include "libhpx/parcel.h"
 #include "libhpx/padding.h"
 #include "libhpx/util/Aligned.h"
+#include "libhpx/Worker.h"
 #include "hpx/hpx.h"
 #include <cuckoohash_map.hh>
 #include <city_hasher.hh>
 #include <cinttypes>
 #include <unordered_map>
+#include <vector>
 #include "rebalancer.h"
 
 namespace libhpx {
@@ -40,33 +42,52 @@ class BlockStatisticsTable
   // Block Statistics Table (BST) entry.
   //
   // The BST entry maintains statistics about block accesses such as the
-  // number of times a block was accessed (@p counts) and the size of
-  // data transferred (@p sizes). The index in the @p counts and @p
-  // sizes array represents the node which accessed this block.
+  // number of times a block was accessed (@p count) and the size of
+  // data transferred (@p size) for each node that accessed this
+  // block. Only the nodes that actually touched the block have a
+  // record, so an entry costs O(accessors) rather than O(ranks).
   struct Entry {
-    Entry() {}
-    Entry(int n) : n(n)
+    struct Source {
+      unsigned     rank;
+      uint64_t    count;
+      uint64_t     size;
+    };
+
+    Entry() : sources() {}
+    Entry(unsigned src, uint64_t count, uint64_t size)
+        : sources(1, Source{src, count, size})
     {
-      counts = new uint64_t[n]();
-      sizes  = new uint64_t[n]();
     }
-    Entry(int n, const unsigned i, int count, size_t size) : n(n)
-    {
-      counts = new uint64_t[n]();
-      sizes  = new uint64_t[n]();
-      counts[i] = count;
-      sizes[i] = size;
+
+    void add(unsigned src, uint64_t count, uint64_t size) {
+      for (auto& s : sources) {
+        if (s.rank == src) {
+          s.count += count;
+          s.size  += size;
+          return;
+        }
+      }
+      sources.push_back(Source{src, count, size});
     }
-    ~Entry()
-    {
-      delete[] counts;
-      delete[] sizes;
+
+    void add(const Entry& e) {
+      for (const auto& s : e.sources) {
+        add(s.rank, s.count, s.size);
+      }
     }
-    size_t         n;
-    uint64_t* counts;
-    uint64_t*  sizes;
+
+    std::vector<Source> sources;
   };
 
+  /// Decide if the current access should be recorded.
+  ///
+  /// This is called before any other work is done for an access, in
+  /// particular before the attribute lookup in the BTT. The exact tables
+  /// record every access.
+  virtual bool sample() {
+    return true;
+  }
+
   /// Update a block statistics record for a GVA.
   virtual void add(GVA gva, unsigned src, int count, size_t size);
 
@@ -80,17 +101,17 @@ class BlockStatisticsTable
   // format from the global BST, and serializes it into a parcel.
   virtual hpx_parcel_t* toParcel();
 
- protected:
+ private:
+  using Map = cuckoohash_map<GVA, Entry, CityHasher<GVA>>;
+  using LockedTable = Map::locked_table;
+
   // Maximum bytes required for the serialized parcel.
-  size_t serializeMaxBytes() const;
+  size_t serializeMaxBytes(const LockedTable& lt) const;
 
   // Constructs a sparse graph in the compressed sparse row (CSR)
   // format from the global BST, and serializes it into an output
   // buffer.
-  size_t toBuffer(unsigned char* buf);
-
- private:
-  using Map = cuckoohash_map<GVA, Entry, CityHasher<GVA>>;
+  size_t toBuffer(LockedTable& lt, unsigned char* buf);
 
   const unsigned rank_;                         //!< cache the local rank
   Map map_;                                     //!< the hashtable
@@ -128,6 +149,89 @@ class HierarchicalBST final : public BlockStatisticsTable
   PaddedMap* mapArray_;   //!< thread-local map array
 };
 
+// A sampled, bounded-memory BST.
+//
+// Each worker owns a fixed-size, set-associative table of block
+// records that is managed with the space-saving algorithm: when a set
+// is full the record with the smallest count is evicted and the new
+// block inherits its count, so frequently accessed blocks stay resident
+// while the memory per worker is capped at @p blocks records. Each
+// record tracks a small, fixed number of source localities in the same
+// way.
+//
+// Only one of every @p period accesses is recorded. The interval
+// between samples is randomized so that we do not alias with strided
+// access patterns, and recorded values are scaled by the period when
+// they are merged into the per-locality BST.
+class SampledBST final : public BlockStatisticsTable
+{
+ public:
+  using GVA = GlobalVirtualAddress;
+
+  static constexpr unsigned WAYS = 8;           //!< associativity of a set
+  static constexpr unsigned SOURCES = 4;        //!< sources per record
+
+  SampledBST(unsigned blocks, unsigned period);
+  ~SampledBST();
+
+  /// Decide if the current access should be recorded.
+  virtual bool sample() {
+    if (period_ == 1) {
+      return true;
+    }
+    if (!self) {
+      return false;
+    }
+    unsigned& countdown = sketches_[self->getId()].countdown;
+    if (--countdown) {
+      return false;
+    }
+    countdown = 1 + self->rand(2 * period_ - 1);
+    return true;
+  }
+
+  /// Update a block statistics record for a GVA.
+  virtual void add(GVA gva, unsigned src, int count, size_t size);
+
+  // Constructs a sparse graph in the compressed sparse row (CSR)
+  // format from the global BST, and serializes it into a parcel.
+  virtual hpx_parcel_t* toParcel();
+
+  /// Merge the sketch at index @p id into the per-locality BST.
+  void merge(unsigned id);
+
+ private:
+  struct Record {
+    struct Source {
+      uint32_t rank;
+      uint32_t count;
+      uint64_t size;
+    };
+
+    void add(unsigned src, int count, size_t size);
+
+    uint64_t         block;                     //!< the block address
+    uint64_t         count;                     //!< the (over)estimated count
+    Source sources[SOURCES];                    //!< the heaviest sources
+  };
+
+  struct Sketch {
+    Record*     records;                        //!< sets_ * WAYS records
+    unsigned  countdown;                        //!< accesses until next sample
+    alignas(HPX_CACHELINE_SIZE) char end_[];
+  };
+
+  Record* getSet(Sketch& sketch, uint64_t block) const {
+    // fibonacci hashing, the high bits mix in the block offset and locality
+    uint64_t h = block * UINT64_C(0x9E3779B97F4A7C15);
+    return &sketch.records[((h >> 32) & (sets_ - 1)) * WAYS];
+  }
+
+  const unsigned  period_;                      //!< the sampling period
+  const unsigned    sets_;                      //!< sets per sketch (pow2)
+  Sketch*       sketches_;                      //!< the per-worker sketches
+};
+
 } // namespace agas
 } // namespace gas
 } // namespace libhpx
@@ -17,6 +17,7 @@
 
 #include "ChunkAllocator.h"
 #include "libhpx/debug.h"
+#include "libhpx/gas/Allocator.h"
 #include "libhpx/memory.h"
 #include "libhpx/system.h"
 #include "libhpx/util/math.h"
@@ -28,11 +29,13 @@ using libhpx::util::ceil_log2;
 using libhpx::util::ceil_div;
 }
 
-ChunkAllocator::ChunkAllocator(ChunkTable& chunks, size_t heapSize)
+ChunkAllocator::ChunkAllocator(ChunkTable& chunks, size_t heapSize,
+                               bool cyclic)
     : Bitmap(ceil_div(heapSize, as_bytes_per_chunk()),
              ceil_log2(as_bytes_per_chunk()),
              ceil_log2(heapSize)),
       chunkSize_(as_bytes_per_chunk()),
+      cyclic_(cyclic),
       chunks_(chunks)
 {
 }
@@ -58,6 +61,7 @@ ChunkAllocator::allocate(void* addr, size_t n, size_t align, size_t bsize)
   void *base = system_mmap(NULL, addr, n, align);
   dbg_assert(base);
   dbg_assert(((uintptr_t)base & (align - 1)) == 0);
+  libhpx::gas::Allocator::PlaceChunk(base, n, cyclic_);
 
   // 3) insert the inverse mappings
   char* chunk = static_cast<char*>(base);
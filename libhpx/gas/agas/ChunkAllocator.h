@@ -31,7 +31,7 @@ namespace agas {
 /// the mapping.
 class ChunkAllocator : public util::Bitmap {
  public:
-  ChunkAllocator(ChunkTable& chunks, size_t heapSize);
+  ChunkAllocator(ChunkTable& chunks, size_t heapSize, bool cyclic);
   ~ChunkAllocator();
 
   /// Allocate a chunk from the global address space.
@@ -54,6 +54,7 @@ class ChunkAllocator : public util::Bitmap {
 
  private:
   const size_t chunkSize_;
+  const bool cyclic_;
   ChunkTable& chunks_;
 };
 
@@ -36,13 +36,15 @@
 namespace {
 using libhpx::self;
 using GVA = libhpx::gas::agas::GlobalVirtualAddress;
-using BST = libhpx::gas::agas::HierarchicalBST;
+using BST = libhpx::gas::agas::BlockStatisticsTable;
+using HierarchicalBST = libhpx::gas::agas::HierarchicalBST;
+using SampledBST = libhpx::gas::agas::SampledBST;
 }
 
 // Per-locality BST.
 //
-// During statistics aggration, all of the thread-local BSTs are
-// aggregated into a per-locality BST.
+// During statistics aggration, all of the thread-local BSTs (or
+// sketches) are aggregated into a per-locality BST.
 static BST *_bst = NULL;
 
 // Add an entry to the rebalancer's (thread-local) BST table.
@@ -58,6 +60,11 @@ void rebalancer_add_entry(int src, int dst, hpx_addr_t block, size_t size) {
     return;
   }
 
+  // skip unsampled accesses before we pay for the attribute lookup
+  if (!_bst->sample()) {
+    return;
+  }
+
   // ignore this block if it does not have the "load-balance"
   // (HPX_GAS_ATTR_LB) attribute
   GVA gva(block);
@@ -72,7 +79,13 @@ void rebalancer_add_entry(int src, int dst, hpx_addr_t block, size_t size) {
 
 // Initialize the AGAS-based rebalancer.
 int rebalancer_init(void) {
-  _bst = new BST();
+  // a zero block bound selects the exact (unbounded) statistics tables
+  const config_t *cfg = here->config;
+  if (cfg->rebalancer_blocks) {
+    _bst = new SampledBST(cfg->rebalancer_blocks, cfg->rebalancer_sample);
+  } else {
+    _bst = new HierarchicalBST();
+  }
   dbg_assert(_bst);
 
   log_gas("GAS rebalancer initialized\n");
@@ -55,6 +55,15 @@ bool
 hpx_gas_try_pin(const hpx_addr_t addr, void **local)
 {
   dbg_assert(here && here->gas);
+  if (here->gas->isWaiter(addr)) {
+    if (GAS::WaiterRank(addr) != here->rank) {
+      return false;
+    }
+    if (local) {
+      *local = GAS::WaiterLVA(addr);
+    }
+    return true;
+  }
   return here->gas->tryPin(addr, local);
 }
 
@@ -62,7 +71,9 @@ void
 hpx_gas_unpin(const hpx_addr_t addr)
 {
   dbg_assert(here && here->gas);
-  here->gas->unpin(addr);
+  if (!here->gas->isWaiter(addr)) {
+    here->gas->unpin(addr);
+  }
 }
 
 hpx_addr_t
@@ -261,10 +272,11 @@ hpx_gas_free(hpx_addr_t addr, hpx_addr_t sync)
 void
 hpx_gas_free_sync(hpx_addr_t addr)
 {
-  hpx_addr_t sync = hpx_lco_future_new(0);
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
   hpx_gas_free(addr, sync);
-  hpx_lco_wait(sync);
-  hpx_lco_delete(sync, HPX_NULL);
+  hpx_lco_waiter_wait(&waiter);
+  hpx_lco_waiter_fini(&waiter);
 }
 
 static int
@@ -450,6 +462,19 @@ void hpx_gas_clear_affinity(hpx_addr_t gva) {
   here->gas->clearAffinity(gva);
 }
 
+void
+hpx_gas_set_affinity_range(hpx_addr_t base, size_t n, size_t bsize,
+                           hpx_affinity_policy_t policy)
+{
+  here->gas->setAffinityRange(base, n, bsize, policy);
+}
+
+void
+hpx_gas_clear_affinity_range(hpx_addr_t base)
+{
+  here->gas->clearAffinityRange(base);
+}
+
 int
 hpx_register_memory(const void *buffer, size_t bytes)
 {
@@ -16,6 +16,8 @@
 #endif
 
 #include "HeapSegment.h"
+#include "libhpx/GAS.h"
+#include "libhpx/gas/Allocator.h"
 #include "libhpx/gpa.h"
 #include "libhpx/libhpx.h"
 #include "libhpx/locality.h"
@@ -27,11 +29,16 @@
 #include <exception>
 
 namespace {
+using libhpx::gas::Allocator;
 using libhpx::gas::pgas::HeapSegment;
 using libhpx::util::Bitmap;
 using libhpx::util::ceil_log2;
 using libhpx::util::ceil_div;
-const uint64_t MAX_HEAP_BYTES = UINT64_C(1) << GPA_OFFSET_BITS;
+
+/// Offsets with all of the waiter tag's bits set name stack waiters.
+const uint64_t MAX_HEAP_BYTES = libhpx::GAS::WAITER_TAG;
+static_assert(libhpx::GAS::WAITER_TAG < (UINT64_C(1) << GPA_OFFSET_BITS),
+              "the waiter tag must lie within the gpa offset");
 }
 
 HeapSegment* HeapSegment::Instance_;
@@ -118,6 +125,7 @@ HeapSegment::allocateChunk(void *addr, size_t n, size_t align, ChunkType type)
 
   void *p = offsetToLVA(offset);
   dbg_assert(((uintptr_t)p & (align - 1)) == 0);
+  Allocator::PlaceChunk(p, n, type == CYCLIC);
   return p;
 }
 
@@ -203,12 +203,11 @@ void
 PGAS::memcpy(hpx_addr_t to, hpx_addr_t from, size_t n)
 {
   if (n) {
-    hpx_addr_t sync = hpx_lco_future_new(0);
-    dbg_assert_str(sync, "could not allocate an LCO for memcpy_sync.\n");
-
+    hpx_lco_waiter_t waiter;
+    hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
     memcpy(to, from, n, sync);
-    dbg_check(hpx_lco_wait(sync), "failed agas_memcpy_sync\n");
-    hpx_lco_delete(sync, HPX_NULL);
+    dbg_check(hpx_lco_waiter_wait(&waiter), "failed pgas_memcpy_sync\n");
+    hpx_lco_waiter_fini(&waiter);
   }
 }
 
@@ -25,6 +25,7 @@
 # include "apex.h"
 #endif
 
+#include "libhpx/accounting.h"
 #include "libhpx/action.h"
 #include "libhpx/config.h"
 #include "libhpx/debug.h"
@@ -34,7 +35,9 @@
 #include "libhpx/memory.h"
 #include "libhpx/Network.h"
 #include "libhpx/percolation.h"
+#include "libhpx/perf.h"
 #include "libhpx/process.h"
+#include "libhpx/profile.h"
 #include "libhpx/Scheduler.h"
 #include "libhpx/system.h"
 #include "libhpx/time.h"
@@ -58,6 +61,9 @@ static void _cleanup(locality_t *l) {
   }
 
   delete l->sched;
+  profile_fini();
+  perf_fini();
+  accounting_fini();
 
 #ifdef HAVE_APEX
   apex_finalize();
@@ -143,7 +149,9 @@ int hpx_init(int *argc, char ***argv) {
   }
 
   // Initialize the tracing backend---have to wait until after bootstrap is
-  // initialized because it checks to see if this rank is tracing.
+  // initialized because it checks to see if this rank is tracing. Traces and
+  // profiles are timestamped with the TSC if we can calibrate it.
+  INST(libhpx_time_calibrate());
   here->tracer = trace_new(here->config);
 
   // see if we're supposed to output the configuration, only do this at rank 0
@@ -194,6 +202,10 @@ int hpx_init(int *argc, char ***argv) {
   apex_init("HPX WORKER THREAD", here->rank, here->ranks);
 #endif
 
+  // hardware counters are opened by each worker thread as it starts
+  perf_init(here->config, here->config->threads);
+  accounting_init(here->config->threads);
+
   // thread scheduler
   here->sched = new Scheduler(here->config);
   if (!here->sched) {
@@ -202,6 +214,7 @@ int hpx_init(int *argc, char ***argv) {
   }
 
   action_registration_finalize();
+  profile_init(here->sched->getNWorkers());
   trace_start(here->tracer);
   return status;
  unwind1:
@@ -0,0 +1,59 @@
+// ==================================================================-*- C++ -*-
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifndef LIBHPX_INSTRUMENTATION_COUNTERS_H
+#define LIBHPX_INSTRUMENTATION_COUNTERS_H
+
+#include <cstdint>
+#include <cstdio>
+
+namespace libhpx {
+namespace instrumentation {
+/// Per-worker counters.
+///
+/// The stats backend, the action profiles, and the scheduler accounting all
+/// keep counters that only their worker writes, but that are read while the
+/// worker is running. There's no need for an atomic read-modify-write, but the
+/// stores and loads have to be atomic so that a reader never sees a torn value.
+/// @{
+inline void
+Bump(uint64_t& counter, uint64_t n = 1)
+{
+  __atomic_store_n(&counter, counter + n, __ATOMIC_RELAXED);
+}
+
+inline void
+Set(uint64_t& counter, uint64_t n)
+{
+  __atomic_store_n(&counter, n, __ATOMIC_RELAXED);
+}
+
+inline uint64_t
+Read(const uint64_t& counter)
+{
+  return __atomic_load_n(&counter, __ATOMIC_RELAXED);
+}
+/// @}
+
+/// Write a report to @p filename, or to stdout if it's NULL.
+///
+/// @param     filename The file to write, or NULL for stdout.
+/// @param         what What is being written, for the error message.
+/// @param         dump The function that writes the report.
+///
+/// @returns            HPX_SUCCESS, or an error if the file can't be opened.
+int Dump(const char* filename, const char* what, void (*dump)(FILE*));
+} // namespace instrumentation
+} // namespace libhpx
+
+#endif // LIBHPX_INSTRUMENTATION_COUNTERS_H
@@ -0,0 +1,193 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+/// @file libhpx/instrumentation/Stream.cpp
+/// @brief A worker's double-buffered trace stream.
+
+#include "Stream.h"
+#include "metadata.h"
+#include "libhpx/debug.h"
+#include "libhpx/time.h"
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace {
+using libhpx::instrumentation::Stream;
+using libhpx::instrumentation::WriteAll;
+constexpr auto RELAXED = std::memory_order_relaxed;
+constexpr auto ACQUIRE = std::memory_order_acquire;
+constexpr auto RELEASE = std::memory_order_release;
+
+/// The size of a TRACE_DROPPED record.
+constexpr size_t DROPPED_BYTES = sizeof(stream_record_t) + sizeof(record_t) +
+                                 sizeof(uint64_t);
+
+static_assert(sizeof(stream_record_t) == 2 * sizeof(uint32_t) &&
+              sizeof(record_t) == sizeof(uint64_t),
+              "trace_record() doesn't match the stream record layout");
+}
+
+bool
+libhpx::instrumentation::WriteAll(int fd, struct iovec *iov, int n)
+{
+  while (n) {
+    ssize_t e = writev(fd, iov, n);
+    if (e < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    for (; n && size_t(e) >= iov->iov_len; ++iov, --n) {
+      e -= iov->iov_len;
+    }
+    if (n) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + e;
+      iov->iov_len -= e;
+    }
+  }
+  return true;
+}
+
+Stream::Stream(int fd, size_t bytes)
+    : fd_(fd),
+      size_(bytes),
+      buffers_{static_cast<char*>(malloc(bytes)),
+               static_cast<char*>(malloc(bytes))},
+      used_{0, 0},
+      full_(),
+      active_(0),
+      buffer_{buffers_[0], buffers_[0] + bytes},
+      dropped_(0),
+      total_(0)
+{
+  full_[0].store(false, RELAXED);
+  full_[1].store(false, RELAXED);
+}
+
+Stream::~Stream()
+{
+  free(buffers_[0]);
+  free(buffers_[1]);
+}
+
+char*
+Stream::reserve(size_t bytes, uint32_t event)
+{
+  stream_record_t *r = reinterpret_cast<stream_record_t*>(buffer_.next);
+  r->event = event;
+  r->bytes = bytes - sizeof(*r);
+  buffer_.next += bytes;
+  return reinterpret_cast<char*>(r + 1);
+}
+
+bool
+Stream::swap()
+{
+  unsigned other = active_ ^ 1;
+  if (full_[other].load(ACQUIRE)) {
+    return false;
+  }
+
+  used_[active_] = buffer_.next - buffers_[active_];
+  full_[active_].store(true, RELEASE);
+  active_ = other;
+  buffer_.next = buffers_[other];
+  buffer_.end = buffer_.next + size_;
+  return true;
+}
+
+bool
+Stream::append(int event, int n, const uint64_t args[])
+{
+  const size_t bytes = sizeof(stream_record_t) + sizeof(record_t) +
+                       n * sizeof(uint64_t);
+  const uint64_t time = libhpx_trace_time();
+
+  // Pending drops are recorded before the record, so they need room too.
+  bool swapped = false;
+  if (buffer_.next + bytes + ((dropped_) ? DROPPED_BYTES : 0) > buffer_.end) {
+    if (!(swapped = swap())) {
+      ++dropped_;
+      return false;
+    }
+  }
+
+  // Record the drops at the start of the new half, so that they appear in the
+  // stream at about the point where they happened.
+  if (dropped_) {
+    record_t *r = reinterpret_cast<record_t*>(reserve(DROPPED_BYTES,
+                                                      TRACE_DROPPED));
+    r->ns = time;
+    r->user[0] = dropped_;
+    total_ += dropped_;
+    dropped_ = 0;
+  }
+
+  record_t *r = reinterpret_cast<record_t*>(reserve(bytes, event));
+  r->ns = time;
+  for (int i = 0, e = n; i < e; ++i) {
+    r->user[i] = args[i];
+  }
+  return swapped;
+}
+
+void
+Stream::drain()
+{
+  for (int i = 0; i < 2; ++i) {
+    if (full_[i].load(ACQUIRE)) {
+      struct iovec iov = { buffers_[i], used_[i] };
+      if (!WriteAll(fd_, &iov, 1)) {
+        log_error("failed to write trace stream\n");
+      }
+      full_[i].store(false, RELEASE);
+    }
+  }
+}
+
+void
+Stream::finish()
+{
+  // At most one half is full, and it precedes the active half in the stream.
+  // Drops that haven't been recorded yet go at the end.
+  struct iovec iov[3];
+  int n = 0;
+  unsigned other = active_ ^ 1;
+  if (full_[other].load(ACQUIRE)) {
+    iov[n++] = { buffers_[other], used_[other] };
+  }
+  iov[n++] = { buffers_[active_], size_t(buffer_.next - buffers_[active_]) };
+
+  uint64_t tail[DROPPED_BYTES / sizeof(uint64_t)];
+  if (dropped_) {
+    stream_record_t *h = reinterpret_cast<stream_record_t*>(tail);
+    h->event = TRACE_DROPPED;
+    h->bytes = sizeof(tail) - sizeof(*h);
+    tail[1] = libhpx_trace_time();
+    tail[2] = dropped_;
+    iov[n++] = { tail, sizeof(tail) };
+  }
+  if (!WriteAll(fd_, iov, n)) {
+    log_error("failed to write trace stream\n");
+  }
+  if (close(fd_)) {
+    log_error("failed to close trace file\n");
+  }
+}
+
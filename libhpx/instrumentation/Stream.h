@@ -0,0 +1,77 @@
+// ==================================================================-*- C++ -*-
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifndef LIBHPX_INSTRUMENTATION_STREAM_H
+#define LIBHPX_INSTRUMENTATION_STREAM_H
+
+#include "libhpx/instrumentation.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/uio.h>
+
+namespace libhpx {
+namespace instrumentation {
+/// Write all of an iovec array, handling short writes.
+bool WriteAll(int fd, struct iovec *iov, int n);
+
+/// The trace stream for a single worker.
+///
+/// The worker owns the active half of the buffer, which is bound to it as its
+/// direct trace buffer so that the event emitters write into it without
+/// calling into the tracer. When it fills, the worker marks it full and
+/// switches to the other half, as long as the writer has already drained that
+/// half. The writer only ever touches full halves.
+class Stream {
+ public:
+  Stream(int fd, size_t bytes);
+  ~Stream();
+
+  /// Append a record, returning true if a full half was handed off.
+  bool append(int event, int n, const uint64_t args[]);
+
+  trace_buffer_t* buffer() {
+    return &buffer_;
+  }
+
+  /// Write a full half if there is one (writer thread).
+  void drain();
+
+  /// Write everything that's left and close the file.
+  void finish();
+
+  uint64_t dropped() const {
+    return total_ + dropped_;
+  }
+
+ private:
+  /// Make room for a record of @p bytes in the active half.
+  char* reserve(size_t bytes, uint32_t event);
+
+  /// Hand off the active half, and switch to the other.
+  bool swap();
+
+  const int                fd_;
+  const size_t           size_;
+  char*            buffers_[2];
+  size_t              used_[2];                 //!< bytes in a full half
+  std::atomic<bool>   full_[2];                 //!< owned by the writer
+  unsigned             active_;
+  trace_buffer_t       buffer_;                 //!< the rest of the active half
+  uint64_t            dropped_;                 //!< since the last swap
+  uint64_t              total_;                 //!< recorded in the stream
+};
+} // namespace instrumentation
+} // namespace libhpx
+
+#endif // LIBHPX_INSTRUMENTATION_STREAM_H
@@ -15,8 +15,7 @@
 #define LIBHPX_INSTRUMENTATION_TRACE_H
 
 #include "libhpx/config.h"
-#include <cstdarg>
-#include <atomic>
+#include <cstdint>
 
 namespace libhpx {
 namespace instrumentation {
@@ -24,11 +23,20 @@ class Trace {
  public:
   virtual ~Trace();
 
-  std::atomic<bool> active;
+  /// The classes to trace, once tracing is active.
+  const uint64_t classes;
+
+  /// True if tracing starts active, i.e., --hpx-trace-off wasn't given.
+  const bool active;
 
   virtual void start(void) = 0;
   virtual void destroy(void) = 0;
-  virtual void vappend(int type, int n, int id, va_list&) = 0;
+
+  /// Record an event that the emitter couldn't write directly.
+  ///
+  /// This is called on a worker thread, with the event's arguments converted
+  /// to uint64_t.
+  virtual void record(int id, int n, const uint64_t args[]) = 0;
 
  protected:
   Trace(const config_t *cfg);
@@ -0,0 +1,260 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+/// @file libhpx/instrumentation/accounting.cpp
+/// @brief Per-worker scheduler state accounting.
+///
+/// Each worker has its own counters on their own cachelines (see Counters.h).
+/// Readers add the time that a worker has spent in its current state so far,
+/// so that long sleeps and long-running threads show up before the worker's
+/// next transition.
+
+#include "Counters.h"
+#include "libhpx/accounting.h"
+#include "libhpx/debug.h"
+#include "libhpx/locality.h"
+#include "libhpx/time.h"
+#include "libhpx/Topology.h"
+#include <hpx/hpx.h>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+using libhpx::instrumentation::Bump;
+using libhpx::instrumentation::Read;
+
+const char* const STATES[] = {
+  "user",
+  "sched",
+  "network",
+  "steal",
+  "sleep"
+};
+
+const char* const DISTANCES[] = {
+  "core",
+  "numa",
+  "remote"
+};
+
+/// One worker's counters.
+struct alignas(HPX_CACHELINE_SIZE) Counters {
+  uint64_t                      last;           //!< the last transition
+  int                          state;           //!< the current state
+  int                           core;           //!< the worker's core
+  int                           numa;           //!< the worker's numa node
+  uint64_t ticks[ACCOUNTING_STATES];
+  uint64_t                      idle;
+  uint64_t attempts[ACCOUNTING_DISTANCES];
+  uint64_t     hits[ACCOUNTING_DISTANCES];
+};
+
+Counters* _counters;
+unsigned _nworkers;
+
+/// Convert trace clock ticks to seconds.
+double
+Seconds(uint64_t ticks)
+{
+  return ticks / libhpx_trace_clock.ticks_per_ns / 1e9;
+}
+
+double
+Ratio(uint64_t n, uint64_t d)
+{
+  return (d) ? double(n) / d : 0.0;
+}
+
+/// The totals for one worker, or for all of them.
+struct Totals {
+  uint64_t ticks[ACCOUNTING_STATES];
+  uint64_t                      idle;
+  uint64_t attempts[ACCOUNTING_DISTANCES];
+  uint64_t     hits[ACCOUNTING_DISTANCES];
+
+  void add(int w) {
+    for (int s = 0; s < ACCOUNTING_STATES; ++s) {
+      ticks[s] += accounting_ticks(w, s);
+    }
+    idle += accounting_idle_ticks(w);
+    for (int d = 0; d < ACCOUNTING_DISTANCES; ++d) {
+      attempts[d] += accounting_steal_attempts(w, d);
+      hits[d] += accounting_steal_hits(w, d);
+    }
+  }
+
+  void print(FILE* f, const char* worker) const {
+    uint64_t total = 0;
+    for (int s = 0; s < ACCOUNTING_STATES; ++s) {
+      total += ticks[s];
+    }
+    for (int s = 0; s < ACCOUNTING_STATES; ++s) {
+      fprintf(f, "%d,%s,%s_seconds,%.6f,%.4f\n", here->rank, worker,
+              STATES[s], Seconds(ticks[s]), Ratio(ticks[s], total));
+    }
+    fprintf(f, "%d,%s,idle_seconds,%.6f,%.4f\n", here->rank, worker,
+            Seconds(idle), Ratio(idle, total));
+    for (int d = 0; d < ACCOUNTING_DISTANCES; ++d) {
+      fprintf(f, "%d,%s,steal_attempts_%s,%" PRIu64 ",\n", here->rank, worker,
+              DISTANCES[d], attempts[d]);
+      fprintf(f, "%d,%s,steal_hits_%s,%" PRIu64 ",%.4f\n", here->rank, worker,
+              DISTANCES[d], hits[d], Ratio(hits[d], attempts[d]));
+    }
+  }
+};
+}
+
+unsigned
+accounting_workers(void)
+{
+  return _nworkers;
+}
+
+const char *
+accounting_state_name(int state)
+{
+  dbg_assert(0 <= state && state < ACCOUNTING_STATES);
+  return STATES[state];
+}
+
+const char *
+accounting_distance_name(int distance)
+{
+  dbg_assert(0 <= distance && distance < ACCOUNTING_DISTANCES);
+  return DISTANCES[distance];
+}
+
+uint64_t
+accounting_ticks(int w, int state)
+{
+  const Counters& c = _counters[w];
+  uint64_t ticks = Read(c.ticks[state]);
+  if (__atomic_load_n(&c.state, __ATOMIC_RELAXED) == state) {
+    uint64_t last = Read(c.last);
+    uint64_t now = libhpx_trace_time();
+    ticks += (last < now) ? now - last : 0;
+  }
+  return ticks;
+}
+
+uint64_t
+accounting_idle_ticks(int w)
+{
+  return Read(_counters[w].idle);
+}
+
+uint64_t
+accounting_steal_attempts(int w, int distance)
+{
+  return Read(_counters[w].attempts[distance]);
+}
+
+uint64_t
+accounting_steal_hits(int w, int distance)
+{
+  return Read(_counters[w].hits[distance]);
+}
+
+void
+accounting_dump(FILE *f)
+{
+  fprintf(f, "rank,worker,metric,value,ratio\n");
+  if (!_nworkers) {
+    return;
+  }
+
+  Totals all;
+  memset(&all, 0, sizeof(all));
+  for (unsigned w = 0; w < _nworkers; ++w) {
+    Totals t;
+    memset(&t, 0, sizeof(t));
+    t.add(w);
+    all.add(w);
+    char worker[16];
+    snprintf(worker, sizeof(worker), "%u", w);
+    t.print(f, worker);
+  }
+  all.print(f, "all");
+}
+
+#ifdef ENABLE_INSTRUMENTATION
+void
+accounting_init(unsigned workers)
+{
+  size_t bytes = workers * sizeof(Counters);
+  if (posix_memalign((void**)&_counters, HPX_CACHELINE_SIZE, bytes)) {
+    dbg_error("could not allocate scheduler accounting\n");
+  }
+  memset(_counters, 0, bytes);
+
+  // workers are mapped onto cpus the same way that Worker() finds its node
+  const libhpx::Topology* topo = here->topology;
+  uint64_t now = libhpx_trace_time();
+  for (unsigned w = 0; w < workers; ++w) {
+    int cpu = w % topo->ncpus;
+    _counters[w].last = now;
+    _counters[w].state = ACCOUNTING_SCHED;
+    _counters[w].core = topo->cpu_to_core[cpu];
+    _counters[w].numa = topo->cpu_to_numa[cpu];
+  }
+  _nworkers = workers;
+}
+
+void
+accounting_fini(void)
+{
+  _nworkers = 0;
+  free(_counters);
+  _counters = nullptr;
+}
+
+uint64_t
+accounting_enter(int w, accounting_state_t state)
+{
+  Counters& c = _counters[w];
+  uint64_t now = libhpx_trace_time();
+  Bump(c.ticks[c.state], now - c.last);
+  __atomic_store_n(&c.last, now, __ATOMIC_RELAXED);
+  __atomic_store_n(&c.state, int(state), __ATOMIC_RELAXED);
+  return now;
+}
+
+void
+accounting_idle(int w, uint64_t start)
+{
+  Bump(_counters[w].idle, libhpx_trace_time() - start);
+}
+
+void
+accounting_steal(int w, int victim, int hit)
+{
+  Counters& c = _counters[w];
+  const Counters& v = _counters[victim];
+  int d = (c.core == v.core) ? ACCOUNTING_CORE :
+          (c.numa == v.numa) ? ACCOUNTING_NUMA : ACCOUNTING_REMOTE;
+  Bump(c.attempts[d]);
+  Bump(c.hits[d], hit != 0);
+}
+#endif
+
+int
+hpx_sched_dump(const char *filename)
+{
+  return libhpx::instrumentation::Dump(filename, "scheduler accounting",
+                                       accounting_dump);
+}
@@ -63,66 +63,13 @@ class ConsoleTracer : public Trace {
   ~ConsoleTracer() {
   }
 
-  void vappend(int UNUSED, int n, int id, va_list& vargs) {
-    int c = TRACE_EVENT_TO_CLASS[id];
-
-    switch (n) {
-     case 0:
-      _vprint_console(c, id, "");
-      break;
-     case 1:
-      _vprint_console(c, id, ",%" PRIu64, va_arg(vargs, uint64_t));
-      break;
-     case 2:
-      _vprint_console(c, id, ",%" PRIu64 ",%" PRIu64,
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t));
-      break;
-     case 3:
-      _vprint_console(c, id, ",%" PRIu64 ",%" PRIu64 ",%" PRIu64,
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t));
-      break;
-     case 4:
-      _vprint_console(c, id, ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64,
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t));
-      break;
-     case 5:
-      _vprint_console(c, id, ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
-                      ",%" PRIu64,
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t));
-      break;
-     case 6:
-      _vprint_console(c, id, ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
-                      ",%" PRIu64 ",%" PRIu64,
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t));
-      break;
-     case 7:
-     default:
-      _vprint_console(c, id, ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
-                      ",%" PRIu64 ",%" PRIu64 ",%" PRIu64,
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t),
-                      va_arg(vargs, uint64_t));
-      break;
+  void record(int id, int n, const uint64_t args[]) {
+    char buffer[128] = {0};
+    for (int i = 0, offset = 0; i < n; ++i) {
+      offset += snprintf(buffer + offset, sizeof(buffer) - offset,
+                         ",%" PRIu64, args[i]);
     }
+    _vprint_console(TRACE_EVENT_TO_CLASS[id], id, "%s", buffer);
   }
 
   void start(void) {
@@ -15,8 +15,22 @@
 # include "config.h"
 #endif
 
+/// @file libhpx/instrumentation/file.cpp
+/// @brief The file tracing backend.
+///
+/// Each worker appends the records for all of its events to one stream, with a
+/// self-describing header (see write_stream_header()). Workers never do I/O.
+/// They fill one half of a double buffer and hand it to a background writer
+/// thread, and if the writer hasn't finished with the other half by the time
+/// the current one fills, records are dropped and counted rather than blocking
+/// the worker. The count is written to the stream as a TRACE_DROPPED record.
+
+#include "Stream.h"
 #include "Trace.h"
 
+#include <errno.h>
+#include <inttypes.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,16 +39,28 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <pwd.h>
 
 #include <libhpx/debug.h>
 #include <libhpx/libhpx.h>
+#include <libhpx/profile.h>
 #include <libhpx/Scheduler.h>
+#include <libhpx/time.h>
 #include "libhpx/Worker.h"
 #include <hpx/hpx.h>
 #include "metadata.h"
 #include "file.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
 
 namespace {
 using libhpx::Worker;
@@ -44,20 +70,6 @@ using libhpx::Worker;
 # define HOST_NAME_MAX 255
 #endif
 
-/// The logtable structure.
-///
-/// This is used to represent all of the data needed to keep the state
-/// of an individual event log
-typedef struct logtable {
-  int               fd;               //!< file backing the log
-  int         event_id;               //!< the event we're logging
-  int     record_bytes;               //!< record size
-  char         *buffer;               //!< pointer to buffer
-  char * volatile next;               //!< pointer to next record
-  size_t      max_size;               //!< max size in bytes
-  size_t   header_size;               //!< header size in bytes
-} logtable_t;
-
 /// The path to the log directory.
 ///
 /// This path is set up during inst_init either based on the --hpx-inst-dir
@@ -205,150 +217,71 @@ static void _dump_actions(void) {
   fclose(file);
 }
 
-/// Initialize a logtable.
-///
-/// This will create a file-backed mmaped buffer for this event for logging
-/// purposes.
-///
-/// @param           lt The log table to initialize.
-/// @param     filename The name of the file to create and map.
-/// @param         size The number of bytes to allocate.
-/// @param         type The event class.
-/// @param     event_id The event type.
-/// @param    worker_id ID of the current worker
-static void logtable_init(logtable_t *log, const char* filename, size_t size,
-                   int type, int event_id, int worker_id) {
-  log->fd = -1;
-  log->event_id = event_id;
-  log->record_bytes = 0;
-  log->max_size = size;
-
-  if (filename == NULL || size == 0) {
-    return;
-  }
-
-  log->fd = _create_file(filename, size);
-  if (log->fd == -1) {
-    log_error("could not create log file %s\n", filename);
-    return;
-  }
-
-  log->buffer = static_cast<char*>(malloc(size));
-  if (!log->buffer) {
-    log_error("problem allocating buffer for %s\n", filename);
-    close(log->fd);
-    return;
-  }
-
-  int fields = TRACE_EVENT_NUM_FIELDS[event_id];
-  log->record_bytes = sizeof(record_t) + fields * sizeof(uint64_t);
-  log->next = log->buffer - log->record_bytes;
-
-  char *buffer = static_cast<char*>(calloc(1, 32768));
-  log->header_size = write_trace_header(buffer, type, event_id, worker_id);
-  if (write(log->fd, buffer, log->header_size) != (ssize_t)log->header_size) {
-    log_error("failed to write header to file\n");
-  }
-  free(buffer);
-}
+/// Output the per-action profiles as a csv file next to the actions.
+static void _dump_profile(void) {
+  char filename[256];
+  snprintf(filename, 256, "profile.%d.csv", hpx_get_my_rank());
 
-/// Clean up a log table.
-///
-/// It is safe to call this on an uninitialized log table. If the log table was
-/// initialized this will unmap its buffer, and truncate and close the
-/// corresponding file.
-///
-/// @param           lt The log table to finalize.
-static void logtable_fini(logtable_t *log) {
-  if (!log || log->fd <= 0 || !log->max_size) {
+  FILE *file = _fopen_log(filename, "failed to open profile file");
+  if (!file) {
     return;
   }
 
-  size_t filesize = log->next - log->buffer;
-  write(log->fd, log->buffer, filesize);
-  if (close(log->fd)) {
-    log_error("failed to close trace file\n");
-  }
-}
-
-static
-void _create_logtable(int worker_id, int type, int event_id, size_t size) {
-  char filename[256];
-  snprintf(filename, 256, "%05d.%03d.event.%03d.%s.log",
-           hpx_get_my_rank(), worker_id, event_id,
-           TRACE_EVENT_TO_STRING[event_id]);
-
-  char *path = _concat_path(_log_path, filename);
-  logtable_t *log = &here->logs[worker_id][event_id];
-  logtable_init(log, path, size, type, event_id, worker_id);
-  free(path);
+  profile_dump(file);
+  fclose(file);
 }
 
 namespace {
 using libhpx::self;
+using libhpx::instrumentation::Stream;
 using libhpx::instrumentation::Trace;
+using libhpx::instrumentation::WriteAll;
+constexpr auto RELAXED = std::memory_order_relaxed;
+constexpr auto ACQUIRE = std::memory_order_acquire;
+constexpr auto RELEASE = std::memory_order_release;
+
+/// The smallest buffer we'll use, so that a record always fits.
+constexpr size_t MIN_BUFFER_BYTES = 4096;
+
+/// The file tracer, with one stream per worker and a single writer thread.
 class FileTracer : public Trace {
  public:
-  FileTracer(const config_t *cfg) : Trace(cfg) {
+  FileTracer(const config_t *cfg) : Trace(cfg), streams_(), writer_(),
+                                    lock_(), wake_(), pending_(false),
+                                    stop_(false) {
   }
 
   ~FileTracer() {
   }
 
-  // int type() const {
-  //   return HPX_TRACE_BACKEND_FILE;
-  // }
-
-  /// Append a record to a log table.
+  /// Append a record to the current worker's stream.
   ///
-  /// Log tables have variable length record sizes based on their event type. This
-  /// allows the user to log a variable number of features with each trace point.
+  /// This is only called when the worker's buffer is full, or for the first
+  /// event on the worker, which binds the stream's buffer to the worker.
   ///
-  /// @param       UNUSED Unused argument.
-  /// @param            n The number of features to log.
   /// @param           id The event id.
+  /// @param            n The number of features to log.
   /// @param         args The features to log.
-  void vappend(int UNUSED, int n, int event_id, va_list& vargs) {
-    const int worker_id = self->getId();
-    logtable_t *log = &here->logs[worker_id][event_id];
-    dbg_assert(log);
-    uint64_t time = hpx_time_from_start_ns(hpx_time_now());
-    char *next = log->next + log->record_bytes;
-    dbg_assert(next >= log->buffer);
-    if ((size_t)(next - log->buffer) > log->max_size) {
-      EVENT_TRACE_FILE_IO_BEGIN();
-      write(log->fd, log->buffer, log->next - log->buffer);
-      EVENT_TRACE_FILE_IO_END();
-      next = log->buffer;
+  void record(int id, int n, const uint64_t args[]) {
+    Stream* stream = streams_[self->getId()];
+    if (!stream) {
+      return;
     }
-    log->next = next;
-
-    record_t *r = (record_t*)next;
-    r->ns = time;
-    for (int i = 0, e = n; i < e; ++i) {
-      r->user[i] = va_arg(vargs, uint64_t);
+    libhpx_trace_buffer = stream->buffer();
+    if (stream->append(id, n, args)) {
+      wake();
     }
   }
 
   void start(void) {
-    // Allocate memory for pointers to the logs
     const unsigned nworkers = here->sched->getNWorkers();
-    here->logs = new logtable_t*[nworkers];
+    const size_t bytes = std::max(here->config->trace_buffersize,
+                                  MIN_BUFFER_BYTES);
+    streams_.resize(nworkers, nullptr);
     for (unsigned w = 0; w < nworkers; ++w) {
-      const size_t size = sizeof(logtable_t) * TRACE_NUM_EVENTS;
-      if (posix_memalign((void**)&here->logs[w], HPX_CACHELINE_SIZE, size)) {
-        dbg_error("could not allocate aligned buffer\n");
-      }
-      memset(here->logs[w], 0, size);
-      // Scan through each trace event and create logs for the associated
-      // events that that we are going to be tracing.
-      for (unsigned i = 0; i < TRACE_NUM_EVENTS; ++i) {
-        int c = TRACE_EVENT_TO_CLASS[i];
-        if (inst_trace_class(c)) {
-          _create_logtable(w, c, i, here->config->trace_buffersize);
-        }
-      }
+      streams_[w] = openStream(w, bytes);
     }
+    writer_ = std::thread(&FileTracer::run, this);
 
     // If we're tracing parcels then we need to output the actions and the
     // hostnames as well. The "_dump" actions won't do anything if we're not
@@ -364,24 +297,105 @@ class FileTracer : public Trace {
   }
 
   void destroy(void) {
+    if (writer_.joinable()) {
+      {
+        std::lock_guard<std::mutex> _(lock_);
+        stop_ = true;
+      }
+      wake_.notify_one();
+      writer_.join();
+    }
+
+    for (unsigned w = 0, e = streams_.size(); w < e; ++w) {
+      if (Stream* stream = streams_[w]) {
+        if (uint64_t dropped = stream->dropped()) {
+          log_dflt("trace: worker %u dropped %" PRIu64 " records\n", w,
+                   dropped);
+        }
+        stream->finish();
+        stream->~Stream();
+        free(stream);
+      }
+    }
+    streams_.clear();
+
+    if (inst_trace_class(HPX_TRACE_PARCEL)) {
+      _dump_profile();
+    }
+
     if (_log_path) {
       free((char*)_log_path);
       _log_path = NULL;
     }
+  }
+
+ private:
+  /// Create the stream for worker @p w and write its header.
+  static Stream* openStream(int w, size_t bytes) {
+    char filename[256];
+    snprintf(filename, 256, "%05d.%03d.trace", hpx_get_my_rank(), w);
+    char *path = _concat_path(_log_path, filename);
+    int fd = _create_file(path, bytes);
+    free(path);
+    if (fd == -1) {
+      return nullptr;
+    }
+
+    char *header = static_cast<char*>(calloc(1, TRACE_NUM_EVENTS * 1024));
+    size_t n = write_stream_header(header, w);
+    struct iovec iov = { header, n };
+    if (!WriteAll(fd, &iov, 1)) {
+      log_error("failed to write header to file\n");
+    }
+    free(header);
 
-    if (here->logs) {
-      for (int w = 0; w < here->sched->getNWorkers(); ++w) {
-        // deallocate the log tables
-        for (unsigned i = 0, e = TRACE_NUM_EVENTS; i < e; ++i) {
-          logtable_fini(&here->logs[w][i]);
+    // Each stream gets its own cachelines, since the worker updates it on
+    // every append.
+    void *buffer = nullptr;
+    if (posix_memalign(&buffer, HPX_CACHELINE_SIZE, sizeof(Stream))) {
+      dbg_error("could not allocate aligned buffer\n");
+    }
+    return new(buffer) Stream(fd, bytes);
+  }
+
+  /// Tell the writer that there is a full half to drain.
+  ///
+  /// Workers don't take the lock, so a notification can race with the writer
+  /// going to sleep. The writer's timeout bounds the delay in that case.
+  void wake() {
+    if (!pending_.exchange(true, RELEASE)) {
+      wake_.notify_one();
+    }
+  }
+
+  /// The writer thread.
+  void run() {
+    sigset_t set;
+    sigfillset(&set);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!stop_) {
+      wake_.wait_for(lock, std::chrono::milliseconds(10), [this] {
+          return stop_ || pending_.load(ACQUIRE);
+        });
+      pending_.store(false, RELAXED);
+      lock.unlock();
+      for (Stream* stream : streams_) {
+        if (stream) {
+          stream->drain();
         }
-        free(here->logs[w]);
-        here->logs[w] = nullptr;
       }
-      delete[] here->logs;
-      here->logs = nullptr;
+      lock.lock();
     }
   }
+
+  std::vector<Stream*>     streams_;
+  std::thread               writer_;
+  std::mutex                  lock_;
+  std::condition_variable     wake_;
+  std::atomic<bool>        pending_;
+  bool                        stop_;
 };
 }
 
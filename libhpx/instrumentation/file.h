@@ -21,6 +21,9 @@ extern "C" {
 // Output the header for the trace file.
 size_t write_trace_header(void *base, int type, int event_id, int worker_id);
 
+// Output the header for a worker's trace stream.
+size_t write_stream_header(void *base, int worker_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,10 +15,12 @@
 # include "config.h"
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <hpx/hpx.h>
+#include <libhpx/time.h>
 #include "metadata.h"
 #include "file.h"
 
@@ -46,6 +48,19 @@ typedef struct _cols_metadata {
 
 static logtable_header_t LOGTABLE_HEADER = _LOGTABLE_HEADER;
 
+/// The header of a per-worker trace stream.
+///
+/// The header data is a python dictionary literal with the constants for the
+/// stream and a numpy header dictionary for each event that may appear in it,
+/// keyed by event id.
+typedef struct {
+  char magic_number[6];
+  unsigned char major;
+  unsigned char minor;
+  uint32_t header_len;
+  char header_data[];
+} logstream_header_t;
+
 //based on : http://cs-fundamentals.com/tech-interview/c/c-program-to-check-little-and-big-endian-architecture.php
 const char* endian_flag()
 {
@@ -134,3 +149,54 @@ size_t write_trace_header(void* base, int type, int event_id, int worker_id) {
   int header_len = offsetof(logtable_header_t, header_data) + metadata_size;
   return header_len;
 }
+
+// Write the header of a worker's trace stream, describing every event in a
+// class that we're tracing.
+size_t write_stream_header(void* base, int worker_id) {
+  logstream_header_t *header = (logstream_header_t*)base;
+  memcpy(header->magic_number, "HPXtrc", sizeof(header->magic_number));
+  header->major = 1;
+  header->minor = 0;
+
+  char part_buffer[256];
+  char *data = header->header_data;
+  size_t written = 0;
+  snprintf(part_buffer, sizeof(part_buffer), "{'consts': {'rank': (%d, 'i4'), "
+           "'worker': (%d, 'i4')}, 'clock': {'tsc': %d, 'ticks_per_ns': %.9f}, "
+           "'events': {", hpx_get_my_rank(), worker_id, libhpx_trace_clock.tsc,
+           libhpx_trace_clock.ticks_per_ns);
+  written += cat(data, part_buffer);
+
+  for (unsigned i = 0, e = TRACE_NUM_EVENTS; i < e; ++i) {
+    int type = TRACE_EVENT_TO_CLASS[i];
+    if (!inst_trace_class(type)) {
+      continue;
+    }
+
+    inst_named_value_t class_md = { (unsigned)type, {"i4"}, {"class"} };
+    inst_named_value_t    id_md = { i, {"i4"}, {"event"} };
+    inst_named_value_t named_values[] = { class_md, id_md };
+    snprintf(part_buffer, sizeof(part_buffer), "%u: ", i);
+    written += cat(data, part_buffer);
+    written += write_header_dict(data + written, &INST_EVENT_METADATA[i],
+                                 named_values, 2);
+    written += cat(data, ", ");
+  }
+
+  // Name the events, so that tools don't depend on the event numbering.
+  written += cat(data, "}, 'names': {");
+  for (unsigned i = 0, e = TRACE_NUM_EVENTS; i < e; ++i) {
+    if (inst_trace_class(TRACE_EVENT_TO_CLASS[i])) {
+      snprintf(part_buffer, sizeof(part_buffer), "%u: '%s', ", i,
+               TRACE_EVENT_TO_STRING[i]);
+      written += cat(data, part_buffer);
+    }
+  }
+  written += cat(data, "}}\n");
+
+  // Pad the header so that the first record is 16 byte aligned.
+  size_t offset = offsetof(logstream_header_t, header_data);
+  written += 16 - ((offset + written) % 16);
+  header->header_len = written;
+  return offset + written;
+}
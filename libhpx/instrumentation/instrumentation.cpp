@@ -15,6 +15,7 @@
 # include "config.h"
 #endif
 
+#include "Counters.h"
 #include "Trace.h"
 
 #include <errno.h>
@@ -42,10 +43,56 @@
 
 namespace {
 using libhpx::instrumentation::Trace;
-constexpr auto RELAXED = std::memory_order_relaxed;
 }
 
-Trace::Trace(const config_t* cfg) : active(!cfg->trace_off) {
+/// Every event emitter reads the class mask, and it's rarely written, so it
+/// starts its own cacheline.
+HPX_ALIGNED(HPX_CACHELINE_SIZE) uint64_t libhpx_trace_mask = 0;
+
+static void _set_mask(uint64_t mask) {
+  __atomic_store_n(&libhpx_trace_mask, mask, __ATOMIC_RELAXED);
+}
+
+__thread trace_buffer_t *libhpx_trace_buffer = NULL;
+
+uint32_t libhpx_trace_sample = 0;
+__thread uint64_t libhpx_trace_filter = UINT64_MAX;
+
+namespace {
+__thread unsigned _sample_seed;
+
+/// Parse the --hpx-trace-sample period, either "1/N" or "N".
+uint32_t
+_parse_sample(const char *sample)
+{
+  if (!sample) {
+    return 0;
+  }
+  const char *n = strchr(sample, '/');
+  unsigned long period = strtoul((n) ? n + 1 : sample, NULL, 10);
+  if ((n && strtoul(sample, NULL, 10) != 1) || !period || period > RAND_MAX) {
+    log_error("invalid --hpx-trace-sample=%s, expected 1/N\n", sample);
+    return 0;
+  }
+  return (period > 1) ? period : 0;
+}
+}
+
+uint16_t
+trace_sample_root(void)
+{
+  if (!libhpx_trace_sample) {
+    return 1;
+  }
+  if (unlikely(!_sample_seed)) {
+    uintptr_t local = reinterpret_cast<uintptr_t>(&_sample_seed);
+    _sample_seed = (here->rank + 1) * 2654435761u ^ unsigned(local >> 4);
+  }
+  return (rand_r(&_sample_seed) % libhpx_trace_sample) == 0;
+}
+
+Trace::Trace(const config_t* cfg)
+    : classes(cfg->trace_classes), active(!cfg->trace_off) {
 }
 
 Trace::~Trace() {
@@ -56,24 +103,30 @@ trace_start(void* obj)
 {
   if (auto trace = static_cast<Trace*>(obj)) {
     trace->start();
+    if (trace->active) {
+      _set_mask(trace->classes);
+    }
   }
 }
 
 void
 trace_destroy(void* obj)
 {
+  _set_mask(0);
+  libhpx_trace_sample = 0;
   if (auto trace = static_cast<Trace*>(obj)) {
     trace->destroy();
   }
 }
 
 void
-trace_vappend(void* obj, int UNUSED, int n, int id, ...)
+trace_record_slow(int id, int n, const uint64_t args[])
 {
-  va_list vargs;
-  va_start(vargs, id);
-  static_cast<Trace*>(obj)->vappend(UNUSED, n, id, vargs);
-  va_end(vargs);
+  // Events can be raised outside of the workers, e.g., during startup.
+  if (!here || !here->tracer || !libhpx::self) {
+    return;
+  }
+  static_cast<Trace*>(here->tracer)->record(id, n, args);
 }
 
 void* trace_new(const config_t *cfg) {
@@ -86,6 +139,8 @@ void* trace_new(const config_t *cfg) {
     return NULL;
   }
 
+  libhpx_trace_sample = _parse_sample(cfg->trace_sample);
+
   libhpx_trace_backend_t type = cfg->trace_backend;
   if (type == HPX_TRACE_BACKEND_DEFAULT || type == HPX_TRACE_BACKEND_FILE) {
     return trace_file_new(cfg);
@@ -101,42 +156,35 @@ void* trace_new(const config_t *cfg) {
 
 void libhpx_inst_phase_begin() {
   if (auto trace = static_cast<Trace*>(here->tracer)) {
-    trace->active.store(true, RELAXED);
+    _set_mask(trace->classes);
   }
 }
 
 void libhpx_inst_phase_end() {
-  if (auto trace = static_cast<Trace*>(here->tracer)) {
-    trace->active.store(false, RELAXED);
-  }
+  _set_mask(0);
 }
 
 bool libhpx_inst_tracer_active() {
   dbg_assert(here && here->tracer);
-  auto trace = static_cast<Trace*>(here->tracer);
-  return trace->active.load(RELAXED);
+  return (__atomic_load_n(&libhpx_trace_mask, __ATOMIC_RELAXED) != 0);
 }
 
-int inst_check_vappend(int id, ...) {
-  if (!here) {
-    return 0;
-  }
-
-  if (!here->tracer) {
-    return 0;
+int
+libhpx::instrumentation::Dump(const char* filename, const char* what,
+                              void (*dump)(FILE*))
+{
+  FILE *f = (filename) ? fopen(filename, "w") : stdout;
+  if (!f) {
+    return log_error("failed to open %s file %s\n", what, filename);
   }
 
-  if (!libhpx::self) {
-    return 0;
-  }
+  dump(f);
 
-  if (!libhpx_inst_tracer_active()) {
-    return 0;
+  if (filename) {
+    fclose(f);
   }
-
-  if (!inst_trace_class(TRACE_EVENT_TO_CLASS[id])) {
-    return 0;
+  else {
+    fflush(f);
   }
-
-  return 1;
+  return HPX_SUCCESS;
 }
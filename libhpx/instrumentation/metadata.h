@@ -29,6 +29,18 @@ typedef struct record {
   uint64_t user[];
 } record_t;
 
+/// The prefix of each record in a trace stream.
+///
+/// A stream interleaves the records for all of the events traced by a worker,
+/// so each record is tagged with its event and its size.
+typedef struct stream_record {
+  uint32_t event;                     //!< the event id, or TRACE_DROPPED
+  uint32_t bytes;                     //!< the size of the record that follows
+} stream_record_t;
+
+/// The event id of a record that counts the records dropped before it.
+#define TRACE_DROPPED UINT32_MAX
+
 // Type options currently used.  A full list is the keys of numpy.sctypeDict
 typedef struct inst_type_info {
   char  code[3];
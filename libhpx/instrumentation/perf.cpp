@@ -0,0 +1,264 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+/// @file libhpx/instrumentation/perf.cpp
+/// @brief Hardware performance counters through perf_event_open(2).
+///
+/// Each worker opens its counters as a single group, for the calling thread on
+/// any cpu, so that one read(2) returns all of them and they're always
+/// scheduled onto the PMU together.
+
+#include "libhpx/perf.h"
+#include "libhpx/debug.h"
+#include <hpx/hpx.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+#ifdef __linux__
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+#endif
+
+unsigned libhpx_perf_counters = 0;
+
+namespace {
+/// The counters that --hpx-trace-counters knows about.
+struct Event {
+  const char *name;
+  uint32_t    type;
+  uint64_t  config;
+};
+
+/// One worker's counter group, on its own cachelines.
+struct alignas(HPX_CACHELINE_SIZE) Group {
+  int             fds[PERF_MAX_COUNTERS];       //!< fds[0] leads the group
+  uint64_t       last[PERF_MAX_COUNTERS];       //!< worker-private
+  uint64_t      total[PERF_MAX_COUNTERS];
+};
+
+const Event* _events[PERF_MAX_COUNTERS];
+Group* _groups;
+unsigned _nworkers;
+}
+
+const char *
+perf_counter_name(unsigned i)
+{
+  dbg_assert(i < libhpx_perf_counters);
+  return _events[i]->name;
+}
+
+uint64_t
+perf_total(int w, unsigned i)
+{
+  return __atomic_load_n(&_groups[w].total[i], __ATOMIC_RELAXED);
+}
+
+#ifdef ENABLE_INSTRUMENTATION
+namespace {
+#ifdef __linux__
+const Event EVENTS[] = {
+  { "cycles",           PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { "instructions",     PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { "llc-misses",       PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+  { "llc-references",   PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+  { "branch-misses",    PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { "branches",         PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+  { "stalled-cycles",   PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND },
+  { "page-faults",      PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+  { "task-clock",       PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK }
+};
+
+/// Open a counter for the calling thread.
+int
+Open(const Event* e, int leader)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = e->type;
+  attr.config = e->config;
+  attr.disabled = (leader < 0);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+const Event*
+Find(const std::string& name)
+{
+  for (const Event& e : EVENTS) {
+    if (name == e.name) {
+      return &e;
+    }
+  }
+  return nullptr;
+}
+
+/// Parse the comma-separated counter names, and keep the ones that we can open.
+unsigned
+Parse(const char *names)
+{
+  unsigned n = 0;
+  std::string list(names);
+  for (size_t i = 0, e; i <= list.size(); i = e + 1) {
+    e = list.find(',', i);
+    e = (e == std::string::npos) ? list.size() : e;
+    std::string name = list.substr(i, e - i);
+    if (name.empty()) {
+      continue;
+    }
+
+    const Event* event = Find(name);
+    if (!event) {
+      log_error("unknown hardware counter %s\n", name.c_str());
+      continue;
+    }
+    if (n == PERF_MAX_COUNTERS) {
+      log_error("at most %d hardware counters, ignoring %s\n",
+                PERF_MAX_COUNTERS, name.c_str());
+      continue;
+    }
+
+    int fd = Open(event, -1);
+    if (fd < 0) {
+      log_error("hardware counter %s is not available (%s)\n", name.c_str(),
+                strerror(errno));
+      continue;
+    }
+    close(fd);
+    _events[n++] = event;
+  }
+  return n;
+}
+#else
+unsigned
+Parse(const char *names)
+{
+  log_error("hardware counters require Linux perf events\n");
+  return 0;
+}
+#endif
+}
+
+void
+perf_init(const config_t *cfg, unsigned workers)
+{
+  if (!cfg->trace_counters) {
+    return;
+  }
+
+  unsigned n = Parse(cfg->trace_counters);
+  if (!n) {
+    return;
+  }
+
+  size_t bytes = workers * sizeof(Group);
+  if (posix_memalign((void**)&_groups, HPX_CACHELINE_SIZE, bytes)) {
+    dbg_error("could not allocate hardware counter groups\n");
+  }
+  memset(_groups, 0, bytes);
+  for (unsigned w = 0; w < workers; ++w) {
+    for (unsigned i = 0; i < PERF_MAX_COUNTERS; ++i) {
+      _groups[w].fds[i] = -1;
+    }
+  }
+  _nworkers = workers;
+  libhpx_perf_counters = n;
+}
+
+void
+perf_fini(void)
+{
+  libhpx_perf_counters = 0;
+  free(_groups);
+  _groups = nullptr;
+  _nworkers = 0;
+}
+
+void
+perf_thread_init(int w)
+{
+#ifdef __linux__
+  if (!libhpx_perf_counters) {
+    return;
+  }
+
+  dbg_assert(0 <= w && unsigned(w) < _nworkers);
+  Group& g = _groups[w];
+  for (unsigned i = 0; i < libhpx_perf_counters; ++i) {
+    g.fds[i] = Open(_events[i], g.fds[0]);
+    if (g.fds[i] < 0) {
+      log_error("worker %d could not open hardware counter %s (%s)\n", w,
+                _events[i]->name, strerror(errno));
+      perf_thread_fini(w);
+      return;
+    }
+  }
+
+  ioctl(g.fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(g.fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  uint64_t delta[PERF_MAX_COUNTERS];
+  perf_sample(w, delta);
+#endif
+}
+
+void
+perf_thread_fini(int w)
+{
+  if (!_groups) {
+    return;
+  }
+
+  Group& g = _groups[w];
+  for (unsigned i = 0; i < PERF_MAX_COUNTERS; ++i) {
+    if (g.fds[i] >= 0) {
+      close(g.fds[i]);
+      g.fds[i] = -1;
+    }
+  }
+}
+
+bool
+perf_sample(int w, uint64_t delta[PERF_MAX_COUNTERS])
+{
+  Group& g = _groups[w];
+  if (g.fds[0] < 0) {
+    return false;
+  }
+
+  // The group read returns the number of counters followed by their values.
+  const unsigned n = libhpx_perf_counters;
+  uint64_t values[PERF_MAX_COUNTERS + 1];
+  ssize_t bytes = (n + 1) * sizeof(values[0]);
+  if (read(g.fds[0], values, bytes) != bytes) {
+    return false;
+  }
+
+  for (unsigned i = 0; i < n; ++i) {
+    delta[i] = values[i + 1] - g.last[i];
+    g.last[i] = values[i + 1];
+    __atomic_store_n(&g.total[i], g.total[i] + delta[i], __ATOMIC_RELAXED);
+  }
+  return true;
+}
+#endif
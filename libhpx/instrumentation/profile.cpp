@@ -0,0 +1,282 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+/// @file libhpx/instrumentation/profile.cpp
+/// @brief Per-action execution profiles.
+///
+/// Each worker has a row of profiles, one per action, that are allocated the
+/// first time that the worker runs the action. Only the worker writes to its
+/// profiles (see Counters.h), and hpx_profile_dump() merges them while they're
+/// live.
+
+#include "Counters.h"
+#include "libhpx/profile.h"
+#include "libhpx/action.h"
+#include "libhpx/debug.h"
+#include "libhpx/locality.h"
+#include "libhpx/perf.h"
+#include <hpx/hpx.h>
+#include <atomic>
+#include <cinttypes>
+#include <cstring>
+
+#ifdef ENABLE_INSTRUMENTATION
+namespace {
+using libhpx::instrumentation::Bump;
+using libhpx::instrumentation::Read;
+
+/// Each power of two is split into 2^SUB_BITS buckets, so a bucket's bounds
+/// are within 12.5% of the values in it. Values below 2^(SUB_BITS + 1) have
+/// their own buckets, and values at or above 2^MAX_BITS are clamped.
+/// @{
+constexpr unsigned SUB_BITS = 3;
+constexpr unsigned SUB = 1u << SUB_BITS;
+constexpr unsigned MAX_BITS = 48;
+constexpr unsigned BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB;
+/// @}
+
+unsigned
+Bucket(uint64_t v)
+{
+  constexpr uint64_t MAX = (UINT64_C(1) << MAX_BITS) - 1;
+  v = (v < MAX) ? v : MAX;
+  if (v < SUB) {
+    return v;
+  }
+  unsigned e = 63 - __builtin_clzll(v);
+  return (e - SUB_BITS + 1) * SUB + ((v >> (e - SUB_BITS)) & (SUB - 1));
+}
+
+/// The largest value that falls in bucket @p b.
+uint64_t
+BucketMax(unsigned b)
+{
+  if (b < SUB) {
+    return b;
+  }
+  unsigned shift = b / SUB - 1;
+  uint64_t low = uint64_t(SUB + b % SUB) << shift;
+  return low + (UINT64_C(1) << shift) - 1;
+}
+
+struct Histogram {
+  uint64_t             sum;
+  uint64_t             max;
+  uint64_t counts[BUCKETS];
+
+  void add(uint64_t v) {
+    Bump(counts[Bucket(v)]);
+    Bump(sum, v);
+    if (max < v) {
+      __atomic_store_n(&max, v, __ATOMIC_RELAXED);
+    }
+  }
+
+  void merge(const Histogram& rhs) {
+    sum += Read(rhs.sum);
+    uint64_t m = Read(rhs.max);
+    max = (max < m) ? m : max;
+    for (unsigned b = 0; b < BUCKETS; ++b) {
+      counts[b] += Read(rhs.counts[b]);
+    }
+  }
+
+  uint64_t count() const {
+    uint64_t n = 0;
+    for (unsigned b = 0; b < BUCKETS; ++b) {
+      n += counts[b];
+    }
+    return n;
+  }
+
+  /// The upper bound of the bucket containing quantile @p q.
+  uint64_t quantile(double q, uint64_t n) const {
+    uint64_t rank = uint64_t(q * n);
+    uint64_t i = 0;
+    for (unsigned b = 0; b < BUCKETS; ++b) {
+      i += counts[b];
+      if (i > rank) {
+        return BucketMax(b);
+      }
+    }
+    return max;
+  }
+};
+
+/// The profile for one action at one worker.
+struct Profile {
+  Histogram  exec;                              //!< trace clock ticks
+  Histogram queue;                              //!< trace clock ticks
+  Histogram bytes;
+  uint64_t counters[PERF_MAX_COUNTERS];         //!< hardware counter sums
+};
+
+/// The profile table, a row of nactions per worker.
+/// @{
+std::atomic<Profile*>* _table;
+unsigned _nworkers;
+unsigned _nactions;
+hpx_time_t _start;
+/// @}
+
+Profile*
+Get(int w, hpx_action_t action)
+{
+  dbg_assert(action < _nactions);
+  std::atomic<Profile*>& slot = _table[w * _nactions + action];
+  Profile* p = slot.load(std::memory_order_relaxed);
+  if (unlikely(!p)) {
+    p = new Profile();
+    slot.store(p, std::memory_order_release);
+  }
+  return p;
+}
+
+/// Print a row for a merged histogram, if it has any samples.
+void
+Print(FILE* f, int id, const char* metric, const Histogram& h, double scale,
+      double seconds)
+{
+  uint64_t n = h.count();
+  if (!n) {
+    return;
+  }
+
+  fprintf(f, "%d,%d,%s,%s,%" PRIu64 ",%.1f,%.1f,%.1f,%.1f,%.1f,%.3f\n",
+          here->rank, id, actions[id].key, metric, n,
+          h.sum / scale / n,
+          h.quantile(0.50, n) / scale,
+          h.quantile(0.90, n) / scale,
+          h.quantile(0.99, n) / scale,
+          h.max / scale,
+          n / seconds);
+}
+
+/// Print the mean of a hardware counter over @p runs, which only has a sum.
+void
+PrintCounter(FILE* f, int id, const char* metric, uint64_t sum, uint64_t runs,
+             double seconds)
+{
+  if (!runs) {
+    return;
+  }
+
+  fprintf(f, "%d,%d,%s,%s,%" PRIu64 ",%.1f,,,,,%.3f\n", here->rank, id,
+          actions[id].key, metric, runs, double(sum) / runs, runs / seconds);
+}
+}
+
+void
+profile_init(unsigned workers)
+{
+  _nworkers = workers;
+  _nactions = action_table_size();
+  _table = new std::atomic<Profile*>[workers * _nactions]();
+  _start = hpx_time_now();
+}
+
+void
+profile_fini(void)
+{
+  for (unsigned i = 0, e = _nworkers * _nactions; i < e; ++i) {
+    delete _table[i].load(std::memory_order_relaxed);
+  }
+  delete [] _table;
+  _table = nullptr;
+}
+
+void
+profile_run(int w, hpx_parcel_t *p)
+{
+  uint64_t now = libhpx_trace_time();
+  Profile* profile = Get(w, p->action);
+  if (p->stamp && p->stamp <= now) {
+    profile->queue.add(now - p->stamp);
+  }
+  profile->bytes.add(p->size);
+  p->stamp = now;
+}
+
+void
+profile_end(int w, hpx_parcel_t *p)
+{
+  uint64_t now = libhpx_trace_time();
+  Get(w, p->action)->exec.add(now - p->stamp);
+
+  // A resent parcel is runnable again.
+  p->stamp = now;
+}
+
+void
+profile_counters(int w, hpx_parcel_t *p)
+{
+  uint64_t delta[PERF_MAX_COUNTERS];
+  if (!perf_sample(w, delta) || !p || !_table) {
+    return;
+  }
+
+  Profile* profile = Get(w, p->action);
+  for (unsigned i = 0; i < libhpx_perf_counters; ++i) {
+    Bump(profile->counters[i], delta[i]);
+  }
+}
+
+#endif
+
+void
+profile_dump(FILE *f)
+{
+  fprintf(f, "rank,id,action,metric,count,mean,p50,p90,p99,max,per_second\n");
+#ifdef ENABLE_INSTRUMENTATION
+  if (!_table) {
+    return;
+  }
+
+  double seconds = hpx_time_elapsed_ms(_start) / 1e3;
+  double ns = libhpx_trace_clock.ticks_per_ns;
+  Profile* merged = new Profile();
+  for (unsigned a = 1; a < _nactions; ++a) {
+    memset(merged, 0, sizeof(*merged));
+    for (unsigned w = 0; w < _nworkers; ++w) {
+      auto& slot = _table[w * _nactions + a];
+      if (Profile* p = slot.load(std::memory_order_acquire)) {
+        merged->exec.merge(p->exec);
+        merged->queue.merge(p->queue);
+        merged->bytes.merge(p->bytes);
+        for (unsigned i = 0; i < libhpx_perf_counters; ++i) {
+          merged->counters[i] += Read(p->counters[i]);
+        }
+      }
+    }
+
+    Print(f, a, "exec_ns", merged->exec, ns, seconds);
+    Print(f, a, "queue_ns", merged->queue, ns, seconds);
+    Print(f, a, "bytes", merged->bytes, 1.0, seconds);
+    for (unsigned i = 0; i < libhpx_perf_counters; ++i) {
+      PrintCounter(f, a, perf_counter_name(i), merged->counters[i],
+                   merged->exec.count(), seconds);
+    }
+  }
+  delete merged;
+#endif
+}
+
+int
+hpx_profile_dump(const char *filename)
+{
+  return libhpx::instrumentation::Dump(filename, "profile", profile_dump);
+}
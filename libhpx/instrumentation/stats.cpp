@@ -15,36 +15,116 @@
 # include "config.h"
 #endif
 
+/// @file libhpx/instrumentation/stats.cpp
+/// @brief The stats trace backend.
+///
+/// The stats backend counts events per worker, and prints the totals, along
+/// with the scheduler accounting (see accounting.h), when it is destroyed. If
+/// --hpx-trace-metrics is given then a background thread also publishes the
+/// counters, their rates, and a handful of derived scheduler and network
+/// gauges, once per period, as a Prometheus text file.
+/// The file is written next to the target path and renamed into place, so
+/// readers always see a complete snapshot.
+
+#include "Counters.h"
 #include "Trace.h"
 
+#include <chrono>
 #include <cinttypes>
-#include <fcntl.h>
-#include <inttypes.h>
-#include <pwd.h>
+#include <condition_variable>
+#include <mutex>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#include <unistd.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <sys/types.h>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <hpx/hpx.h>
+#include <libhpx/accounting.h>
+#include <libhpx/action.h>
 #include <libhpx/debug.h>
 #include <libhpx/libhpx.h>
+#include <libhpx/perf.h>
 #include <libhpx/Scheduler.h>
+#include <libhpx/time.h>
 #include "libhpx/Worker.h"
 #include "metadata.h"
 
 namespace {
 using libhpx::self;
 using libhpx::Worker;
+using libhpx::instrumentation::Bump;
+using libhpx::instrumentation::Read;
+using libhpx::instrumentation::Set;
 using libhpx::instrumentation::Trace;
 
+/// How often the metrics file is published.
+constexpr auto PERIOD = std::chrono::seconds(1);
+
+/// Allocate @p n zeroed, cacheline-aligned counters.
+uint64_t*
+Counts(size_t n)
+{
+  uint64_t* counts = nullptr;
+  const size_t size = sizeof(uint64_t) * n;
+  if (posix_memalign((void**)&counts, HPX_CACHELINE_SIZE, size)) {
+    dbg_error("could not allocate aligned buffer\n");
+  }
+  memset(counts, 0, size);
+  return counts;
+}
+
+/// The counters for one worker, on their own cachelines.
+struct Counters {
+  uint64_t       *events;                       //!< == here->stats[worker]
+  uint64_t         *runs;                       //!< PARCEL_RUN by action
+  uint64_t        wqsize;                       //!< last SCHED_WQSIZE
+  uint64_t         steal;                       //!< successful steals
+  uint64_t          mail;                       //!< mail in the last pass
+  uint64_t      progress;                       //!< trace ticks in progress
+  uint64_t      nextMail;                       //!< worker-private
+  uint64_t progressStart;                       //!< worker-private
+};
+
+/// The totals for one period, used to compute rates.
+struct Snapshot {
+  std::vector<uint64_t>   events;
+  std::vector<uint64_t>     runs;
+  std::vector<uint64_t>   steals;               //!< attempts by worker
+  std::vector<uint64_t>     hits;               //!< successes by worker
+  std::vector<uint64_t> progress;               //!< ticks by worker
+  std::vector<uint64_t>  perf;                  //!< hardware counters by worker
+  std::vector<uint64_t>  states;                //!< state ticks by worker
+  hpx_time_t                time;
+};
+
+/// Print a label value, escaping it as the text format requires.
+void
+PrintLabel(FILE* f, const char* value)
+{
+  for (const char* c = value; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', f);
+    }
+    fputc((*c == '\n') ? ' ' : *c, f);
+  }
+}
+
 class StatsTracer : public Trace {
  public:
-  StatsTracer(const config_t* cfg) : Trace(cfg) {
+  StatsTracer(const config_t* cfg)
+      : Trace(cfg),
+        path_((cfg->trace_metrics) ? cfg->trace_metrics : ""),
+        counters_(),
+        nactions_(0),
+        exporter_(),
+        lock_(),
+        wake_(),
+        stop_(false),
+        prev_()
+  {
   }
 
   ~StatsTracer() {
@@ -54,24 +134,74 @@ class StatsTracer : public Trace {
   //   return HPX_TRACE_BACKEND_STATS;
   // }
 
-  void vappend(int UNUSED, int n, int event_id, va_list&) {
-    int worker_id = self->getId();
-    here->stats[worker_id][event_id]++;
+  void record(int event_id, int, const uint64_t args[]) {
+    Counters& c = *counters_[self->getId()];
+    Bump(c.events[event_id]);
+    switch (event_id) {
+     case TRACE_EVENT_PARCEL_RUN:
+      if (args[1] < nactions_) {
+        Bump(c.runs[args[1]]);
+      }
+      return;
+     case TRACE_EVENT_SCHED_WQSIZE:
+      Set(c.wqsize, args[0]);
+      return;
+     case TRACE_EVENT_SCHED_STEAL:
+      Bump(c.steal, args[0] != 0);
+      return;
+     case TRACE_EVENT_SCHED_MAIL:
+      ++c.nextMail;
+      return;
+     case TRACE_EVENT_SCHED_END:
+      Set(c.mail, c.nextMail);
+      c.nextMail = 0;
+      return;
+     case TRACE_EVENT_NETWORK_PROGRESS_BEGIN:
+      c.progressStart = libhpx_trace_time();
+      return;
+     case TRACE_EVENT_NETWORK_PROGRESS_END:
+      Bump(c.progress, libhpx_trace_time() - c.progressStart);
+      return;
+    }
   }
 
   void start(void) {
     const unsigned nworkers = here->sched->getNWorkers();
+    nactions_ = action_table_size();
     here->stats = new uint64_t*[nworkers];
+    counters_.resize(nworkers);
     for (unsigned w = 0; w < nworkers; ++w) {
-      const size_t size = sizeof(uint64_t) * TRACE_NUM_EVENTS;
-      if (posix_memalign((void**)&here->stats[w], HPX_CACHELINE_SIZE, size)) {
+      Counters* c = nullptr;
+      if (posix_memalign((void**)&c, HPX_CACHELINE_SIZE, sizeof(*c))) {
         dbg_error("could not allocate aligned buffer\n");
       }
-      memset(here->stats[w], 0, size);
+      memset(c, 0, sizeof(*c));
+      c->events = Counts(TRACE_NUM_EVENTS);
+      c->runs = Counts(nactions_);
+      here->stats[w] = c->events;
+      counters_[w] = c;
+    }
+
+    if (!path_.empty()) {
+      if (here->ranks > 1) {
+        path_ += "." + std::to_string(here->rank);
+      }
+      prev_ = snapshot();
+      exporter_ = std::thread(&StatsTracer::run, this);
     }
   }
 
   void destroy(void) {
+    if (exporter_.joinable()) {
+      {
+        std::lock_guard<std::mutex> _(lock_);
+        stop_ = true;
+      }
+      wake_.notify_one();
+      exporter_.join();
+      publish();
+    }
+
     for (int k = 1; k < HPX_THREADS; ++k) {
       for (unsigned i = 0; i < TRACE_NUM_EVENTS; ++i) {
         int c = TRACE_EVENT_TO_CLASS[i];
@@ -92,11 +222,298 @@ class StatsTracer : public Trace {
                here->stats[0][i]);
       }
     }
+    for (unsigned i = 0; i < libhpx_perf_counters; ++i) {
+      uint64_t total = 0;
+      for (unsigned w = 0, e = counters_.size(); w < e; ++w) {
+        total += perf_total(w, i);
+      }
+      printf("%d,%s,%" PRIu64 "\n", here->rank, perf_counter_name(i), total);
+    }
+    printAccounting();
+
     free(here->stats[0]);
     here->stats[0] = nullptr;
     delete[] here->stats;
     here->stats = nullptr;
+
+    for (Counters* c : counters_) {
+      free(c->runs);
+      free(c);
+    }
+    counters_.clear();
+  }
+
+ private:
+  /// The exporter thread.
+  void run() {
+    sigset_t set;
+    sigfillset(&set);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!wake_.wait_for(lock, PERIOD, [this] { return stop_; })) {
+      lock.unlock();
+      publish();
+      lock.lock();
+    }
+  }
+
+  /// Read the workers' counters.
+  Snapshot snapshot() const {
+    const unsigned nworkers = counters_.size();
+    Snapshot s;
+    s.events.assign(TRACE_NUM_EVENTS, 0);
+    s.runs.assign(nactions_, 0);
+    s.steals.assign(nworkers, 0);
+    s.hits.assign(nworkers, 0);
+    s.progress.assign(nworkers, 0);
+    s.perf.assign(nworkers * PERF_MAX_COUNTERS, 0);
+    s.states.assign(nworkers * ACCOUNTING_STATES, 0);
+    s.time = hpx_time_now();
+    for (unsigned w = 0; w < nworkers; ++w) {
+      const Counters& c = *counters_[w];
+      for (unsigned i = 0; i < TRACE_NUM_EVENTS; ++i) {
+        s.events[i] += Read(c.events[i]);
+      }
+      for (unsigned i = 0; i < nactions_; ++i) {
+        s.runs[i] += Read(c.runs[i]);
+      }
+      s.steals[w] = Read(c.events[TRACE_EVENT_SCHED_STEAL]);
+      s.hits[w] = Read(c.steal);
+      s.progress[w] = Read(c.progress);
+      for (unsigned i = 0; i < libhpx_perf_counters; ++i) {
+        s.perf[w * PERF_MAX_COUNTERS + i] = perf_total(w, i);
+      }
+      if (w < accounting_workers()) {
+        for (int i = 0; i < ACCOUNTING_STATES; ++i) {
+          s.states[w * ACCOUNTING_STATES + i] = accounting_ticks(w, i);
+        }
+      }
+    }
+    return s;
   }
+
+  /// Write the current metrics, and their rates since the last call.
+  void publish() {
+    Snapshot s = snapshot();
+    double dt = hpx_time_diff_ms(prev_.time, s.time) / 1e3;
+    if (dt <= 0) {
+      dt = 1;
+    }
+
+    std::string tmp = path_ + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) {
+      log_error("failed to open metrics file %s\n", tmp.c_str());
+      return;
+    }
+
+    const int rank = here->rank;
+    fprintf(f, "# HELP hpx_events_total Trace events recorded.\n");
+    fprintf(f, "# TYPE hpx_events_total counter\n");
+    for (unsigned i = 0; i < TRACE_NUM_EVENTS; ++i) {
+      if (inst_trace_class(TRACE_EVENT_TO_CLASS[i])) {
+        fprintf(f, "hpx_events_total{rank=\"%d\",event=\"%s\"} %" PRIu64 "\n",
+                rank, TRACE_EVENT_TO_STRING[i], s.events[i]);
+      }
+    }
+
+    fprintf(f, "# HELP hpx_events_per_second Trace events per second.\n");
+    fprintf(f, "# TYPE hpx_events_per_second gauge\n");
+    for (unsigned i = 0; i < TRACE_NUM_EVENTS; ++i) {
+      if (inst_trace_class(TRACE_EVENT_TO_CLASS[i])) {
+        fprintf(f, "hpx_events_per_second{rank=\"%d\",event=\"%s\"} %.3f\n",
+                rank, TRACE_EVENT_TO_STRING[i],
+                (s.events[i] - prev_.events[i]) / dt);
+      }
+    }
+
+    if (inst_trace_class(HPX_TRACE_SCHED)) {
+      printWorkers(f, "hpx_deque_depth", "gauge",
+                   "Work queue size at the last pop.",
+                   [this](unsigned w) {
+                     return double(Read(counters_[w]->wqsize));
+                   });
+      printWorkers(f, "hpx_mailbox_depth", "gauge",
+                   "Parcels found in the mailbox by the last scheduling pass.",
+                   [this](unsigned w) {
+                     return double(Read(counters_[w]->mail));
+                   });
+      printWorkers(f, "hpx_steal_success_ratio", "gauge",
+                   "Fraction of steal attempts that found work.",
+                   [&](unsigned w) {
+                     uint64_t n = s.steals[w] - prev_.steals[w];
+                     return (n) ? double(s.hits[w] - prev_.hits[w]) / n : 0.0;
+                   });
+    }
+
+    if (inst_trace_class(HPX_TRACE_NETWORK)) {
+      const double ns = 1e9 * libhpx_trace_clock.ticks_per_ns;
+      printWorkers(f, "hpx_network_progress_seconds_total", "counter",
+                   "Time spent in network progress.",
+                   [&](unsigned w) {
+                     return s.progress[w] / ns;
+                   });
+      printWorkers(f, "hpx_network_progress_ratio", "gauge",
+                   "Fraction of time spent in network progress.",
+                   [&](unsigned w) {
+                     return (s.progress[w] - prev_.progress[w]) / ns / dt;
+                   });
+    }
+
+    if (inst_trace_class(HPX_TRACE_PARCEL)) {
+      fprintf(f, "# HELP hpx_parcels_per_second Parcels run per second.\n");
+      fprintf(f, "# TYPE hpx_parcels_per_second gauge\n");
+      for (unsigned i = 1; i < nactions_; ++i) {
+        if (s.runs[i]) {
+          fprintf(f, "hpx_parcels_per_second{rank=\"%d\",action=\"", rank);
+          PrintLabel(f, actions[i].key);
+          fprintf(f, "\"} %.3f\n", (s.runs[i] - prev_.runs[i]) / dt);
+        }
+      }
+    }
+
+    if (libhpx_perf_counters) {
+      fprintf(f, "# HELP hpx_hardware_events_total Hardware counter totals.\n");
+      fprintf(f, "# TYPE hpx_hardware_events_total counter\n");
+      printCounters(f, "hpx_hardware_events_total", [&](unsigned k) {
+          return double(s.perf[k]);
+        });
+      fprintf(f, "# HELP hpx_hardware_events_per_second Hardware counter rates.\n");
+      fprintf(f, "# TYPE hpx_hardware_events_per_second gauge\n");
+      printCounters(f, "hpx_hardware_events_per_second", [&](unsigned k) {
+          return (s.perf[k] - prev_.perf[k]) / dt;
+        });
+    }
+
+    if (accounting_workers()) {
+      const double ns = 1e9 * libhpx_trace_clock.ticks_per_ns;
+      printStates(f, "hpx_worker_seconds_total", "counter",
+                  "Time spent in each scheduler state.",
+                  [&](unsigned k) {
+                    return s.states[k] / ns;
+                  });
+      printStates(f, "hpx_worker_state_ratio", "gauge",
+                  "Fraction of time spent in each scheduler state.",
+                  [&](unsigned k) {
+                    return (s.states[k] - prev_.states[k]) / ns / dt;
+                  });
+      printWorkers(f, "hpx_worker_idle_seconds_total", "counter",
+                   "Time spent in scheduling passes that found no work.",
+                   [&](unsigned w) {
+                     return accounting_idle_ticks(w) / ns;
+                   });
+      printSteals(f, "hpx_steal_attempts_total",
+                  "Steal attempts by distance to the victim.",
+                  accounting_steal_attempts);
+      printSteals(f, "hpx_steal_hits_total",
+                  "Successful steals by distance to the victim.",
+                  accounting_steal_hits);
+    }
+
+    if (fclose(f) || rename(tmp.c_str(), path_.c_str())) {
+      log_error("failed to publish metrics to %s\n", path_.c_str());
+    }
+    prev_ = std::move(s);
+  }
+
+  /// Print one per-worker metric.
+  template <typename F>
+  void printWorkers(FILE* f, const char* name, const char* type,
+                    const char* help, F&& value) const {
+    fprintf(f, "# HELP %s %s\n", name, help);
+    fprintf(f, "# TYPE %s %s\n", name, type);
+    for (unsigned w = 0, e = counters_.size(); w < e; ++w) {
+      fprintf(f, "%s{rank=\"%d\",worker=\"%u\"} %.6g\n", name, here->rank, w,
+              value(w));
+    }
+  }
+
+  /// Print one metric for each worker's scheduler states.
+  template <typename F>
+  void printStates(FILE* f, const char* name, const char* type,
+                   const char* help, F&& value) const {
+    fprintf(f, "# HELP %s %s\n", name, help);
+    fprintf(f, "# TYPE %s %s\n", name, type);
+    for (unsigned w = 0, e = accounting_workers(); w < e; ++w) {
+      for (int i = 0; i < ACCOUNTING_STATES; ++i) {
+        fprintf(f, "%s{rank=\"%d\",worker=\"%u\",state=\"%s\"} %.6g\n",
+                name, here->rank, w, accounting_state_name(i),
+                value(w * ACCOUNTING_STATES + i));
+      }
+    }
+  }
+
+  /// Print one steal counter for each worker and distance.
+  void printSteals(FILE* f, const char* name, const char* help,
+                   uint64_t (*value)(int, int)) const {
+    fprintf(f, "# HELP %s %s\n", name, help);
+    fprintf(f, "# TYPE %s counter\n", name);
+    for (unsigned w = 0, e = accounting_workers(); w < e; ++w) {
+      for (int d = 0; d < ACCOUNTING_DISTANCES; ++d) {
+        fprintf(f, "%s{rank=\"%d\",worker=\"%u\",distance=\"%s\"} %" PRIu64
+                "\n", name, here->rank, w, accounting_distance_name(d),
+                value(w, d));
+      }
+    }
+  }
+
+  /// Print the scheduler accounting totals with the event totals.
+  void printAccounting() const {
+    const double ns = 1e9 * libhpx_trace_clock.ticks_per_ns;
+    const unsigned nworkers = accounting_workers();
+    if (!nworkers) {
+      return;
+    }
+
+    for (int i = 0; i < ACCOUNTING_STATES; ++i) {
+      uint64_t total = 0;
+      for (unsigned w = 0; w < nworkers; ++w) {
+        total += accounting_ticks(w, i);
+      }
+      printf("%d,sched_%s_seconds,%.6f\n", here->rank,
+             accounting_state_name(i), total / ns);
+    }
+
+    uint64_t idle = 0;
+    for (unsigned w = 0; w < nworkers; ++w) {
+      idle += accounting_idle_ticks(w);
+    }
+    printf("%d,sched_idle_seconds,%.6f\n", here->rank, idle / ns);
+
+    for (int d = 0; d < ACCOUNTING_DISTANCES; ++d) {
+      uint64_t attempts = 0, hits = 0;
+      for (unsigned w = 0; w < nworkers; ++w) {
+        attempts += accounting_steal_attempts(w, d);
+        hits += accounting_steal_hits(w, d);
+      }
+      printf("%d,sched_steal_attempts_%s,%" PRIu64 "\n", here->rank,
+             accounting_distance_name(d), attempts);
+      printf("%d,sched_steal_hits_%s,%" PRIu64 "\n", here->rank,
+             accounting_distance_name(d), hits);
+    }
+  }
+
+  /// Print one metric for each worker's hardware counters.
+  template <typename F>
+  void printCounters(FILE* f, const char* name, F&& value) const {
+    for (unsigned w = 0, e = counters_.size(); w < e; ++w) {
+      for (unsigned i = 0; i < libhpx_perf_counters; ++i) {
+        fprintf(f, "%s{rank=\"%d\",worker=\"%u\",counter=\"%s\"} %.6g\n",
+                name, here->rank, w, perf_counter_name(i),
+                value(w * PERF_MAX_COUNTERS + i));
+      }
+    }
+  }
+
+  std::string                 path_;
+  std::vector<Counters*>  counters_;
+  unsigned                nactions_;
+  std::thread             exporter_;
+  std::mutex                  lock_;
+  std::condition_variable     wake_;
+  bool                        stop_;
+  Snapshot                    prev_;            //!< only used by the exporter
 };
 }
 
@@ -103,7 +103,7 @@ CoalescingWrapper::send(unsigned n) {
   for (auto i = 0u, e = n; i < e; ++i) {
     auto p = sends_.dequeue();
     dbg_assert(p);
-    auto target = gas_.ownerOf(p->target);
+    auto target = gas_.owner(p->target);
     buffers[target].record(p);
   }
 
@@ -85,10 +85,11 @@ class ParcelMemget {
   void
   operator()(void *dest, hpx_addr_t from, size_t size, hpx_addr_t lsync)
   {
-    hpx_addr_t rsync = hpx_lco_future_new(0);
+    hpx_lco_waiter_t waiter;
+    hpx_addr_t rsync = hpx_lco_waiter_init(&waiter, 0, NULL);
     operator()(dest, from, size, lsync, rsync);
-    hpx_lco_wait(rsync);
-    hpx_lco_delete_sync(rsync);
+    hpx_lco_waiter_wait(&waiter);
+    hpx_lco_waiter_fini(&waiter);
   }
 
   void
@@ -19,6 +19,7 @@
 #include "parcel_utils.h"
 #include "libhpx/events.h"
 #include "libhpx/parcel.h"
+#include "libhpx/profile.h"
 #include <memory>
 #include <libhpx/Topology.h>
 #ifdef HAVE_APEX
@@ -59,7 +60,9 @@ IRecvBuffer::progress(hpx_parcel_t** stack)
   if (e) log_net("detected completed irecvs: %u\n", e);
   for (int i = 0; i < e; ++i) {
     auto p = finish(out[i], statuses[i]);
-    EVENT_PARCEL_RECV(p->id, p->action, p->size, p->src, p->target);
+    profile_stamp(p);
+    INST_FOR(p, EVENT_PARCEL_RECV(p->id, p->action, p->size, p->src,
+                                  p->target));
     parcel_stack_push(stack, p);
     start(out[i]);
   }
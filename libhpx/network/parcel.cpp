@@ -32,6 +32,7 @@
 #include "libhpx/Network.h"
 #include <libhpx/padding.h>
 #include <libhpx/parcel.h>
+#include <libhpx/profile.h>
 #include <libhpx/Topology.h>
 #include "libhpx/Worker.h"
 #include <hpx/hpx.h>
@@ -136,16 +137,25 @@ void parcel_launch(hpx_parcel_t *p) {
              actions[p->c_action].key,
              p->c_target);
 
-  EVENT_PARCEL_SEND(p->id, p->action, p->size,
-                    hpx_thread_current_target(),
-                    p->target);
+  INST_FOR(p, EVENT_PARCEL_SEND(p->id, p->action, p->size,
+                                hpx_thread_current_target(),
+                                p->target));
 
   // do a local send through loopback, bypassing the network, otherwise dump the
   // parcel out to the network
-  uint32_t target = here->gas->ownerOf(p->target);
+  uint32_t target = here->gas->owner(p->target);
+  if (target != here->rank && p->action == hpx_lco_set_action) {
+    // sets to a remote combining tree are absorbed by the local node
+    if (hpx_addr_t node = lco_tree_local(p->target)) {
+      p->target = node;
+      target = here->rank;
+    }
+  }
+
   if (target == here->rank) {
     // instrument local "receives"
-    EVENT_PARCEL_RECV(p->id, p->action, p->size, p->src, p->target);
+    INST_FOR(p, EVENT_PARCEL_RECV(p->id, p->action, p->size, p->src,
+                                  p->target));
     self->spawn(p);
   }
   else {
@@ -188,9 +198,9 @@ void parcel_init(hpx_addr_t target, hpx_action_t action, hpx_addr_t c_target,
   p->next     = nullptr;
   p->src      = here->rank;
   p->size     = len;
-  p->offset   = 0;
   p->action   = action;
   p->c_action = c_action;
+  p->sampled  = 1;
   p->target   = target;
   p->c_target = c_target;
   p->pid      = pid;
@@ -206,6 +216,15 @@ void parcel_init(hpx_addr_t target, hpx_action_t action, hpx_addr_t c_target,
   } else {
     p->id = 0;
   }
+
+  // Parcels spawned by a parcel are traced with it, across localities.
+  hpx_parcel_t *parent = (self) ? self->getCurrentParcel() : nullptr;
+  if (parent && parent->action != HPX_ACTION_NULL) {
+    p->sampled = parent->sampled;
+  } else {
+    p->sampled = trace_sample_root();
+  }
+  profile_stamp(p);
 #endif
 
   // If there's a user-defined buffer, then remember it---we'll serialize it
@@ -230,7 +249,7 @@ hpx_parcel_t *parcel_alloc(size_t payload) {
   auto p = static_cast<hpx_parcel_t *>(as_memalign(AS_REGISTERED, HPX_CACHELINE_SIZE, size));
   dbg_assert_str(p, "parcel: failed to allocate %zu registered bytes.\n", size);
 #ifdef ENABLE_INSTRUMENTATION
-  *(uint64_t*)&p->padding = UINT64_C(0);        // initialize read-only padding
+  p->stamp = UINT64_C(0);
 #endif
   return p;
 }
@@ -241,10 +260,11 @@ hpx_parcel_t *parcel_new(hpx_addr_t target, hpx_action_t action,
   hpx_parcel_t* p = parcel_alloc(len);
   parcel_init(target, action, c_target, c_action, pid, data, len, p);
   if (libhpx::Worker* w = libhpx::self) {
-    EVENT_PARCEL_CREATE(p->id, p->action, p->size, w->getCurrentParcel()->id);
+    INST_FOR(p, EVENT_PARCEL_CREATE(p->id, p->action, p->size,
+                                    w->getCurrentParcel()->id));
   }
   else {
-    EVENT_PARCEL_CREATE(p->id, p->action, p->size, 0);
+    INST_FOR(p, EVENT_PARCEL_CREATE(p->id, p->action, p->size, 0));
   }
   return p;
 }
@@ -297,7 +317,7 @@ void parcel_delete(hpx_parcel_t *p) {
     return;
   }
 
-  EVENT_PARCEL_DELETE(p->id, p->action);
+  INST_FOR(p, EVENT_PARCEL_DELETE(p->id, p->action));
   as_free(AS_REGISTERED, p);
 }
 
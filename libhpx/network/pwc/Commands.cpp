@@ -21,6 +21,7 @@
 #include "libhpx/debug.h"
 #include "libhpx/events.h"
 #include "libhpx/gpa.h"
+#include "libhpx/profile.h"
 
 namespace {
 using libhpx::network::pwc::Command;
@@ -95,7 +96,9 @@ Command::recvParcel(unsigned src) const
 #endif
   p->src = src;
   parcel_set_state(p, PARCEL_SERIALIZED | PARCEL_BLOCK_ALLOCATED);
-  EVENT_PARCEL_RECV(p->id, p->action, p->size, p->src, p->target);
+  profile_stamp(p);
+  INST_FOR(p, EVENT_PARCEL_RECV(p->id, p->action, p->size, p->src,
+                                p->target));
   return p;
 }
 
@@ -114,7 +117,9 @@ Command::rendezvousLaunch(unsigned src) const
 {
   hpx_parcel_t *p = reinterpret_cast<hpx_parcel_t*>(arg_);
   parcel_set_state(p, PARCEL_SERIALIZED);
-  EVENT_PARCEL_RECV(p->id, p->action, p->size, p->src, p->target);
+  profile_stamp(p);
+  INST_FOR(p, EVENT_PARCEL_RECV(p->id, p->action, p->size, p->src,
+                                p->target));
   DEBUG_IF (!p->target || !p->action) {
     dbg_error("Rendezvous recv operation failed for %p\n", p);
   }
@@ -184,7 +184,7 @@ PWCNetwork::send(hpx_parcel_t *p, hpx_parcel_t *ssync)
     return rendezvousSend(p);
   }
   else {
-    int rank = gas_.ownerOf(p->target);
+    int rank = gas_.owner(p->target);
     peers_[rank].send(p);
     return HPX_SUCCESS;
   }
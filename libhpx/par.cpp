@@ -75,16 +75,13 @@ int hpx_par_for(hpx_for_action_t f, int min, int max, void *args,
 
 int hpx_par_for_sync(hpx_for_action_t f, int min, int max, void *args) {
   dbg_assert(max - min > 0);
-  hpx_addr_t sync = hpx_lco_future_new(0);
-  if (sync == HPX_NULL) {
-    return log_error("could not allocate an LCO.\n");
-  }
-
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
   int e = hpx_par_for(f, min, max, args, sync);
   if (!e) {
-    e = hpx_lco_wait(sync);
+    e = hpx_lco_waiter_wait(&waiter);
   }
-  hpx_lco_delete(sync, HPX_NULL);
+  hpx_lco_waiter_fini(&waiter);
   return e;
 }
 
@@ -212,17 +209,14 @@ int hpx_par_call_sync(hpx_action_t action,
                       void (*arg_init)(void*, const int, const void*),
                       const size_t env_size, const void *env) {
   assert(max - min > 0);
-  hpx_addr_t sync = hpx_lco_future_new(0);
-  if (sync == HPX_NULL) {
-    return log_error("could not allocate an LCO.\n");
-  }
-
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
   int e = hpx_par_call(action, min, max, branching_factor, cutoff, arg_size,
                        arg_init, env_size, env, sync);
   if (!e) {
-    e = hpx_lco_wait(sync);
+    e = hpx_lco_waiter_wait(&waiter);
   }
-  hpx_lco_delete(sync, HPX_NULL);
+  hpx_lco_waiter_fini(&waiter);
   return e;
 }
 
@@ -104,7 +104,7 @@ Allreduce::add(hpx_action_t op, hpx_addr_t addr)
     int i = ctx->group_sz++;
     int32_t *ranks = reinterpret_cast<int32_t *>(ctx->data);
     if (here->ranks > 1) {
-      ranks[i] = here->gas->ownerOf(addr);
+      ranks[i] = here->gas->owner(addr);
     } else {
       // smp mode
       ranks[i] = 0;
@@ -70,11 +70,8 @@ int
 _hpx_process_broadcast_lsync(hpx_pid_t pid, hpx_action_t action,
                              hpx_addr_t rsync, int n, ...)
 {
-  hpx_addr_t lsync = hpx_lco_future_new(0);
-  if (lsync == HPX_NULL) {
-    log_error("could not allocate an LCO.\n");
-    return HPX_ENOMEM;
-  }
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t lsync = hpx_lco_waiter_init(&waiter, 0, NULL);
 
   va_list vargs;
   va_start(vargs, n);
@@ -83,11 +80,11 @@ _hpx_process_broadcast_lsync(hpx_pid_t pid, hpx_action_t action,
   }
   va_end(vargs);
 
-  if (HPX_SUCCESS != hpx_lco_wait(lsync)) {
+  if (HPX_SUCCESS != hpx_lco_waiter_wait(&waiter)) {
     dbg_error("failed broadcast\n");
   }
 
-  hpx_lco_delete(lsync, HPX_NULL);
+  hpx_lco_waiter_fini(&waiter);
   return HPX_SUCCESS;
 }
 
@@ -95,11 +92,8 @@ int
 _hpx_process_broadcast_rsync(hpx_pid_t pid, hpx_action_t action, int n,
                              ...)
 {
-  hpx_addr_t rsync = hpx_lco_future_new(0);
-  if (rsync == HPX_NULL) {
-    log_error("could not allocate an LCO.\n");
-    return HPX_ENOMEM;
-  }
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t rsync = hpx_lco_waiter_init(&waiter, 0, NULL);
 
   va_list vargs;
   va_start(vargs, n);
@@ -108,10 +102,10 @@ _hpx_process_broadcast_rsync(hpx_pid_t pid, hpx_action_t action, int n,
   }
   va_end(vargs);
 
-  if (HPX_SUCCESS != hpx_lco_wait(rsync)) {
+  if (HPX_SUCCESS != hpx_lco_waiter_wait(&waiter)) {
     dbg_error("failed broadcast\n");
   }
 
-  hpx_lco_delete(rsync, HPX_NULL);
+  hpx_lco_waiter_fini(&waiter);
   return HPX_SUCCESS;
 }
@@ -170,7 +170,8 @@ int _hpx_process_call(hpx_addr_t process, hpx_addr_t addr, hpx_action_t id,
     return HPX_SUCCESS;
   }
 
-  hpx_addr_t sync = hpx_lco_future_new(0);
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
   hpx_parcel_t *q = hpx_parcel_acquire(NULL, parcel_size(p));
   q->target = process;
   q->action = _proc_call;
@@ -184,8 +185,8 @@ int _hpx_process_call(hpx_addr_t process, hpx_addr_t addr, hpx_action_t id,
   hpx_parcel_send_sync(q);
 
   parcel_delete(p);
-  hpx_lco_wait(sync);
-  hpx_lco_delete(sync, HPX_NULL);
+  hpx_lco_waiter_wait(&waiter);
+  hpx_lco_waiter_fini(&waiter);
   return HPX_SUCCESS;
 }
 
@@ -33,6 +33,7 @@ using libhpx::scheduler::LCO;
 
 static constexpr int CODE_OFFSET = ((sizeof(uintptr_t) / 2) * 8);
 static constexpr uintptr_t ERROR_MASK = 0x1;
+static constexpr uintptr_t FIFO_MASK = 0x2;
 
 // static check to make sure the error code is related to the cvar size in the
 // way that we expect---if this fails we're probably on a 32-bit platform, and
@@ -40,8 +41,15 @@ static constexpr uintptr_t ERROR_MASK = 0x1;
 static_assert(sizeof(Condition) - (2 * sizeof(hpx_status_t)) + 1 > 0,
              "Condition instances have unexpected size.");
 
-Condition::Condition()
-    : top_(nullptr)
+/// Encode a status code as a closed condition word.
+static hpx_parcel_t *
+Encode(hpx_status_t code)
+{
+  return (hpx_parcel_t*)((((uintptr_t)code) << CODE_OFFSET) | ERROR_MASK);
+}
+
+Condition::Condition(Order order)
+    : top_((hpx_parcel_t*)((order == FIFO) ? FIFO_MASK : 0))
 {
 }
 
@@ -55,7 +63,26 @@ Condition::~Condition()
 uintptr_t
 Condition::hasError() const
 {
-  return (uintptr_t)top_ & ERROR_MASK;
+  return (uintptr_t)top_.load(std::memory_order_acquire) & ERROR_MASK;
+}
+
+uintptr_t
+Condition::order() const
+{
+  return (uintptr_t)top_.load(std::memory_order_relaxed) & FIFO_MASK;
+}
+
+hpx_parcel_t *
+Condition::Unlink(uintptr_t word)
+{
+  hpx_parcel_t *tail = (hpx_parcel_t*)(word & ~FIFO_MASK);
+  if (!tail || !(word & FIFO_MASK)) {
+    return tail;
+  }
+
+  hpx_parcel_t *head = tail->next;
+  tail->next = nullptr;
+  return head;
 }
 
 hpx_parcel_t *
@@ -65,16 +92,19 @@ Condition::setError(hpx_status_t code)
     return nullptr;
   }
 
-  hpx_parcel_t *top = top_;
-  top_ = (hpx_parcel_t*)((((uintptr_t)code) << CODE_OFFSET) | ERROR_MASK);
-  return top;
+  uintptr_t word = (uintptr_t)top_.load(std::memory_order_relaxed);
+  hpx_parcel_t *encoded = (hpx_parcel_t*)((uintptr_t)Encode(code) |
+                                          (word & FIFO_MASK));
+  top_.store(encoded, std::memory_order_release);
+  return Unlink(word);
 }
 
 hpx_status_t
 Condition::getError() const
 {
-  if (hasError()) {
-    return (hpx_status_t)((uintptr_t)(top_) >> CODE_OFFSET);
+  uintptr_t top = (uintptr_t)top_.load(std::memory_order_acquire);
+  if (top & ERROR_MASK) {
+    return (hpx_status_t)(top >> CODE_OFFSET);  // the order bit is shifted out
   }
   else {
     return HPX_SUCCESS;
@@ -85,7 +115,7 @@ void
 Condition::clearError()
 {
   if (hasError()) {
-    top_ = nullptr;
+    top_.store((hpx_parcel_t*)order(), std::memory_order_release);
   }
 }
 
@@ -96,8 +126,25 @@ Condition::push(hpx_parcel_t *parcel)
     return getError();
   }
 
-  parcel->next = top_;
-  top_ = parcel;
+  uintptr_t word = (uintptr_t)top_.load(std::memory_order_relaxed);
+  if (!(word & FIFO_MASK)) {
+    parcel->next = (hpx_parcel_t*)word;
+    top_.store(parcel, std::memory_order_release);
+    return HPX_SUCCESS;
+  }
+
+  // Link the parcel in after the newest waiter, in front of the oldest, and
+  // make it the newest.
+  hpx_parcel_t *tail = (hpx_parcel_t*)(word & ~FIFO_MASK);
+  if (tail) {
+    parcel->next = tail->next;
+    tail->next = parcel;
+  }
+  else {
+    parcel->next = parcel;
+  }
+  top_.store((hpx_parcel_t*)((uintptr_t)parcel | FIFO_MASK),
+             std::memory_order_release);
   return HPX_SUCCESS;
 }
 
@@ -108,12 +155,30 @@ Condition::pop()
     return nullptr;
   }
 
-  hpx_parcel_t *top = top_;
-  if (top) {
-    top_ = top->next;
-    top->next = nullptr;
+  uintptr_t word = (uintptr_t)top_.load(std::memory_order_relaxed);
+  if (!(word & FIFO_MASK)) {
+    hpx_parcel_t *top = (hpx_parcel_t*)word;
+    if (top) {
+      top_.store(top->next, std::memory_order_release);
+      top->next = nullptr;
+    }
+    return top;
+  }
+
+  hpx_parcel_t *tail = (hpx_parcel_t*)(word & ~FIFO_MASK);
+  if (!tail) {
+    return nullptr;
+  }
+
+  hpx_parcel_t *head = tail->next;
+  if (head == tail) {
+    top_.store((hpx_parcel_t*)FIFO_MASK, std::memory_order_release);
+  }
+  else {
+    tail->next = head->next;
   }
-  return top;
+  head->next = nullptr;
+  return head;
 }
 
 hpx_parcel_t *
@@ -123,9 +188,9 @@ Condition::popAll()
     return nullptr;
   }
 
-  hpx_parcel_t *top = top_;
-  top_ = nullptr;
-  return top;
+  uintptr_t word = (uintptr_t)top_.load(std::memory_order_relaxed);
+  top_.store((hpx_parcel_t*)(word & FIFO_MASK), std::memory_order_release);
+  return Unlink(word);
 }
 
 void
@@ -134,13 +199,14 @@ Condition::reset()
   DEBUG_IF(!hasError() && !empty()) {
     dbg_error("Resetting a condition that has waiting threads.\n");
   }
-  top_ = nullptr;
+  top_.store((hpx_parcel_t*)order(), std::memory_order_release);
 }
 
 bool
 Condition::empty() const
 {
-  return (top_ == nullptr);
+  uintptr_t word = (uintptr_t)top_.load(std::memory_order_acquire);
+  return ((word & ~FIFO_MASK) == 0);
 }
 
 void
@@ -160,3 +226,33 @@ Condition::signalError(hpx_status_t code)
 {
   parcel_launch_all(setError(code));
 }
+
+bool
+Condition::tryPush(hpx_parcel_t *parcel)
+{
+  dbg_assert(!order());
+  hpx_parcel_t *top = top_.load(std::memory_order_acquire);
+  do {
+    if ((uintptr_t)top & ERROR_MASK) {
+      return false;
+    }
+    parcel->next = top;
+  } while (!top_.compare_exchange_weak(top, parcel, std::memory_order_acq_rel,
+                                       std::memory_order_acquire));
+  return true;
+}
+
+bool
+Condition::close(hpx_status_t code)
+{
+  hpx_parcel_t *top = top_.load(std::memory_order_acquire);
+  do {
+    if ((uintptr_t)top & ERROR_MASK) {
+      return false;
+    }
+  } while (!top_.compare_exchange_weak(top, Encode(code),
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire));
+  parcel_launch_all(top);
+  return true;
+}
@@ -15,6 +15,7 @@
 #define LIBHPX_SCHEDULER_CVAR_H
 
 #include <hpx/hpx.h>
+#include <atomic>
 
 namespace libhpx {
 namespace scheduler {
@@ -22,7 +23,20 @@ class LCO;
 
 class Condition final {
  public:
-  Condition();
+  /// The order in which waiters are popped.
+  ///
+  /// A LIFO condition is a stack, which is what attached continuations want. A
+  /// FIFO condition keeps its waiters in a circular list, with the condition
+  /// word pointing at the newest waiter, whose next is the oldest. Pushes and
+  /// pops are both constant time, and the lists returned by popAll() and
+  /// setError() are in arrival order. FIFO conditions can't be used with the
+  /// lock-free interface.
+  enum Order {
+    LIFO,
+    FIFO
+  };
+
+  explicit Condition(Order order = LIFO);
   ~Condition();
 
   /// Reset a condition variable.
@@ -73,6 +87,8 @@ class Condition final {
 
   /// Pop the top parcel from a condition variable.
   ///
+  /// For a FIFO condition this is the oldest parcel.
+  ///
   /// @param         cvar The condition to pop.
   ///
   /// @return             The top parcel, or NULL if the condition is empty or has
@@ -107,11 +123,50 @@ class Condition final {
   /// @param         code The error code to set in the condition.
   void signalError(hpx_status_t code);
 
+  /// The lock-free interface.
+  ///
+  /// LCOs with a single trigger transition (e.g., futures) can use the
+  /// condition without holding the LCO lock. A closed condition is one that
+  /// holds a status code (HPX_SUCCESS included) instead of a waiter stack. Only
+  /// tryPush(), close(), closed(), getError() and reset() may be mixed in this
+  /// mode.
+  /// @{
+
+  /// Push a parcel onto the condition's waiter stack unless it is closed.
+  ///
+  /// @param       parcel The parcel to push.
+  ///
+  /// @returns            true if the parcel was pushed, false if the condition
+  ///                       was already closed.
+  bool tryPush(struct hpx_parcel *parcel);
+
+  /// Close the condition with a status code and launch all of its waiters.
+  ///
+  /// @param         code The status to close the condition with.
+  ///
+  /// @returns            true if this call closed the condition, false if it
+  ///                       was already closed.
+  bool close(hpx_status_t code);
+
+  /// Check to see if the condition has been closed (or has an error).
+  bool closed() const {
+    return hasError();
+  }
+  /// @}
+
  private:
 
   uintptr_t hasError() const;
 
-  hpx_parcel_t *top_;
+  /// The order bit of the condition word, which is kept through errors and
+  /// resets.
+  uintptr_t order() const;
+
+  /// Detach the waiters from the condition word @p word as a NULL-terminated
+  /// list, without updating the condition.
+  static hpx_parcel_t* Unlink(uintptr_t word);
+
+  std::atomic<hpx_parcel_t*> top_;
 };
 
 } // namespace scheduler
@@ -21,7 +21,7 @@
 namespace libhpx {
 namespace scheduler {
 static constexpr unsigned BASE = 16;
-static constexpr unsigned LIMIT = 65536;
+static constexpr unsigned LIMIT = 1024;
 
 template <typename T>
 class TatasLock {
@@ -19,17 +19,22 @@
 #include "Condition.h"
 #include "Thread.h"
 #include "lco/LCO.h"
+#include "libhpx/accounting.h"
 #include "libhpx/action.h"
 #include "libhpx/debug.h"
 #include "libhpx/events.h"
+#include "libhpx/GAS.h"
 #include "libhpx/libhpx.h"
 #include "libhpx/locality.h"
 #include "libhpx/memory.h"
 #include "libhpx/Network.h"
+#include "libhpx/perf.h"
+#include "libhpx/profile.h"
 #include "libhpx/rebalancer.h"
 #include "libhpx/Scheduler.h"
 #include "libhpx/Topology.h"
 #include "libhpx/system.h"
+#include "libhpx/time.h"
 #include "libhpx/util/math.h"
 #include <cstring>
 #ifdef HAVE_URCU
@@ -55,6 +60,8 @@ Worker::Worker(int id)
       seed_(id),
       workFirst_(0),
       lastVictim_(nullptr),
+      source_(SOURCE_NONE),
+      spins_(0),
       profiler_(nullptr),
       bst(nullptr),
       system_(nullptr),
@@ -118,6 +125,8 @@ Worker::popLIFO()
 hpx_parcel_t *
 Worker::handleNetwork()
 {
+  INST(accounting_enter(id_, ACCOUNTING_NETWORK));
+
   // don't do work first scheduling in the network
   int wf = workFirst_;
   workFirst_ = -1;
@@ -205,19 +214,33 @@ void
 Worker::schedule(Continuation& f)
 {
   EVENT_SCHED_BEGIN();
+  INST(accounting_enter(id_, ACCOUNTING_SCHED));
   if (state_ != RUN) {
+    found(SOURCE_NONE);
     transfer(system_, f);
   }
   else if (hpx_parcel_t *p = handleMail()) {
+    found(SOURCE_MAIL);
     transfer(p, f);
   }
   else if (hpx_parcel_t *p = popLIFO()) {
+    found(SOURCE_LIFO);
     transfer(p, f);
   }
   else {
+    found(SOURCE_NONE);
     transfer(system_, f);
   }
-  EVENT_SCHED_END(0, 0);
+
+  // `this` is volatile across the transfer
+  self->schedEnd();
+}
+
+void
+Worker::schedEnd()
+{
+  EVENT_SCHED_END(source_, spins_);
+  spins_ = 0;
 }
 
 void
@@ -255,10 +278,20 @@ Worker::enter()
              "This MAY result in diminished performance.\n");
   }
 
+  // make sure our trace timestamps are comparable with the other workers'
+  libhpx_time_check(id_);
+  perf_thread_init(id_);
+
+  INST(accounting_enter(id_, ACCOUNTING_SCHED));
+
   // allocate a parcel and a stack header for the system stack
   hpx_parcel_t system;
   parcel_init(0, 0, 0, 0, 0, nullptr, 0, &system);
   Thread thread(&system);
+
+  // the scheduler isn't part of any parcel's subtree when tracing is sampled
+  system.sampled = 0;
+  INST(trace_sample_bind(system.sampled));
   parcel_set_thread(&system, &thread);
 
   system_ = &system;
@@ -292,6 +325,8 @@ Worker::enter()
   rcu_unregister_thread();
 #endif
 
+  perf_thread_fini(id_);
+
   // leave the global address space
   as_leave();
 
@@ -312,9 +347,11 @@ Worker::sleep()
     }
 
     // go back to sleep
+    INST(accounting_enter(id_, ACCOUNTING_SLEEP));
     here->sched->subActive();
     running_.wait(_);
     here->sched->addActive();
+    INST(accounting_enter(id_, ACCOUNTING_SCHED));
   }
 }
 
@@ -325,8 +362,15 @@ Worker::checkpoint(hpx_parcel_t *p, Continuation& f, void *sp)
       Scheduler::before_transfer_callback();
   }
 
+  // charge the hardware counters to the parcel that we're switching away from
+  INST_IF (libhpx_perf_counters) {
+    profile_counters(id_, (current_ != system_) ? current_ : nullptr);
+  }
+
   current_->thread->setSp(sp);
   std::swap(current_, p);
+  INST(accounting_enter(id_, (current_ == system_) ? ACCOUNTING_SCHED :
+                        ACCOUNTING_USER));
   f(p);
 
 #ifdef HAVE_URCU
@@ -369,22 +413,30 @@ Worker::run()
 {
   std::function<void(hpx_parcel_t*)> null([](hpx_parcel_t*){});
   while (state_ ==  RUN) {
+    INST(uint64_t pass = accounting_enter(id_, ACCOUNTING_SCHED));
     if (hpx_parcel_t *p = handleMail()) {
+      found(SOURCE_MAIL);
       transfer(p, null);
     }
     else if (hpx_parcel_t *p = popLIFO()) {
+      found(SOURCE_LIFO);
       transfer(p, null);
     }
     else if (hpx_parcel_t *p = handleEpoch()) {
+      found(SOURCE_NONE);
       transfer(p, null);
     }
     else if (hpx_parcel_t *p = handleNetwork()) {
+      found(SOURCE_NETWORK);
       transfer(p, null);
     }
     else if (hpx_parcel_t *p = handleSteal()) {
+      found(SOURCE_STEAL);
       transfer(p, null);
     }
     else {
+      INST(accounting_idle(id_, pass));
+      ++spins_;
 #ifdef HAVE_URCU
       rcu_quiescent_state();
 #endif
@@ -398,11 +450,14 @@ Worker::spawn(hpx_parcel_t* p)
   dbg_assert(p);
   dbg_assert(actions[p->action].handler != NULL);
 
-  // If the target has affinity then send the parcel to that worker.
-  int affinity = here->gas->getAffinity(p->target);
-  if (0 <= affinity && affinity != id_) {
-    here->sched->getWorker(affinity)->pushMail(p);
-    return;
+  // If the target has affinity then send the parcel to that worker. The
+  // affinity map is usually empty so we check that first to avoid the lookup.
+  if (libhpx::gas::Affinity::HasBindings()) {
+    int affinity = here->gas->getAffinity(p->target);
+    if (0 <= affinity && affinity != id_) {
+      here->sched->getWorker(affinity)->pushMail(p);
+      return;
+    }
   }
 
   // If we're not running then push the parcel and return. This prevents an
@@ -436,6 +491,7 @@ Worker::spawn(hpx_parcel_t* p)
   // prevent it from being stolen, which we can do by using the NULL
   // continuation.
   EVENT_THREAD_SUSPEND(current_);
+  found(SOURCE_SPAWN);
   if (current_ == system_) {
     transfer(p, [](hpx_parcel_t*) {});
   }
@@ -459,6 +515,7 @@ Worker::stealFrom(Worker* victim) {
   hpx_parcel_t *p = victim->queues_[victim->workId_].steal();
   lastVictim_ = (p) ? victim : nullptr;
   EVENT_SCHED_STEAL((p) ? p->id : 0, victim->getId());
+  INST(accounting_steal(id_, victim->getId(), p != nullptr));
   return p;
 }
 
@@ -581,6 +638,7 @@ Worker::handleSteal()
     return NULL;
   }
 
+  INST(accounting_enter(id_, ACCOUNTING_STEAL));
   libhpx_sched_policy_t policy = here->config->sched_policy;
   switch (policy) {
     default:
@@ -598,7 +656,7 @@ Worker::ExecuteUserThread(hpx_parcel_t *p)
 {
   Worker* w = self;
   w->EVENT_THREAD_RUN(p);
-  EVENT_SCHED_END(0, 0);
+  w->schedEnd();
   int status = HPX_SUCCESS;
   try {
     status = action_exec_parcel(p->action, p);
@@ -704,6 +762,7 @@ Worker::wait(LCO& lco, Condition& cond)
     return status;
   }
 
+  EVENT_LCO_WAIT((uintptr_t)&lco, 0);
   EVENT_THREAD_SUSPEND(p);
   schedule([&lco](hpx_parcel_t* p) {
       lco.unlock(p);
@@ -715,6 +774,24 @@ Worker::wait(LCO& lco, Condition& cond)
   return cond.getError();
 }
 
+hpx_status_t
+Worker::wait(Condition& cond)
+{
+  hpx_parcel_t* p = current_;
+  dbg_assert(!p->thread->inLCO());
+
+  EVENT_THREAD_SUSPEND(p);
+  schedule([&cond](hpx_parcel_t* p) {
+      if (!cond.tryPush(p)) {
+        parcel_launch(p);
+      }
+    });
+
+  // `this` is volatile across schedule
+  self->EVENT_THREAD_RESUME(p);
+  return cond.getError();
+}
+
 Worker::FreelistNode::FreelistNode(FreelistNode* n)
     : next(n),
       depth((n) ? n->depth + 1 : 1)
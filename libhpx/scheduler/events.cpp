@@ -18,6 +18,7 @@
 #include "libhpx/Worker.h"
 #include "libhpx/events.h"
 #include "libhpx/parcel.h"
+#include "libhpx/profile.h"
 #include "hpx/hpx.h"
 
 namespace {
@@ -26,6 +27,7 @@ using libhpx::Worker;
 
 void
 Worker::EVENT_THREAD_RUN(hpx_parcel_t *p) {
+  trace_sample_bind(p->sampled);
   if (p == system_) {
     return;
   }
@@ -37,6 +39,7 @@ Worker::EVENT_THREAD_RUN(hpx_parcel_t *p) {
     profiler_ = (void*)(apex_start(APEX_FUNCTION_ADDRESS, handler));
   }
 #endif
+  profile_run(id_, p);
   EVENT_PARCEL_RUN(p->id, p->action, p->size);
 }
 
@@ -51,7 +54,9 @@ Worker::EVENT_THREAD_END(hpx_parcel_t *p) {
     profiler_ = NULL;
   }
 #endif
+  profile_end(id_, p);
   EVENT_PARCEL_END(p->id, p->action);
+  trace_sample_bind(0);
 }
 
 void
@@ -65,11 +70,14 @@ Worker::EVENT_THREAD_SUSPEND(hpx_parcel_t *p) {
     profiler_ = NULL;
   }
 #endif
+  profile_suspend(p);
   EVENT_PARCEL_SUSPEND(p->id, p->action);
+  trace_sample_bind(0);
 }
 
 void
 Worker::EVENT_THREAD_RESUME(hpx_parcel_t *p) {
+  trace_sample_bind(p->sampled);
   if (p == system_) {
     return;
   }
@@ -79,6 +87,7 @@ Worker::EVENT_THREAD_RESUME(hpx_parcel_t *p) {
     profiler_ = (void*)(apex_resume(APEX_FUNCTION_ADDRESS, handler));
   }
 #endif
+  profile_resume(p);
   EVENT_PARCEL_RESUME(p->id, p->action);
 }
 
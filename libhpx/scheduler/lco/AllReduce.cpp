@@ -17,6 +17,14 @@
 
 /// @file libhpx/scheduler/allreduce.c
 /// @brief Defines the all-reduction LCO.
+///
+/// A persistent allreduce has a fixed number of participants that join once
+/// per epoch. Each join takes a ticket that picks its leaf in a binomial
+/// combining tree, writes its value into the leaf's slot, and then climbs the
+/// tree. At each level the second of the two children to arrive combines the
+/// pair and keeps climbing, so contributions never take the LCO's lock. The
+/// join that reaches the root copies the result into one of two buffers, by
+/// epoch parity, and only then takes the lock to wake the readers.
 
 #include "LCO.h"
 #include "Condition.h"
@@ -24,6 +32,7 @@
 #include "libhpx/debug.h"
 #include "libhpx/memory.h"
 #include "libhpx/Worker.h"
+#include <atomic>
 #include <cstring>
 #include <mutex>
 
@@ -39,6 +48,7 @@ class AllReduce final : public LCO {
  public:
   AllReduce(size_t writers, size_t readers, size_t size,
             hpx_action_t id, hpx_action_t op);
+  AllReduce(unsigned participants, size_t size, hpx_action_t op);
 
   ~AllReduce() {
     // lock(TRACE_EVENT_LCO_DELETE);
@@ -48,6 +58,11 @@ class AllReduce final : public LCO {
   hpx_status_t attach(hpx_parcel_t *p);
 
   int set(size_t size, const void *value) {
+    if (participants_) {
+      uint64_t epoch;
+      return contribute(size, value, epoch);
+    }
+
     //lock(TRACE_EVENT_LCO_SET);
     std::lock_guard<LCO> _(*this);
     return setInner(size, value);
@@ -59,12 +74,28 @@ class AllReduce final : public LCO {
   }
 
   hpx_status_t get(size_t size, void *value, int reset) {
+    if (participants_) {
+      return getLatest(size, value);
+    }
+
     // lock(TRACE_EVENT_LCO_WAIT);
     std::lock_guard<LCO> _(*this);
     return getInner(size, value, reset);
   }
 
   hpx_status_t getRef(size_t size, void **out, int *unpin) {
+    // A persistent allreduce hands out its current result buffer, which stays
+    // valid until the epoch after next completes.
+    if (participants_) {
+      uint64_t epoch;
+      if (auto status = waitLatest(epoch)) {
+        return status;
+      }
+      *out = buffer(epoch);
+      *unpin = 0;
+      return HPX_SUCCESS;
+    }
+
     // We can't retain a pointer to their buffer due to implicit reset.
     *out = registered_malloc(size);
     *unpin = 1;
@@ -72,6 +103,11 @@ class AllReduce final : public LCO {
   }
 
   bool release(void *out) {
+    if (participants_) {
+      dbg_assert(out == buffer(0) || out == buffer(1));
+      return true;
+    }
+
     // We know that allreduce buffers were always copies.
     registered_free(out);
     return false;
@@ -85,13 +121,21 @@ class AllReduce final : public LCO {
     // lock(TRACE_EVENT_LCO_RESET);
     std::lock_guard<LCO> _(*this);
     epoch_.reset();
+    if (participants_) {
+      resetSchedule();
+    }
   }
 
   size_t size(size_t bytes) const {
-    return sizeof(AllReduce) + bytes;
+    return sizeof(AllReduce) + ((participants_) ? Bytes(participants_, size_)
+                                                : bytes);
   }
 
   int join(size_t size, const void* value, void* out) {
+    if (participants_) {
+      return joinPersistent(size, value, out);
+    }
+
     std::lock_guard<LCO> _(*this);
     setInner(size, value);
     return getInner(size, out, 0);
@@ -107,6 +151,23 @@ class AllReduce final : public LCO {
     return HPX_SUCCESS;
   }
 
+  static int NewPersistentHandler(void* buffer, unsigned participants,
+                                  size_t size, hpx_action_t op) {
+    auto lco = new(buffer) AllReduce(participants, size, op);
+    LCO_LOG_NEW((uintptr_t)self->getCurrentParcel(), lco);
+    return HPX_SUCCESS;
+  }
+
+  /// The number of bytes a persistent allreduce needs after the LCO.
+  ///
+  /// This is the two result buffers followed by one slot per participant. A
+  /// slot holds the arrival count for the tree node whose upper child is that
+  /// participant's leaf, and the partial value, and is padded to a cacheline
+  /// so that concurrent joins don't share lines.
+  static size_t Bytes(unsigned participants, size_t size) {
+    return 2 * Align(size) + participants * SlotStride(size);
+  }
+
   static int JoinHandler(AllReduce* lco, const void* data, size_t n);
 
   struct JoinAsyncArgs {
@@ -153,6 +214,59 @@ class AllReduce final : public LCO {
   /// @returns          HPX_SUCCESS
   hpx_status_t getInner(size_t size, void *value, int reset);
 
+  /// The persistent schedule.
+  /// @{
+  static size_t Align(size_t bytes) {
+    return (bytes + 15) & ~size_t(15);
+  }
+
+  static size_t SlotStride(size_t size) {
+    size_t bytes = 16 + Align(size);
+    return (bytes + HPX_CACHELINE_SIZE - 1) & ~size_t(HPX_CACHELINE_SIZE - 1);
+  }
+
+  /// The result buffer for an @p epoch.
+  char* buffer(uint64_t epoch) {
+    return value_ + (epoch & 1) * Align(size_);
+  }
+
+  std::atomic<unsigned>& arrivals(unsigned i) {
+    char* slot = value_ + 2 * Align(size_) + i * SlotStride(size_);
+    return *reinterpret_cast<std::atomic<unsigned>*>(slot);
+  }
+
+  char* slot(unsigned i) {
+    return value_ + 2 * Align(size_) + i * SlotStride(size_) + 16;
+  }
+
+  /// Contribute @p value to the current epoch.
+  ///
+  /// @param       size The number of bytes in @p value.
+  /// @param      value The input value.
+  /// @param[out] epoch The epoch that the value was contributed to.
+  ///
+  /// @returns          1 if this contribution completed the epoch.
+  int contribute(size_t size, const void *value, uint64_t& epoch);
+
+  /// Publish the result at the root of the tree for @p epoch.
+  void publish(uint64_t epoch);
+
+  /// Wait until @p epoch has been published.
+  hpx_status_t waitEpoch(uint64_t epoch);
+
+  /// Wait for the latest epoch, or the first one if none has been published.
+  hpx_status_t waitLatest(uint64_t& epoch);
+
+  /// Copy out the latest result.
+  hpx_status_t getLatest(size_t size, void *out);
+
+  /// Contribute and wait for the result of the same epoch.
+  int joinPersistent(size_t size, const void *value, void *out);
+
+  /// Reset the tickets and arrival counts, the LCO must be quiescent.
+  void resetSchedule();
+  /// @}
+
   Condition        epoch_;
   const size_t   readers_;
   const size_t   writers_;
@@ -160,6 +274,10 @@ class AllReduce final : public LCO {
   const hpx_action_t  op_;
   size_t           count_;
   volatile int     phase_;
+  const unsigned participants_;                 //<! 0 unless persistent
+  const size_t      size_;
+  std::atomic<uint64_t> tickets_;               //<! joins taken, persistent
+  std::atomic<uint64_t> published_;             //<! epochs completed
   alignas(16) char value_[];
 };
 
@@ -167,6 +285,10 @@ LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, New, AllReduce::NewHandler,
               HPX_POINTER, HPX_SIZE_T, HPX_SIZE_T, HPX_SIZE_T, HPX_ACTION_T,
               HPX_ACTION_T);
 
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, NewPersistent,
+              AllReduce::NewPersistentHandler, HPX_POINTER, HPX_UINT,
+              HPX_SIZE_T, HPX_ACTION_T);
+
 LIBHPX_ACTION(HPX_DEFAULT, HPX_MARSHALLED | HPX_PINNED, Join,
               AllReduce::JoinHandler, HPX_POINTER, HPX_POINTER, HPX_SIZE_T);
 
@@ -248,15 +370,26 @@ AllReduce::attach(hpx_parcel_t *p)
   // lock(TRACE_EVENT_LCO_ATTACH_PARCEL);
   std::lock_guard<LCO> _(*this);
 
+  // A persistent allreduce holds the parcel until the epoch in flight, if
+  // there is one, is published.
+  if (participants_) {
+    uint64_t joined = tickets_.load(std::memory_order_acquire);
+    uint64_t epochs = published_.load(std::memory_order_acquire);
+    if (epochs * participants_ < joined) {
+      return AttachTo(epoch_, p);
+    }
+  }
+
   // Pick attach to mean "set" for allreduce. We have to wait for reducing to
   // complete before sending the parcel.
   if (phase_ != REDUCING) {
-    return epoch_.push(p);
+    return AttachTo(epoch_, p);
   }
 
-  // If the allreduce has an error, then return that error without sending the
-  // parcel.
+  // If the allreduce has an error, then release the parcel and return the
+  // error.
   if (auto status = epoch_.getError()) {
+    parcel_delete(p);
     return status;
   }
 
@@ -275,7 +408,11 @@ AllReduce::AllReduce(size_t writers, size_t readers, size_t size,
       id_(id),
       op_(op),
       count_(writers),
-      phase_(REDUCING)
+      phase_(REDUCING),
+      participants_(0),
+      size_(size),
+      tickets_(0),
+      published_(0)
 {
   if (size) {
     assert(id);
@@ -284,6 +421,145 @@ AllReduce::AllReduce(size_t writers, size_t readers, size_t size,
   }
 }
 
+AllReduce::AllReduce(unsigned participants, size_t size, hpx_action_t op)
+    : LCO(LCO_ALLREDUCE),
+      epoch_(),
+      readers_(participants),
+      writers_(participants),
+      id_(HPX_ACTION_NULL),
+      op_(op),
+      count_(participants),
+      phase_(REDUCING),
+      participants_(participants),
+      size_(size),
+      tickets_(0),
+      published_(0)
+{
+  dbg_assert(participants);
+  dbg_assert(!size || op);
+  for (unsigned i = 0; i < participants; ++i) {
+    new(&arrivals(i)) std::atomic<unsigned>(0);
+  }
+}
+
+int
+AllReduce::contribute(size_t size, const void *value, uint64_t& epoch)
+{
+  dbg_assert(size == size_);
+  dbg_assert(!size || value);
+
+  uint64_t ticket = tickets_.fetch_add(1, std::memory_order_relaxed);
+  unsigned i = ticket % participants_;
+  epoch = ticket / participants_;
+  if (size) {
+    memcpy(slot(i), value, size);
+  }
+
+  // Climb the tree. At the level for bit k, the node's lower child is the
+  // leaf with bit k clear and its upper child is the leaf with bit k set, and
+  // the pair meet at the upper child's arrival count. The counts are never
+  // reset, each epoch adds exactly two to the count of every node with two
+  // children, so the odd arrival is always the second one.
+  for (unsigned k = 1; k < participants_; k <<= 1) {
+    unsigned upper = i | k;
+    if (upper >= participants_) {
+      continue;
+    }
+
+    if (!(arrivals(upper).fetch_add(1, std::memory_order_acq_rel) & 1)) {
+      return 0;
+    }
+
+    i &= ~k;
+    if (size) {
+      hpx_monoid_op_t f = (hpx_monoid_op_t)actions[op_].handler;
+      f(slot(i), slot(upper), size);
+    }
+  }
+
+  dbg_assert(i == 0);
+  publish(epoch);
+  return 1;
+}
+
+void
+AllReduce::publish(uint64_t epoch)
+{
+  // Every participant has to read the result of an epoch before it can join
+  // the next one, so the epochs complete in order and the buffer for the epoch
+  // after next is never written while this one is still being read.
+  dbg_assert(published_.load(std::memory_order_relaxed) == epoch);
+  if (size_) {
+    memcpy(buffer(epoch), slot(0), size_);
+  }
+  published_.store(epoch + 1, std::memory_order_release);
+
+  std::lock_guard<LCO> _(*this);
+  epoch_.signalAll();
+}
+
+hpx_status_t
+AllReduce::waitEpoch(uint64_t epoch)
+{
+  if (epoch < published_.load(std::memory_order_acquire)) {
+    return HPX_SUCCESS;
+  }
+
+  std::lock_guard<LCO> _(*this);
+  while (published_.load(std::memory_order_acquire) <= epoch) {
+    if (auto status = waitFor(epoch_)) {
+      return status;
+    }
+  }
+  return HPX_SUCCESS;
+}
+
+hpx_status_t
+AllReduce::waitLatest(uint64_t& epoch)
+{
+  uint64_t n = published_.load(std::memory_order_acquire);
+  epoch = (n) ? n - 1 : 0;
+  return waitEpoch(epoch);
+}
+
+hpx_status_t
+AllReduce::getLatest(size_t size, void *out)
+{
+  dbg_assert(!size || out);
+  uint64_t epoch;
+  if (auto status = waitLatest(epoch)) {
+    return status;
+  }
+  if (size) {
+    memcpy(out, buffer(epoch), size);
+  }
+  return HPX_SUCCESS;
+}
+
+int
+AllReduce::joinPersistent(size_t size, const void *value, void *out)
+{
+  uint64_t epoch;
+  contribute(size, value, epoch);
+  if (auto status = waitEpoch(epoch)) {
+    return status;
+  }
+  if (size && out) {
+    memcpy(out, buffer(epoch), size);
+  }
+  return HPX_SUCCESS;
+}
+
+void
+AllReduce::resetSchedule()
+{
+  tickets_.store(0, std::memory_order_relaxed);
+  published_.store(0, std::memory_order_relaxed);
+  for (unsigned i = 0; i < participants_; ++i) {
+    arrivals(i).store(0, std::memory_order_relaxed);
+  }
+}
+
 hpx_addr_t
 hpx_lco_allreduce_new(size_t inputs, size_t outputs, size_t size,
                       hpx_action_t id, hpx_action_t op)
@@ -300,6 +576,25 @@ hpx_lco_allreduce_new(size_t inputs, size_t outputs, size_t size,
   return gva;
 }
 
+hpx_addr_t
+hpx_lco_allreduce_persistent_new(size_t participants, size_t size,
+                                 hpx_action_t op)
+{
+  dbg_assert(participants && participants <= UINT32_MAX);
+  unsigned n = participants;
+  hpx_addr_t gva = HPX_NULL;
+  try {
+    size_t bytes = AllReduce::Bytes(n, size);
+    AllReduce* lva = new(bytes, gva) AllReduce(n, size, op);
+    hpx_gas_unpin(gva);
+    LCO_LOG_NEW(gva, lva);
+  }
+  catch (const LCO::NonLocalMemory&) {
+    hpx_call_sync(gva, NewPersistent, nullptr, 0, &n, &size, &op);
+  }
+  return gva;
+}
+
 hpx_addr_t
 hpx_lco_allreduce_local_array_new(int n, size_t participants, size_t readers,
                                   size_t size, hpx_action_t id, hpx_action_t op)
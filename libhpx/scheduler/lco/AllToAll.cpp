@@ -72,6 +72,7 @@
 #include "libhpx/debug.h"
 #include "libhpx/memory.h"
 #include "libhpx/Worker.h"
+#include <atomic>
 #include <mutex>
 #include <cstring>
 
@@ -185,12 +186,11 @@ AllToAll::attach(hpx_parcel_t *p)
 {
   std::lock_guard<LCO> _(*this);
   if (phase_ != GATHERING) {
-    if (auto status = wait_.push(p)) {
-      return status;
-    }
+    return AttachTo(wait_, p);
   }
 
   if (auto status = wait_.getError()) {
+    parcel_delete(p);
     return status;
   }
 
@@ -376,3 +376,350 @@ hpx_lco_alltoall_local_array_new(int n, size_t inputs, size_t size)
   return base;
 }
 
+
+// The pairwise alltoall keeps one block per participant, allocated cyclically.
+// The block holds two exchange LCOs, used on alternate epochs, followed by the
+// participant's epoch counts. Each exchange has room for the row it receives.
+// A participant scatters its row by putting each element directly into its
+// column of the destination's exchange, in pairwise order starting with its
+// right neighbor, and uses the exchange as the put's rsync. The exchange
+// counts the puts and releases its participant when all of them have arrived.
+//
+// A participant only gets its next row after it has read the current one, and
+// must read before it scatters again, so writers are at most one epoch ahead of
+// any reader and two exchanges per participant are enough.
+namespace {
+/// The per-participant epoch counts that trail the two exchanges.
+struct Participant {
+  std::atomic<uint64_t> scattered;
+  std::atomic<uint64_t> gathered;
+};
+
+class Exchange final : public LCO {
+ public:
+  Exchange(unsigned inputs, size_t size);
+
+  ~Exchange() {
+    lock();                                     // released in ~LCO()
+  }
+
+  unsigned inputs() const {
+    return inputs_;
+  }
+
+  hpx_status_t attach(hpx_parcel_t *p);
+  hpx_status_t get(size_t size, void *value, int reset);
+  hpx_status_t getRef(size_t size, void **out, int *unpin);
+  bool release(void *out);
+
+  /// Each set counts one arrived element, the value is ignored.
+  int set(size_t size, const void *value);
+
+  void error(hpx_status_t code) {
+    std::lock_guard<LCO> _(*this);
+    full_.signalError(code);
+  }
+
+  hpx_status_t wait(int reset) {
+    return get(0, nullptr, reset);
+  }
+
+  void reset() {
+    std::lock_guard<LCO> _(*this);
+    full_.reset();
+    count_ = inputs_;
+  }
+
+  size_t size(size_t) const {
+    return sizeof(Exchange) + size_;
+  }
+
+  /// The layout of a participant's block for rows of @p size bytes.
+  /// @{
+  static size_t Half(size_t size) {
+    size_t bytes = sizeof(Exchange) + size;
+    return (bytes + HPX_CACHELINE_SIZE - 1) & ~size_t(HPX_CACHELINE_SIZE - 1);
+  }
+
+  static size_t Offset(uint64_t epoch, size_t size) {
+    return (epoch & 1) * Half(size);
+  }
+
+  static size_t Value(unsigned column, size_t block) {
+    return sizeof(Exchange) + column * block;
+  }
+
+  static size_t BlockSize(size_t size) {
+    return 2 * Half(size) + sizeof(Participant);
+  }
+  /// @}
+
+  /// Static action interface.
+  /// @{
+  static int NewHandler(char* block, unsigned inputs, size_t size);
+  static int ScatterHandler(char* block, const void* args, size_t n);
+  static int GatherHandler(char* block, size_t size);
+  /// @}
+
+ private:
+  Condition        full_;
+  const unsigned inputs_;
+  const size_t     size_;
+  unsigned        count_;
+  alignas(16) char value_[];
+};
+
+/// The arguments for a remote scatter, followed by the row.
+struct ScatterArgs {
+  hpx_addr_t base;
+  unsigned     id;
+  char     row[];
+};
+
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, NewExchange, Exchange::NewHandler,
+              HPX_POINTER, HPX_UINT, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED | HPX_MARSHALLED, Scatter,
+              Exchange::ScatterHandler, HPX_POINTER, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, Gather, Exchange::GatherHandler,
+              HPX_POINTER, HPX_SIZE_T);
+
+/// The block for participant @p id.
+hpx_addr_t
+Node(hpx_addr_t base, unsigned id, size_t size)
+{
+  size_t bsize = Exchange::BlockSize(size);
+  return hpx_addr_add(base, id * bsize, bsize);
+}
+
+Participant&
+Counts(char* block, size_t size)
+{
+  return *reinterpret_cast<Participant*>(block + 2 * Exchange::Half(size));
+}
+
+Exchange&
+ExchangeAt(char* block, uint64_t epoch, size_t size)
+{
+  return *reinterpret_cast<Exchange*>(block + Exchange::Offset(epoch, size));
+}
+
+/// Scatter the row for participant @p id from its pinned @p block.
+void
+ScatterRow(hpx_addr_t base, char* block, unsigned id, size_t size,
+           const char* row)
+{
+  uint64_t epoch = Counts(block, size).scattered.fetch_add(1);
+  unsigned n = ExchangeAt(block, 0, size).inputs();
+  size_t bsize = Exchange::BlockSize(size);
+  size_t bytes = size / n;
+  for (unsigned k = 0; k < n; ++k) {
+    unsigned j = (id + k) % n;
+    hpx_addr_t node = Node(base, j, size);
+    hpx_addr_t exchange = hpx_addr_add(node, Exchange::Offset(epoch, size),
+                                       bsize);
+    hpx_addr_t to = hpx_addr_add(exchange, Exchange::Value(id, bytes), bsize);
+    dbg_check( hpx_gas_memput_lsync(to, row + j * bytes, bytes, exchange) );
+  }
+}
+
+/// Gather the row for the participant at the pinned @p block.
+hpx_status_t
+GatherRow(char* block, size_t size, void* out)
+{
+  uint64_t epoch = Counts(block, size).gathered.fetch_add(1);
+  return ExchangeAt(block, epoch, size).get(size, out, 1);
+}
+}
+
+Exchange::Exchange(unsigned inputs, size_t size)
+    : LCO(LCO_ALLTOALL),
+      full_(),
+      inputs_(inputs),
+      size_(size),
+      count_(inputs)
+{
+  dbg_assert(inputs && size % inputs == 0);
+}
+
+int
+Exchange::set(size_t, const void*)
+{
+  std::lock_guard<LCO> _(*this);
+  dbg_assert_str(count_, "alltoall: too many elements arrived.\n");
+  if (--count_) {
+    return 0;
+  }
+  full_.signalAll();
+  return 1;
+}
+
+hpx_status_t
+Exchange::attach(hpx_parcel_t *p)
+{
+  std::lock_guard<LCO> _(*this);
+  if (count_) {
+    return AttachTo(full_, p);
+  }
+
+  if (auto status = full_.getError()) {
+    parcel_delete(p);
+    return status;
+  }
+
+  parcel_launch(p);
+  return HPX_SUCCESS;
+}
+
+hpx_status_t
+Exchange::get(size_t size, void *out, int reset)
+{
+  dbg_assert(!size || size == size_);
+  std::lock_guard<LCO> _(*this);
+  while (count_) {
+    if (auto status = waitFor(full_)) {
+      return status;
+    }
+  }
+
+  if (auto status = full_.getError()) {
+    return status;
+  }
+
+  if (size && out) {
+    memcpy(out, value_, size);
+  }
+
+  if (reset) {
+    count_ = inputs_;
+  }
+  return HPX_SUCCESS;
+}
+
+hpx_status_t
+Exchange::getRef(size_t size, void **out, int *unpin)
+{
+  dbg_assert(size == size_ && out);
+  if (auto status = wait(0)) {
+    return status;
+  }
+  *out = value_;
+  *unpin = 0;
+  return HPX_SUCCESS;
+}
+
+bool
+Exchange::release(void *out)
+{
+  dbg_assert(out == value_);
+  return true;
+}
+
+int
+Exchange::NewHandler(char* block, unsigned inputs, size_t size)
+{
+  for (int i = 0; i < 2; ++i) {
+    new(&ExchangeAt(block, i, size)) Exchange(inputs, size);
+  }
+  Participant& counts = Counts(block, size);
+  new(&counts.scattered) std::atomic<uint64_t>(0);
+  new(&counts.gathered) std::atomic<uint64_t>(0);
+  LCO_LOG_NEW(hpx_thread_current_target(), block);
+  return HPX_SUCCESS;
+}
+
+int
+Exchange::ScatterHandler(char* block, const void* data, size_t n)
+{
+  auto args = static_cast<const ScatterArgs*>(data);
+  ScatterRow(args->base, block, args->id, n - sizeof(*args), args->row);
+  return HPX_SUCCESS;
+}
+
+int
+Exchange::GatherHandler(char* block, size_t size)
+{
+  // Steal the continuation and gather straight into its parcel, as in
+  // AllToAll::GetIdHandler().
+  auto*     p = self->getCurrentParcel();
+  auto target = p->c_target;
+  auto action = p->c_action;
+  auto    pid = p->pid;
+  auto*     c = parcel_new(target, action, 0, 0, pid, nullptr, size);
+  dbg_assert(c);
+  p->c_target = 0;
+  p->c_action = 0;
+  int rc = GatherRow(block, size, hpx_parcel_get_data(c));
+  parcel_launch_error(c, rc);
+  return HPX_SUCCESS;
+}
+
+hpx_addr_t
+hpx_lco_alltoall_pairwise_new(size_t inputs, size_t size)
+{
+  dbg_assert(inputs && inputs < UINT_MAX);
+  dbg_assert(size % inputs == 0);
+  unsigned in(inputs);
+  size_t bsize = Exchange::BlockSize(size);
+  hpx_addr_t base = lco_alloc_cyclic(in, bsize, 0);
+  if (!base) {
+    throw std::bad_alloc();
+  }
+
+  hpx_addr_t bcast = hpx_lco_and_new(in);
+  for (unsigned i = 0; i < in; ++i) {
+    hpx_addr_t node = hpx_addr_add(base, i * bsize, bsize);
+    dbg_check( hpx_call(node, NewExchange, bcast, &in, &size) );
+  }
+  hpx_lco_wait(bcast);
+  hpx_lco_delete_sync(bcast);
+  return base;
+}
+
+hpx_status_t
+hpx_lco_alltoall_pairwise_setid(hpx_addr_t base, unsigned id, int size,
+                                const void *value, hpx_addr_t lsync,
+                                hpx_addr_t rsync)
+{
+  dbg_assert(size > 0);
+  hpx_addr_t node = Node(base, id, size);
+  char* block = nullptr;
+  if (hpx_gas_try_pin(node, (void**)&block)) {
+    // The elements are put straight from the row, which must be registered
+    // (see hpx_gas_memput_lsync()). The remote path gets that from the parcel.
+    char* row = static_cast<char*>(hpx_malloc_registered(size));
+    dbg_assert(row);
+    memcpy(row, value, size);
+    ScatterRow(base, block, id, size, row);
+    hpx_free_registered(row);
+    hpx_gas_unpin(node);
+    hpx_lco_set(lsync, 0, NULL, HPX_NULL, HPX_NULL);
+    hpx_lco_set(rsync, 0, NULL, HPX_NULL, HPX_NULL);
+    return HPX_SUCCESS;
+  }
+
+  size_t bytes = sizeof(ScatterArgs) + size;
+  hpx_parcel_t *p = action_new_parcel(Scatter, node, rsync, hpx_lco_set_action,
+                                      2, nullptr, bytes);
+  auto& args = *static_cast<ScatterArgs*>(hpx_parcel_get_data(p));
+  args.base = base;
+  args.id = id;
+  memcpy(args.row, value, size);
+  hpx_parcel_send(p, lsync);
+  return HPX_SUCCESS;
+}
+
+hpx_status_t
+hpx_lco_alltoall_pairwise_getid(hpx_addr_t base, unsigned id, int size,
+                                void *value)
+{
+  dbg_assert(size > 0);
+  hpx_addr_t node = Node(base, id, size);
+  char* block = nullptr;
+  if (hpx_gas_try_pin(node, (void**)&block)) {
+    hpx_status_t status = GatherRow(block, size, value);
+    hpx_gas_unpin(node);
+    return status;
+  }
+  size_t n(size);
+  return hpx_call_sync(node, Gather, value, size, &n);
+}
@@ -30,6 +30,7 @@
 namespace {
 using libhpx::scheduler::Condition;
 using libhpx::scheduler::LCO;
+using libhpx::scheduler::lco_alloc_sharded;
 
 class And final : public LCO {
  public:
@@ -75,6 +76,11 @@ class And final : public LCO {
  private:
   void unlockedReset();
 
+  /// Check if the and has been triggered successfully without the lock.
+  bool triggered() const {
+    return !count_.load(std::memory_order_acquire) && !barrier_.closed();
+  }
+
   Condition      barrier_;                      //<! the condition
   std::atomic<int> count_;                      //<! the current count
   const int        value_;                      //<! the number of inputs
@@ -111,6 +117,12 @@ And::unlockedReset()
 hpx_status_t
 And::wait(int reset)
 {
+  // Once the count reaches zero every input has arrived, so a non-resetting
+  // wait can return without touching the lock.
+  if (!reset && triggered()) {
+    return HPX_SUCCESS;
+  }
+
   std::lock_guard<LCO> _(*this);
 
   hpx_status_t status = barrier_.getError();
@@ -135,9 +147,14 @@ And::wait(int reset)
 hpx_status_t
 And::attach(hpx_parcel_t *p)
 {
+  if (triggered()) {
+    return hpx_parcel_send(p, HPX_NULL);
+  }
+
   std::lock_guard<LCO> _(*this);
 
   if (hpx_status_t status = barrier_.getError()) {
+    parcel_delete(p);
     return status;
   }
 
@@ -145,7 +162,7 @@ And::attach(hpx_parcel_t *p)
     return hpx_parcel_send(p, HPX_NULL);
   }
 
-  return barrier_.push(p);
+  return AttachTo(barrier_, p);
 }
 
 int
@@ -230,3 +247,19 @@ hpx_lco_and_local_array_new(int n, int limit)
   return base;
 }
 
+hpx_addr_t
+hpx_lco_and_sharded_array_new(int n, int limit, hpx_affinity_policy_t policy)
+{
+  size_t bsize;
+  hpx_addr_t base = lco_alloc_sharded(n, sizeof(And), policy, bsize);
+
+  hpx_addr_t bcast = hpx_lco_and_new(n);
+  for (int i = 0, e = n; i < e; ++i) {
+    hpx_addr_t addr = hpx_addr_add(base, i * bsize, bsize);
+    dbg_check( hpx_call(addr, New, bcast, &limit) );
+  }
+  hpx_lco_wait(bcast);
+  hpx_lco_delete_sync(bcast);
+  return base;
+}
+
@@ -0,0 +1,333 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/// @file libhpx/scheduler/lco/Batch.cpp
+/// @brief Implements hpx_lco_wait_all() and hpx_lco_get_all().
+///
+/// Remote LCOs are grouped by owner, and each owner gets a single request that
+/// attaches a continuation to each of its LCOs. The continuations write their
+/// statuses and values directly into one reply parcel, which is sent back when
+/// the last one runs. The caller waits once, for all of the replies.
+
+#include "LCO.h"
+#include "libhpx/action.h"
+#include "libhpx/debug.h"
+#include "libhpx/GAS.h"
+#include "libhpx/locality.h"
+#include "libhpx/parcel.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+using libhpx::scheduler::LCO;
+
+/// One LCO in a batched request.
+struct Entry {
+  hpx_addr_t   lco;
+  uint64_t    size;                             //!< 0 for a wait
+  uint64_t  offset;                             //!< offset of the value
+};
+
+/// The header of a batched request, followed by the entries.
+struct Request {
+  uint64_t      dst;                            //!< reply buffer at the source
+  hpx_addr_t   done;                            //!< set when dst is written
+  uint32_t      src;
+  uint32_t        n;
+  uint64_t    bytes;                            //!< bytes in the reply data
+  Entry   entries[];
+};
+
+/// The header of a batched reply, followed by the statuses and values.
+struct Reply {
+  uint64_t      dst;
+  hpx_addr_t   done;
+  char       data[];
+};
+
+/// The number of bytes used for @p n statuses at the front of the reply data.
+size_t
+StatusBytes(unsigned n)
+{
+  return (n * sizeof(hpx_status_t) + 7) & ~size_t(7);
+}
+
+/// The state of a batched request at the LCOs' locality.
+class Batch {
+ public:
+  Batch(const Request& request);
+
+  /// Attach a continuation to each of the LCOs.
+  void start();
+
+  /// Get the value of entry @p i once its LCO has triggered.
+  void get(unsigned i);
+
+  static int RequestHandler(const Request* request, size_t n);
+  static int GetHandler(Batch* batch, unsigned i);
+  static int ReplyHandler(const Reply* reply, size_t n);
+
+ private:
+  void finish(unsigned i, hpx_status_t status);
+
+  Reply* reply() {
+    return static_cast<Reply*>(hpx_parcel_get_data(reply_));
+  }
+
+  hpx_status_t* statuses() {
+    return reinterpret_cast<hpx_status_t*>(reply()->data);
+  }
+
+  char* values() {
+    return reply()->data + StatusBytes(entries_.size());
+  }
+
+  std::atomic<unsigned> remaining_;
+  std::vector<Entry>      entries_;
+  hpx_parcel_t             *reply_;
+};
+
+LIBHPX_ACTION(HPX_DEFAULT, HPX_MARSHALLED, BatchRequest,
+              Batch::RequestHandler, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, 0, BatchGet, Batch::GetHandler, HPX_POINTER,
+              HPX_UINT);
+LIBHPX_ACTION(HPX_INTERRUPT, HPX_MARSHALLED, BatchReply,
+              Batch::ReplyHandler, HPX_POINTER, HPX_SIZE_T);
+}
+
+Batch::Batch(const Request& request)
+    : remaining_(request.n),
+      entries_(request.entries, request.entries + request.n),
+      reply_(hpx_parcel_acquire(NULL, sizeof(Reply) + request.bytes))
+{
+  reply()->dst = request.dst;
+  reply()->done = request.done;
+  reply_->target = HPX_THERE(request.src);
+  reply_->action = BatchReply;
+}
+
+void
+Batch::start()
+{
+  for (unsigned i = 0, e = entries_.size(); i < e; ++i) {
+    Batch* batch = this;
+    hpx_addr_t gva = entries_[i].lco;
+    hpx_parcel_t *p = action_new_parcel(BatchGet, HPX_HERE, 0, 0, 2, &batch,
+                                        &i);
+
+    // If the LCO moved after the request was sent then the continuation just
+    // runs right away and gets the value remotely.
+    LCO *lco = nullptr;
+    if (!hpx_gas_try_pin(gva, (void**)&lco)) {
+      parcel_launch(p);
+      continue;
+    }
+
+    // An LCO in an error state releases the parcel and returns the error,
+    // which we report in its place.
+    hpx_status_t status = lco->attach(p);
+    hpx_gas_unpin(gva);
+    if (status != HPX_SUCCESS) {
+      finish(i, status);
+    }
+  }
+}
+
+void
+Batch::get(unsigned i)
+{
+  const Entry& e = entries_[i];
+  hpx_status_t status = (e.size) ? hpx_lco_get(e.lco, e.size,
+                                               values() + e.offset)
+                                 : hpx_lco_wait(e.lco);
+  finish(i, status);
+}
+
+void
+Batch::finish(unsigned i, hpx_status_t status)
+{
+  statuses()[i] = status;
+  if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    dbg_check( hpx_parcel_send(reply_, HPX_NULL) );
+    delete this;
+  }
+}
+
+int
+Batch::RequestHandler(const Request* request, size_t n)
+{
+  dbg_assert(n == sizeof(*request) + request->n * sizeof(Entry));
+  dbg_assert(request->n);
+  Batch* batch = new Batch(*request);
+  batch->start();
+  return HPX_SUCCESS;
+}
+
+int
+Batch::GetHandler(Batch* batch, unsigned i)
+{
+  batch->get(i);
+  return HPX_SUCCESS;
+}
+
+int
+Batch::ReplyHandler(const Reply* reply, size_t n)
+{
+  void* dst = reinterpret_cast<void*>(reply->dst);
+  memcpy(dst, reply->data, n - sizeof(*reply));
+  hpx_lco_set(reply->done, 0, NULL, HPX_NULL, HPX_NULL);
+  return HPX_SUCCESS;
+}
+
+/// The common implementation of hpx_lco_wait_all() and hpx_lco_get_all().
+///
+/// @p sizes is NULL for hpx_lco_wait_all().
+static int
+_all(int n, hpx_addr_t lcos[], size_t sizes[], void *values[],
+     hpx_status_t statuses[])
+{
+  dbg_assert(n > 0);
+
+  // The entries for each remote locality, and the buffer their reply is
+  // written to.
+  struct Pending {
+    std::vector<int>           index;
+    std::unique_ptr<char[]>   buffer;
+    size_t                     bytes;
+  };
+
+  // Pin the local lcos, and group the rest by owner. We don't use the stack
+  // because we can't control how big @p n gets.
+  std::unique_ptr<LCO*[]> locals(new LCO*[n]());
+  std::vector<Pending> pending(here->ranks);
+  unsigned batches = 0;
+  for (int i = 0; i < n; ++i) {
+    if (lcos[i] == HPX_NULL) {
+      continue;
+    }
+    if (hpx_gas_try_pin(lcos[i], (void**)&locals[i])) {
+      continue;
+    }
+    locals[i] = nullptr;
+    Pending& p = pending[here->gas->owner(lcos[i])];
+    batches += p.index.empty();
+    p.index.push_back(i);
+  }
+
+  // Send one request per locality.
+  hpx_addr_t done = (batches) ? hpx_lco_and_new(batches) : HPX_NULL;
+  for (unsigned rank = 0, e = pending.size(); rank < e; ++rank) {
+    Pending& p = pending[rank];
+    if (p.index.empty()) {
+      continue;
+    }
+
+    unsigned m = p.index.size();
+    hpx_parcel_t *parcel = hpx_parcel_acquire(NULL, sizeof(Request) +
+                                              m * sizeof(Entry));
+    Request *request = static_cast<Request*>(hpx_parcel_get_data(parcel));
+    uint64_t offset = 0;
+    for (unsigned k = 0; k < m; ++k) {
+      int i = p.index[k];
+      uint64_t size = (sizes) ? sizes[i] : 0;
+      request->entries[k].lco = lcos[i];
+      request->entries[k].size = size;
+      request->entries[k].offset = offset;
+      offset += (size + 7) & ~uint64_t(7);
+    }
+
+    p.bytes = StatusBytes(m) + offset;
+    p.buffer.reset(new char[p.bytes]);
+    request->dst = reinterpret_cast<uint64_t>(p.buffer.get());
+    request->done = done;
+    request->src = here->rank;
+    request->n = m;
+    request->bytes = p.bytes;
+
+    parcel->target = HPX_THERE(rank);
+    parcel->action = BatchRequest;
+    dbg_check( hpx_parcel_send(parcel, HPX_NULL) );
+  }
+
+  // Wait on the local lcos while the remote requests are outstanding.
+  int errors = 0;
+  for (int i = 0; i < n; ++i) {
+    hpx_status_t status = HPX_SUCCESS;
+    if (locals[i] != NULL) {
+      status = (sizes) ? locals[i]->get(sizes[i], values[i], 0)
+                       : locals[i]->wait(0);
+      hpx_gas_unpin(lcos[i]);
+    }
+
+    if (status != HPX_SUCCESS) {
+      ++errors;
+    }
+
+    if (statuses) {
+      statuses[i] = status;
+    }
+  }
+
+  if (!batches) {
+    return errors;
+  }
+
+  // Wait for all of the replies, and then scatter the results.
+  hpx_lco_wait(done);
+  hpx_lco_delete(done, HPX_NULL);
+
+  for (const Pending& p : pending) {
+    unsigned m = p.index.size();
+    const hpx_status_t *results =
+        reinterpret_cast<const hpx_status_t*>(p.buffer.get());
+    const char *value = p.buffer.get() + StatusBytes(m);
+    for (unsigned k = 0; k < m; ++k) {
+      int i = p.index[k];
+      hpx_status_t status = results[k];
+      size_t size = (sizes) ? sizes[i] : 0;
+      if (status == HPX_SUCCESS && size && values[i]) {
+        memcpy(values[i], value, size);
+      }
+      value += (size + 7) & ~size_t(7);
+
+      if (status != HPX_SUCCESS) {
+        ++errors;
+      }
+
+      if (statuses) {
+        statuses[i] = status;
+      }
+    }
+  }
+
+  return errors;
+}
+
+int
+hpx_lco_wait_all(int n, hpx_addr_t lcos[], hpx_status_t statuses[])
+{
+  return _all(n, lcos, NULL, NULL, statuses);
+}
+
+int
+hpx_lco_get_all(int n, hpx_addr_t lcos[], size_t sizes[], void *values[],
+                hpx_status_t statuses[])
+{
+  return _all(n, lcos, sizes, values, statuses);
+}
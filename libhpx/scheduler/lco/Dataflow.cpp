@@ -17,34 +17,64 @@
 
 /// @file libhpx/scheduler/dataflow.c
 /// @brief A dataflow LCO.
+///
+/// Besides the legacy hpx_lco_dataflow_add() interface, the dataflow LCO is a
+/// reusable task graph. Each task lives in its own global allocation, at the
+/// locality where it runs, and keeps a pending parcel with room for all of its
+/// inputs. Producers write their outputs straight into their consumers'
+/// pending parcels, and an atomic count of missing inputs launches the parcel
+/// when it reaches zero. A task arms a fresh parcel before it runs, so the
+/// graph is ready for the next run by the time the current one finishes. The
+/// LCO itself only tracks the graph's shape and counts the completed sinks.
+///
+/// Tasks can be added concurrently, so the edges are recorded in the LCO,
+/// under its lock, and each producer is sent its new edges in a single message
+/// when the graph next runs.
 #include "LCO.h"
 #include "Condition.h"
 #include "libhpx/action.h"
 #include "libhpx/debug.h"
+#include "libhpx/GAS.h"
+#include "libhpx/locality.h"
+#include "libhpx/parcel.h"
 #include "hpx/hpx.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace {
 using libhpx::scheduler::Condition;
 using libhpx::scheduler::LCO;
 
+/// An edge from a producer to the input at @p offset of its consumer @p task.
+struct Edge {
+  hpx_addr_t   task;
+  uint32_t   offset;
+};
+
+/// The arguments for adding a task, followed by the input task ids.
+struct TaskArgs {
+  hpx_action_t action;
+  uint32_t          n;
+  uint64_t       size;
+  hpx_addr_t       at;
+  int32_t    inputs[];
+};
+
 class Dataflow final : public LCO {
  public:
-  Dataflow() : LCO(LCO_DATAFLOW), cvar_() {
+  Dataflow() : LCO(LCO_DATAFLOW), cvar_(), tasks_(), remaining_(0) {
   }
 
-  ~Dataflow() {
-    lock();                                     // released in ~LCO()
-  }
+  ~Dataflow();
 
   hpx_status_t get(size_t size, void *value, int reset);
   hpx_status_t attach(hpx_parcel_t *p);
 
-  int set(size_t size, const void *value) {
-    // @todo: why doesn't this do anything at all?
-    std::lock_guard<LCO> _(*this);
-    return HPX_SUCCESS;
-  }
+  /// Each set counts one completed sink task of the graph.
+  int set(size_t size, const void *value);
 
   void error(hpx_status_t code) {
     std::lock_guard<LCO> _(*this);
@@ -71,16 +101,105 @@ class Dataflow final : public LCO {
     auto lco = new(buffer) Dataflow();
     return HPX_THREAD_CONTINUE(lco);
   }
+
+  static int AddTaskHandler(Dataflow* lco, const TaskArgs* args, size_t n);
+  static int RunGraphHandler(Dataflow* lco);
+  static int LookupHandler(Dataflow* lco, int id);
   /// @}
 
  private:
+  /// Add a task to the graph, and return its id.
+  int addTask(const TaskArgs& args);
+
+  /// Start a run of the graph.
+  void run();
+
   void resetCondition() {
     log_lco("resetting dataflow LCO %p\n", this);
     resetTriggered();
     cvar_.reset();
+    remaining_ = 0;
   }
 
-  Condition cvar_;
+  /// What the LCO knows about each task.
+  struct Record {
+    hpx_addr_t       task;
+    uint32_t         rank;
+    uint32_t       inputs;
+    uint32_t    consumers;
+    size_t           size;
+    std::vector<Edge> added;                    //<! not yet sent to the task
+  };
+
+  Condition               cvar_;
+  std::vector<Record>    tasks_;
+  unsigned           remaining_;                //<! sinks left in this run
+};
+
+/// One task in a dataflow graph.
+class Task {
+ public:
+  Task(hpx_addr_t graph, hpx_addr_t self, hpx_action_t action, size_t size,
+       size_t bytes, unsigned n, const uint32_t offsets[]);
+
+  ~Task() {
+    parcel_delete(pending_);
+  }
+
+  /// The number of bytes to allocate for a task with an output of @p size.
+  static size_t Bytes(size_t size) {
+    return sizeof(Task) + size;
+  }
+
+  /// Static action interface.
+  /// @{
+  struct NewArgs {
+    hpx_addr_t     graph;
+    hpx_action_t  action;
+    uint32_t           n;
+    uint64_t        size;
+    uint64_t       bytes;
+    uint32_t offsets[];
+  };
+
+  struct Input {
+    uint32_t  offset;
+    alignas(16) char value[];
+  };
+
+  static int NewHandler(void* buffer, const NewArgs* args, size_t n);
+  static int AddConsumersHandler(Task* task, const Edge* edges, size_t n);
+  static int StartHandler(Task* task);
+  static int ExecuteHandler(Task* task, char* inputs, size_t n);
+  static int FanoutHandler(Task* task, const void* value, size_t n);
+  static int ReceiveHandler(Task* task, const Input* input, size_t n);
+  static int GetOutputHandler(Task* task);
+  static int DeleteHandler(void);
+  /// @}
+
+ private:
+  /// Allocate the parcel that collects the inputs for the next run.
+  void arm();
+
+  /// Write an input into the pending parcel, and launch it if it was the last.
+  void receive(uint32_t offset, const void* value, size_t bytes);
+
+  /// Run the task's action on its inputs.
+  int execute(char* inputs);
+
+  /// Send the output to each consumer, or keep it if this is a sink.
+  void fanout(const void* value, size_t bytes);
+
+  const hpx_addr_t             graph_;
+  const hpx_addr_t              self_;
+  const hpx_action_t          action_;
+  const size_t                  size_;          //<! output bytes
+  const size_t                 bytes_;          //<! input bytes
+  const std::vector<uint32_t> offsets_;
+  std::vector<Edge>         consumers_;
+  std::atomic<unsigned>     remaining_;         //<! inputs still missing
+  hpx_parcel_t               *pending_;
+  alignas(16) char           output_[];         //<! a sink's output
 };
 
 /// Class that manages the dataflow run operation.
@@ -107,12 +226,337 @@ class RunOp {
 
 LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, New, Dataflow::NewHandler, HPX_POINTER);
 LIBHPX_ACTION(HPX_DEFAULT, HPX_MARSHALLED, Run, RunOp::Handler, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED | HPX_MARSHALLED, AddTask,
+              Dataflow::AddTaskHandler, HPX_POINTER, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, RunGraph, Dataflow::RunGraphHandler,
+              HPX_POINTER);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, Lookup, Dataflow::LookupHandler,
+              HPX_POINTER, HPX_INT);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED | HPX_MARSHALLED, NewTask,
+              Task::NewHandler, HPX_POINTER, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED | HPX_MARSHALLED, AddConsumers,
+              Task::AddConsumersHandler, HPX_POINTER, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, StartTask, Task::StartHandler,
+              HPX_POINTER);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED | HPX_MARSHALLED, Execute,
+              Task::ExecuteHandler, HPX_POINTER, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED | HPX_MARSHALLED, Fanout,
+              Task::FanoutHandler, HPX_POINTER, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED | HPX_MARSHALLED, Receive,
+              Task::ReceiveHandler, HPX_POINTER, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, GetOutput, Task::GetOutputHandler,
+              HPX_POINTER);
+LIBHPX_ACTION(HPX_DEFAULT, 0, DeleteTask, Task::DeleteHandler);
+
+/// Pad an input to keep the next one aligned.
+size_t
+Align(size_t bytes)
+{
+  return (bytes + 15) & ~size_t(15);
+}
+
+/// Deliver @p bytes of @p value to the input at @p offset of @p task.
+void
+Deliver(hpx_addr_t task, uint32_t offset, const void* value, size_t bytes)
+{
+  hpx_parcel_t *p = hpx_parcel_acquire(NULL, sizeof(Task::Input) + bytes);
+  auto input = static_cast<Task::Input*>(hpx_parcel_get_data(p));
+  input->offset = offset;
+  memcpy(input->value, value, bytes);
+  p->target = task;
+  p->action = Receive;
+  dbg_check( hpx_parcel_send(p, HPX_NULL) );
+}
+}
+
+Dataflow::~Dataflow()
+{
+  for (const Record& r : tasks_) {
+    dbg_check( hpx_call(r.task, DeleteTask, HPX_NULL) );
+  }
+  lock();                                       // released in ~LCO()
+}
+
+int
+Dataflow::set(size_t, const void*)
+{
+  std::lock_guard<LCO> _(*this);
+  if (!remaining_ || --remaining_) {
+    return 0;
+  }
+  setTriggered();
+  cvar_.signalAll();
+  return 1;
+}
+
+int
+Dataflow::addTask(const TaskArgs& args)
+{
+  // Pick the locality and the input layout. Without an explicit location the
+  // task runs next to its largest input, or here if it has no inputs.
+  std::unique_ptr<uint32_t[]> offsets(new uint32_t[args.n]);
+  uint32_t rank = (args.at) ? here->gas->owner(args.at) : here->rank;
+  size_t bytes = 0;
+  {
+    std::lock_guard<LCO> _(*this);
+    size_t largest = 0;
+    for (unsigned i = 0; i < args.n; ++i) {
+      dbg_assert(0 <= args.inputs[i] && args.inputs[i] < int(tasks_.size()));
+      const Record& r = tasks_[args.inputs[i]];
+      offsets[i] = bytes;
+      bytes += Align(r.size);
+      if (!args.at && r.size >= largest) {
+        largest = r.size;
+        rank = r.rank;
+      }
+    }
+  }
+
+  size_t size = args.size;
+  hpx_addr_t task = hpx_gas_alloc_local_at_sync(1, Task::Bytes(size), 0,
+                                                HPX_THERE(rank));
+  if (!task) {
+    dbg_error("dataflow: could not allocate a task.\n");
+  }
+
+  size_t n = sizeof(Task::NewArgs) + args.n * sizeof(uint32_t);
+  std::unique_ptr<char[]> buffer(new char[n]);
+  auto& init = *reinterpret_cast<Task::NewArgs*>(buffer.get());
+  init.graph = hpx_thread_current_target();
+  init.action = args.action;
+  init.n = args.n;
+  init.size = size;
+  init.bytes = bytes;
+  memcpy(init.offsets, offsets.get(), args.n * sizeof(uint32_t));
+  dbg_check( hpx_call_sync(task, NewTask, nullptr, 0, &init, n) );
+
+  std::lock_guard<LCO> _(*this);
+  for (unsigned i = 0; i < args.n; ++i) {
+    Record& r = tasks_[args.inputs[i]];
+    r.consumers++;
+    r.added.push_back({task, offsets[i]});
+  }
+  tasks_.push_back({task, rank, args.n, 0, size, {}});
+  return tasks_.size() - 1;
+}
+
+void
+Dataflow::run()
+{
+  std::vector<hpx_addr_t> sources;
+  std::vector<std::pair<hpx_addr_t, std::vector<Edge>>> added;
+  {
+    std::lock_guard<LCO> _(*this);
+    dbg_assert_str(!remaining_, "dataflow: graph is already running.\n");
+    resetCondition();
+    for (Record& r : tasks_) {
+      if (!r.inputs) {
+        sources.push_back(r.task);
+      }
+      if (!r.consumers) {
+        ++remaining_;
+      }
+      if (!r.added.empty()) {
+        added.emplace_back(r.task, std::move(r.added));
+        r.added.clear();
+      }
+    }
+
+    if (!remaining_) {
+      setTriggered();
+      cvar_.signalAll();
+      return;
+    }
+  }
+
+  // Each producer gets one message, so they never add consumers concurrently.
+  if (!added.empty()) {
+    hpx_addr_t done = hpx_lco_and_new(added.size());
+    for (const auto& a : added) {
+      const std::vector<Edge>& edges = a.second;
+      dbg_check( hpx_call(a.first, AddConsumers, done, edges.data(),
+                          edges.size() * sizeof(Edge)) );
+    }
+    hpx_lco_wait(done);
+    hpx_lco_delete_sync(done);
+  }
+
+  for (hpx_addr_t task : sources) {
+    dbg_check( hpx_call(task, StartTask, HPX_NULL) );
+  }
+}
+
+int
+Dataflow::AddTaskHandler(Dataflow* lco, const TaskArgs* args, size_t n)
+{
+  dbg_assert(n == sizeof(*args) + args->n * sizeof(args->inputs[0]));
+  int id = lco->addTask(*args);
+  return HPX_THREAD_CONTINUE(id);
+}
+
+int
+Dataflow::RunGraphHandler(Dataflow* lco)
+{
+  lco->run();
+  return HPX_SUCCESS;
+}
+
+int
+Dataflow::LookupHandler(Dataflow* lco, int id)
+{
+  hpx_addr_t task = HPX_NULL;
+  {
+    std::lock_guard<LCO> _(*lco);
+    dbg_assert(0 <= id && id < int(lco->tasks_.size()));
+    task = lco->tasks_[id].task;
+  }
+  return HPX_THREAD_CONTINUE(task);
+}
+
+Task::Task(hpx_addr_t graph, hpx_addr_t self, hpx_action_t action,
+           size_t size, size_t bytes, unsigned n, const uint32_t offsets[])
+    : graph_(graph),
+      self_(self),
+      action_(action),
+      size_(size),
+      bytes_(bytes),
+      offsets_(offsets, offsets + n),
+      consumers_(),
+      remaining_(0),
+      pending_(nullptr)
+{
+  arm();
+}
+
+void
+Task::arm()
+{
+  pending_ = action_new_parcel(Execute, self_, self_, Fanout, 2, nullptr,
+                               bytes_);
+  remaining_.store(offsets_.size(), std::memory_order_release);
+}
+
+void
+Task::receive(uint32_t offset, const void* value, size_t bytes)
+{
+  hpx_parcel_t *p = pending_;
+  char *inputs = static_cast<char*>(hpx_parcel_get_data(p));
+  memcpy(inputs + offset, value, bytes);
+  if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    parcel_launch(p);
+  }
+}
+
+int
+Task::execute(char* inputs)
+{
+  // The current parcel is the one we're running from, so arm its replacement
+  // before any of our consumers can run and complete the graph.
+  arm();
+
+  unsigned n = offsets_.size();
+  std::unique_ptr<void*[]> values(new void*[n]);
+  for (unsigned i = 0; i < n; ++i) {
+    values[i] = inputs + offsets_[i];
+  }
+
+  hpx_action_handler_t handler = hpx_action_get_handler(action_);
+  return handler(&values[0], n);
+}
+
+void
+Task::fanout(const void* value, size_t bytes)
+{
+  dbg_assert_str(bytes == size_, "dataflow: task output has the wrong size.\n");
+  if (consumers_.empty()) {
+    memcpy(output_, value, bytes);
+    hpx_lco_set(graph_, 0, NULL, HPX_NULL, HPX_NULL);
+    return;
+  }
+
+  for (const Edge& e : consumers_) {
+    Task* task = nullptr;
+    if (hpx_gas_try_pin(e.task, (void**)&task)) {
+      task->receive(e.offset, value, bytes);
+      hpx_gas_unpin(e.task);
+    }
+    else {
+      Deliver(e.task, e.offset, value, bytes);
+    }
+  }
+}
+
+int
+Task::NewHandler(void* buffer, const NewArgs* args, size_t n)
+{
+  dbg_assert(n == sizeof(*args) + args->n * sizeof(args->offsets[0]));
+  hpx_addr_t self = hpx_thread_current_target();
+  new(buffer) Task(args->graph, self, args->action, args->size, args->bytes,
+                   args->n, args->offsets);
+  return HPX_SUCCESS;
+}
+
+int
+Task::AddConsumersHandler(Task* task, const Edge* edges, size_t n)
+{
+  dbg_assert(n % sizeof(Edge) == 0);
+  task->consumers_.insert(task->consumers_.end(), edges,
+                          edges + n / sizeof(Edge));
+  return HPX_SUCCESS;
+}
+
+int
+Task::StartHandler(Task* task)
+{
+  dbg_assert(task->offsets_.empty());
+  parcel_launch(task->pending_);
+  return HPX_SUCCESS;
+}
+
+int
+Task::ExecuteHandler(Task* task, char* inputs, size_t n)
+{
+  dbg_assert(n == task->bytes_);
+  return task->execute(inputs);
+}
+
+int
+Task::FanoutHandler(Task* task, const void* value, size_t n)
+{
+  task->fanout(value, n);
+  return HPX_SUCCESS;
+}
+
+int
+Task::ReceiveHandler(Task* task, const Input* input, size_t n)
+{
+  task->receive(input->offset, input->value, n - sizeof(*input));
+  return HPX_SUCCESS;
+}
+
+int
+Task::GetOutputHandler(Task* task)
+{
+  return hpx_thread_continue(task->output_, task->size_);
+}
+
+int
+Task::DeleteHandler(void)
+{
+  hpx_addr_t gva = hpx_thread_current_target();
+  Task* task = nullptr;
+  if (hpx_gas_try_pin(gva, (void**)&task)) {
+    task->~Task();
+    hpx_gas_unpin(gva);
+  }
+  return hpx_call_cc(gva, hpx_gas_free_action);
 }
 
 hpx_status_t
 Dataflow::attach(hpx_parcel_t *p) {
   std::lock_guard<LCO> _(*this);
   if (hpx_status_t status = cvar_.getError()) {
+    parcel_delete(p);
     return status;
   }
 
@@ -120,7 +564,7 @@ Dataflow::attach(hpx_parcel_t *p) {
     return hpx_parcel_send(p, HPX_NULL);
   }
 
-  return cvar_.push(p);
+  return AttachTo(cvar_, p);
 }
 
 /// Invoke a get operation on the dataflow LCO.
@@ -220,3 +664,44 @@ _hpx_lco_dataflow_add(hpx_addr_t lco, hpx_action_t action, hpx_addr_t out,
   hpx_parcel_send(p, HPX_NULL);
   return HPX_SUCCESS;
 }
+
+int
+hpx_lco_dataflow_task(hpx_addr_t lco, hpx_action_t action, size_t size, int n,
+                      const int inputs[], hpx_addr_t at)
+{
+  dbg_assert(n >= 0);
+  dbg_assert(!n || inputs);
+  size_t bytes = sizeof(TaskArgs) + n * sizeof(int32_t);
+  std::unique_ptr<char[]> buffer(new char[bytes]);
+  auto& args = *reinterpret_cast<TaskArgs*>(buffer.get());
+  args.action = action;
+  args.n = n;
+  args.size = size;
+  args.at = at;
+  for (int i = 0; i < n; ++i) {
+    args.inputs[i] = inputs[i];
+  }
+
+  int id = -1;
+  if (hpx_call_sync(lco, AddTask, &id, sizeof(id), &args, bytes)) {
+    return -1;
+  }
+  return id;
+}
+
+hpx_status_t
+hpx_lco_dataflow_run(hpx_addr_t lco)
+{
+  return hpx_call_sync(lco, RunGraph, nullptr, 0);
+}
+
+hpx_status_t
+hpx_lco_dataflow_get_output(hpx_addr_t lco, int task, size_t size, void *out)
+{
+  hpx_addr_t gva = HPX_NULL;
+  if (hpx_status_t status = hpx_call_sync(lco, Lookup, &gva, sizeof(gva),
+                                          &task)) {
+    return status;
+  }
+  return hpx_call_sync(gva, GetOutput, out, size);
+}
@@ -23,7 +23,10 @@
 #include "hpx/builtins.h"
 #include "libhpx/action.h"
 #include "libhpx/debug.h"
+#include "libhpx/events.h"
+#include "libhpx/instrumentation.h"
 #include "libhpx/memory.h"
+#include <atomic>
 #include <cstring>
 #include <mutex>
 #include <new>
@@ -31,6 +34,7 @@
 namespace {
 using libhpx::scheduler::Condition;
 using libhpx::scheduler::LCO;
+using libhpx::scheduler::lco_alloc_sharded;
 
 class Future final : public LCO
 {
@@ -48,9 +52,7 @@ class Future final : public LCO
   hpx_status_t attach(hpx_parcel_t *p);
 
   void error(hpx_status_t code) {
-    std::lock_guard<LCO> _(*this);
-    setTriggered();
-    full_.signalError(code);
+    full_.close(code);
   }
 
   hpx_status_t wait(int reset) {
@@ -61,6 +63,7 @@ class Future final : public LCO
     std::lock_guard<LCO> _(*this);
     resetFull();
   }
+
   size_t size(size_t bytes) const {
     return sizeof(Future) + bytes;
   }
@@ -79,22 +82,26 @@ class Future final : public LCO
  private:
   /// Reset the full condition.
   ///
-  /// This must be called while holding the LCO lock.
+  /// Futures have a single trigger transition, so the full condition is used
+  /// through its lock-free interface and a closed full condition means the
+  /// future is triggered. A setter claims the future before it writes the
+  /// value, and the claim is only released here, once the condition is open
+  /// again, so the value can't be overwritten while it's being read. Resets
+  /// are serialized by the LCO lock, which must be held.
   void resetFull() {
     log_lco("resetting future %p\n", (void*)this);
-    resetTriggered();
     full_.reset();
+    claimed_.store(false, std::memory_order_release);
   }
 
   /// Wait until the full condition is true.
-  ///
-  /// This must be called while holding the LCO lock.
   hpx_status_t waitFull() {
-    return (getTriggered()) ? full_.getError() : waitFor(full_);
+    return (full_.closed()) ? full_.getError() : waitForUnlocked(full_);
   }
 
-  Condition full_;
-  char   value_[];
+  Condition            full_;
+  std::atomic<bool> claimed_;                   //!< a setter owns the value
+  char              value_[];
 };
 
 LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, New, Future::NewHandler, HPX_POINTER,
@@ -105,7 +112,8 @@ LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, NewBlock, Future::NewBlockHandler,
 
 Future::Future(size_t size)
     : LCO(LCO_FUTURE),
-      full_()
+      full_(),
+      claimed_(false)
 {
   log_lco("initializing future %p\n", (void*)this);
   if (size) {
@@ -120,15 +128,13 @@ Future::Future(size_t size)
 int
 Future::set(size_t size, const void *from)
 {
-  std::lock_guard<LCO> _(*this);
-
   DEBUG_IF (size && !getUser()) {
     dbg_error("setting 0-sized future with %zu bytes\n", size);
   }
 
   log_lco("setting future %p\n", (void*)this);
   // futures are write-once
-  if (setTriggered()) {
+  if (claimed_.exchange(true, std::memory_order_acquire)) {
     dbg_error("cannot set an already set future\n");
     return 0;
   }
@@ -137,36 +143,52 @@ Future::set(size_t size, const void *from)
     memcpy(value_, from, size);
   }
 
-  full_.signalAll();
+  // closing the condition publishes the value and wakes the waiters, it fails
+  // if the future was closed by an error in the meantime
+  if (!full_.close(HPX_SUCCESS)) {
+    return 0;
+  }
+  EVENT_LCO_TRIGGER((uintptr_t)this, 0);
   return 1;
 }
 
 /// Copies the appropriate value into @p out, waiting if the lco isn't set yet.
 hpx_status_t
 Future::get(size_t size, void *out, int reset) {
-  std::lock_guard<LCO> _(*this);
-
   DEBUG_IF (size && !getUser()) {
     dbg_error("getting %zu bytes from a 0-sized future\n", size);
   }
 
   log_lco("getting future %p (%zu bytes)\n", (void*)this, size);
+  dbg_assert((size && out) || (!size && !out));
 
-  if (hpx_status_t status = waitFull()) {
-    return status;
+  if (!reset) {
+    if (hpx_status_t status = waitFull()) {
+      return status;
+    }
+    if (size) {
+      memcpy(out, &value_, size);
+    }
+    return HPX_SUCCESS;
   }
 
-  if (size && out) {
-    memcpy(out, &value_, size);
-  }
-  else {
-    dbg_assert(!size && !out);
+  // Reading and resetting is atomic with respect to other resets, so wait for
+  // the future to be triggered while holding the lock, and wait again if some
+  // other thread reset it before we could get the lock back.
+  std::unique_lock<LCO> lock(*this);
+  while (!full_.closed()) {
+    lock.unlock();
+    waitFull();
+    lock.lock();
   }
 
-  if (reset) {
-    resetFull();
+  if (hpx_status_t status = full_.getError()) {
+    return status;
   }
-
+  if (size) {
+    memcpy(out, &value_, size);
+  }
+  resetFull();
   return HPX_SUCCESS;
 }
 
@@ -181,7 +203,7 @@ Future::getRef(size_t size, void **out, int *unpin)
     return status;
   }
 
-  // no need for a lock here, synchronization happened in _wait(), and the LCO
+  // no need for a lock here, synchronization happened in wait(), and the LCO
   // is pinned externally
   *out = value_;
   *unpin = 0;
@@ -202,10 +224,8 @@ Future::release(void *out)
 hpx_status_t
 Future::attach(hpx_parcel_t *p)
 {
-  std::lock_guard<LCO> _(*this);
-
-  if (!getTriggered()) {
-    return full_.push(p);
+  if (full_.tryPush(p)) {
+    return HPX_SUCCESS;
   }
 
   // If we have an error condition, then we release the parcel and return the
@@ -325,3 +345,23 @@ hpx_lco_future_local_array_new(int n, int size)
   hpx_lco_delete_sync(bcast);
   return base;
 }
+
+hpx_addr_t
+hpx_lco_future_sharded_array_new(int n, int size, hpx_affinity_policy_t policy)
+{
+  dbg_assert(n > 0);
+  dbg_assert(size > 0);
+  size_t bytes = unsigned(size);
+  size_t bsize;
+  hpx_addr_t base = lco_alloc_sharded(n, sizeof(Future) + bytes, policy, bsize);
+
+  unsigned one = 1;
+  hpx_addr_t bcast = hpx_lco_and_new(n);
+  for (int i = 0, e = n; i < e; ++i) {
+    hpx_addr_t addr = hpx_addr_add(base, i * bsize, bsize);
+    dbg_check( hpx_call(addr, NewBlock, bcast, &one, &bytes) );
+  }
+  hpx_lco_wait(bcast);
+  hpx_lco_delete_sync(bcast);
+  return base;
+}
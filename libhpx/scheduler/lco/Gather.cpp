@@ -127,12 +127,12 @@ Gather::attach(hpx_parcel_t *p)
   // Pick attach to mean "set" for gather. We have to wait for gathering to
   // complete before sending the parcel.
   if (wcount_ == writers_) {
-    return cvar_.push(p);
+    return AttachTo(cvar_, p);
   }
 
-  // If the gather has an error, then return that error without sending the
-  // parcel.
+  // If the gather has an error, then release the parcel and return the error.
   if (auto status = cvar_.getError()) {
+    parcel_delete(p);
     return status;
   }
 
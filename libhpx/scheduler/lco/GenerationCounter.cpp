@@ -23,6 +23,7 @@
 #include "libhpx/action.h"
 #include "libhpx/debug.h"
 #include "libhpx/memory.h"
+#include <atomic>
 #include <mutex>
 #include <cstring>
 
@@ -38,10 +39,22 @@ struct GenerationCounter final : public LCO {
   /// Wait for the specified generation.
   hpx_status_t waitForGeneration(unsigned long i);
 
+  /// Increment the generation.
+  ///
+  /// The increment is a single atomic operation and we only take the lock to
+  /// signal when there are waiting threads or attached parcels. Waiters
+  /// announce themselves in waiters_ before they check the generation, so
+  /// either the setter sees them or they see the new generation.
   int set(size_t size, const void *value) {
+    unsigned long i = gen_.fetch_add(1, std::memory_order_seq_cst) + 1;
+    if (!waiters_.load(std::memory_order_seq_cst)) {
+      return 1;
+    }
+
     std::lock_guard<LCO> _(*this);
-    unsigned long i = ++gen_;
     oflow_.signalAll();
+    waiters_ -= attached_;
+    attached_ = 0;
     if (ninplace_) {
       conditionAt(i % ninplace_).signalAll();
     }
@@ -54,13 +67,15 @@ struct GenerationCounter final : public LCO {
       conditionAt(i).signalError(code);
     }
     oflow_.signalError(code);
+    waiters_ -= attached_;
+    attached_ = 0;
   }
 
   hpx_status_t get(size_t size, void *out, int reset) {
-    // @note: No lock here... just a single volatile read is good enough.
+    // @note: No lock here... just a single atomic read is good enough.
     dbg_assert(!size || out);
     if (size) {
-      unsigned long i = gen_;                   // volatile read
+      unsigned long i = gen_.load(std::memory_order_acquire);
       memcpy(out, &i, size);
     }
     return HPX_SUCCESS;
@@ -68,12 +83,20 @@ struct GenerationCounter final : public LCO {
 
   hpx_status_t wait(int reset) {
     std::lock_guard<LCO> _(*this);
-    return waitFor(oflow_);
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    hpx_status_t status = waitFor(oflow_);
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return status;
   }
 
   hpx_status_t attach(hpx_parcel_t *p) {
     std::lock_guard<LCO> _(*this);
-    return oflow_.push(p);
+    if (hpx_status_t status = AttachTo(oflow_, p)) {
+      return status;
+    }
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    ++attached_;
+    return HPX_SUCCESS;
   }
 
   void reset() {
@@ -82,6 +105,8 @@ struct GenerationCounter final : public LCO {
       conditionAt(i).reset();
     }
     oflow_.reset();
+    waiters_ -= attached_;
+    attached_ = 0;
   }
 
   size_t size(size_t size) const {
@@ -106,10 +131,12 @@ struct GenerationCounter final : public LCO {
     return *reinterpret_cast<Condition*>(inplace_ + i * sizeof(Condition));
   }
 
-  Condition            oflow_;
-  volatile unsigned long gen_;
-  const unsigned    ninplace_;
-  char               inplace_[];
+  Condition                  oflow_;
+  std::atomic<unsigned long>   gen_;
+  std::atomic<unsigned>    waiters_;            //<! waiting threads + attached_
+  unsigned                attached_;            //<! parcels attached to oflow_
+  const unsigned          ninplace_;
+  char                     inplace_[];
 };
 
 LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, New, GenerationCounter::NewHandler,
@@ -121,7 +148,10 @@ LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, WaitForGeneration,
 
 GenerationCounter::GenerationCounter(unsigned ninplace)
     : LCO(LCO_GENCOUNT),
-      gen_(),
+      oflow_(),
+      gen_(0),
+      waiters_(0),
+      attached_(0),
       ninplace_(ninplace),
       inplace_()
 {
@@ -142,14 +172,17 @@ hpx_status_t
 GenerationCounter::waitForGeneration(unsigned long i)
 {
   std::lock_guard<LCO> _(*this);
-  while (gen_ < i) {
-    bool inplace = i < (gen_ + ninplace_);
+  waiters_.fetch_add(1, std::memory_order_seq_cst);
+  hpx_status_t status = HPX_SUCCESS;
+  for (unsigned long gen; (gen = gen_.load(std::memory_order_seq_cst)) < i;) {
+    bool inplace = i < (gen + ninplace_);
     Condition& cond = (inplace) ? conditionAt(i % ninplace_) : oflow_;
-    if (auto status = waitFor(cond)) {
-      return status;
+    if ((status = waitFor(cond))) {
+      break;
     }
   }
-  return oflow_.getError();
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+  return (status) ? status : oflow_.getError();
 }
 
 hpx_addr_t
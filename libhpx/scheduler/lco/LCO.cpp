@@ -18,10 +18,12 @@
 /// @file libhpx/scheduler/lco.cpp
 
 #include "LCO.h"
+#include "Condition.h"
 #include "Thread.h"                             //<! struct ustack
 #include "libhpx/action.h"
 #include "libhpx/attach.h"
 #include "libhpx/debug.h"
+#include "libhpx/events.h"
 #include "libhpx/instrumentation.h"
 #include "libhpx/memory.h"
 #include "libhpx/Network.h"
@@ -101,7 +103,7 @@ LCO::operator delete(void* obj)
 
 LCO::LCO(enum Type type) : lock_(), state_(), type_(type)
 {
-  trace_append(HPX_TRACE_LCO, TRACE_EVENT_LCO_INIT, this, state_);
+  EVENT_LCO_INIT((uintptr_t)this, state_);
 }
 
 /// Our infrastructure requires that the destructor run atomically with the rest
@@ -141,6 +143,24 @@ LCO::release(void *out)
   return true;                                     // unpin the LCO
 }
 
+hpx_addr_t
+LCO::detach()
+{
+  return HPX_NULL;
+}
+
+/// Free a deleted LCO once @p detached is set.
+static int
+_free_detached_handler(hpx_addr_t detached)
+{
+  hpx_lco_wait(detached);
+  hpx_lco_delete_sync(detached);
+  hpx_addr_t target = hpx_thread_current_target();
+  return hpx_call_cc(target, hpx_gas_free_action);
+}
+static LIBHPX_ACTION(HPX_DEFAULT, 0, _free_detached, _free_detached_handler,
+                     HPX_ADDR);
+
 /// Action LCO event handler wrappers.
 ///
 /// These try and pin the LCO, and then forward to the local event handler
@@ -151,8 +171,13 @@ LCO::release(void *out)
 int
 LCO::DeleteHandler(LCO *lco)
 {
+  hpx_addr_t detached = lco->detach();
   lco->~LCO();
   hpx_addr_t target = hpx_thread_current_target();
+  if (detached) {
+    // this is an interrupt, so the wait happens in a new thread
+    return hpx_call_cc(target, _free_detached, &detached);
+  }
   return hpx_call_cc(target, hpx_gas_free_action);
 }
 
@@ -250,7 +275,7 @@ LCO::unlock()
 short
 LCO::setTriggered()
 {
-  trace_append(HPX_TRACE_LCO, TRACE_EVENT_LCO_TRIGGER, this, state_);
+  EVENT_LCO_TRIGGER((uintptr_t)this, state_);
   auto state = state_;
   state_ = state | TRIGGERED_MASK;
   return (state & TRIGGERED_MASK);
@@ -286,6 +311,22 @@ LCO::waitFor(Condition& cond)
   return self->wait(*this, cond);
 }
 
+hpx_status_t
+LCO::waitForUnlocked(Condition& cond)
+{
+  return self->wait(cond);
+}
+
+hpx_status_t
+LCO::AttachTo(Condition& cond, hpx_parcel_t *p)
+{
+  hpx_status_t status = cond.push(p);
+  if (status != HPX_SUCCESS) {
+    parcel_delete(p);
+  }
+  return status;
+}
+
 void
 hpx_lco_delete(hpx_addr_t target, hpx_addr_t rsync)
 {
@@ -306,10 +347,11 @@ hpx_lco_delete(hpx_addr_t target, hpx_addr_t rsync)
 void
 hpx_lco_delete_sync(hpx_addr_t target)
 {
-  hpx_addr_t sync = hpx_lco_future_new(0);
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
   hpx_lco_delete(target, sync);
-  hpx_lco_wait(sync);
-  hpx_lco_delete(sync, HPX_NULL);
+  hpx_lco_waiter_wait(&waiter);
+  hpx_lco_waiter_fini(&waiter);
 }
 
 void
@@ -340,10 +382,11 @@ hpx_lco_error(hpx_addr_t target, hpx_status_t code, hpx_addr_t rsync)
 void
 hpx_lco_error_sync(hpx_addr_t addr, hpx_status_t code)
 {
-  hpx_addr_t sync = hpx_lco_future_new(0);
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
   hpx_lco_error(addr, code, sync);
-  hpx_lco_wait(sync);
-  hpx_lco_delete(sync, HPX_NULL);
+  hpx_lco_waiter_wait(&waiter);
+  hpx_lco_waiter_fini(&waiter);
 }
 
 void
@@ -368,10 +411,11 @@ hpx_lco_reset(hpx_addr_t addr, hpx_addr_t rsync)
 void
 hpx_lco_reset_sync(hpx_addr_t addr)
 {
-  hpx_addr_t sync = hpx_lco_future_new(0);
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
   hpx_lco_reset(addr, sync);
-  hpx_lco_wait(sync);
-  hpx_lco_delete(sync, HPX_NULL);
+  hpx_lco_waiter_wait(&waiter);
+  hpx_lco_waiter_fini(&waiter);
 }
 
 void
@@ -446,10 +490,11 @@ hpx_lco_set_lsync(hpx_addr_t target, size_t size, const void *value,
     return;
   }
 
-  hpx_addr_t lsync = hpx_lco_future_new(0);
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t lsync = hpx_lco_waiter_init(&waiter, 0, NULL);
   hpx_lco_set(target, size, value, lsync, rsync);
-  hpx_lco_wait(lsync);
-  hpx_lco_delete(lsync, HPX_NULL);
+  hpx_lco_waiter_wait(&waiter);
+  hpx_lco_waiter_fini(&waiter);
 }
 
 int
@@ -467,10 +512,11 @@ hpx_lco_set_rsync(hpx_addr_t target, size_t size, const void *value)
   }
 
   int set = 0;
-  hpx_addr_t rsync = hpx_lco_future_new(4);
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t rsync = hpx_lco_waiter_init(&waiter, sizeof(set), &set);
   hpx_lco_set(target, size, value, HPX_NULL, rsync);
-  hpx_lco_get(rsync, sizeof(set), &set);
-  hpx_lco_delete(rsync, HPX_NULL);
+  hpx_lco_waiter_wait(&waiter);
+  hpx_lco_waiter_fini(&waiter);
   return set;
 }
 
@@ -589,141 +635,6 @@ hpx_lco_release(hpx_addr_t target, void *out)
   hpx_gas_unpin(target);
 }
 
-int
-hpx_lco_wait_all(int n, hpx_addr_t lcos[], hpx_status_t statuses[])
-{
-  dbg_assert(n > 0);
-
-  // Will partition the lcos up into local and remote LCOs. We waste some
-  // space here, since, for each lco in lcos, we either have a local mapping or
-  // a remote address. We don't use the stack because we can't control how big
-  // @p n gets.
-  LCO **locals = new LCO*[n]();
-  dbg_assert_str(locals, "failed to allocate array for %d elements", n);
-  hpx_addr_t *remotes = new hpx_addr_t[n]();
-  dbg_assert_str(remotes, "failed to allocate array for %d elements", n);
-
-  int zero = 0;
-
-  // Try and translate (and pin) all of the lcos, for any of the lcos that
-  // aren't local, allocate a proxy future and initiate the remote wait. This
-  // two-phase approach achieves some parallelism.
-  for (int i = 0; i < n; ++i) {
-    // We neither issue a remote proxy for HPX_NULL, nor wait locally on
-    // HPX_NULL. We manually set the status output for these elements to
-    // indicate success.
-    if (lcos[i] == HPX_NULL) {
-      locals[i] = NULL;
-      remotes[i] = HPX_NULL;
-    }
-    else if (hpx_gas_try_pin(lcos[i], (void**)&locals[i])) {
-      remotes[i] = HPX_NULL;
-    }
-    else {
-      locals[i] = NULL;
-      remotes[i] = hpx_lco_future_new(0);
-      hpx_call_async(lcos[i], _lco_wait, HPX_NULL, remotes[i], &zero);
-    }
-  }
-
-  // Wait on all of the lcos sequentially. If the lco is local (i.e., we have a
-  // local translation for it) we use the local get operation, otherwise we wait
-  // for the completion of the remote proxy.
-  int errors = 0;
-  for (int i = 0; i < n; ++i) {
-    hpx_status_t status = HPX_SUCCESS;
-    if (locals[i] != NULL) {
-      status = locals[i]->wait(0);
-      hpx_gas_unpin(lcos[i]);
-    }
-    else if (remotes[i] != HPX_NULL) {
-      status = hpx_lco_wait(remotes[i]);
-      hpx_lco_delete(remotes[i], HPX_NULL);
-    }
-    else {
-      status = HPX_SUCCESS;
-    }
-
-    if (status != HPX_SUCCESS) {
-      ++errors;
-    }
-
-    if (statuses) {
-      statuses[i] = status;
-    }
-  }
-
-  delete [] remotes;
-  delete [] locals;
-  return errors;
-}
-
-int
-hpx_lco_get_all(int n, hpx_addr_t lcos[], size_t sizes[], void *values[],
-                hpx_status_t statuses[])
-{
-  dbg_assert(n > 0);
-
-  // Will partition the lcos up into local and remote LCOs. We waste some
-  // space here, since, for each lco in lcos, we either have a local mapping or
-  // a remote address. We don't use the stack because we can't control how big
-  // @p n gets.
-  LCO **locals = new LCO*[n]();
-  dbg_assert_str(locals, "failed to allocate array for %d elements", n);
-  hpx_addr_t *remotes = new hpx_addr_t[n]();
-  dbg_assert_str(remotes, "failed to allocate array for %d elements", n);
-
-  // Try and translate (and pin) all of the lcos, for any of the lcos that
-  // aren't local, allocate a proxy future and initiate the remote get. This
-  // two-phase approach achieves some parallelism.
-  for (int i = 0; i < n; ++i) {
-    if (lcos[i] == HPX_NULL) {
-      locals[i] = NULL;
-      remotes[i] = HPX_NULL;
-    }
-    else if (hpx_gas_try_pin(lcos[i], (void**)&locals[i])) {
-      remotes[i] = HPX_NULL;
-    }
-    else {
-      locals[i] = NULL;
-      remotes[i] = hpx_lco_future_new(sizes[i]);
-      hpx_call_async(lcos[i], _lco_get, HPX_NULL, remotes[i], &sizes[i],
-                     sizeof(sizes[i]));
-    }
-  }
-
-  // Wait on all of the lcos sequentially. If the lco is local (i.e., we have a
-  // local translation for it) we use the local get operation, otherwise we wait
-  // for the completion of the remote proxy.
-  int errors = 0;
-  for (int i = 0; i < n; ++i) {
-    hpx_status_t status = HPX_SUCCESS;
-    if (locals[i] != NULL) {
-      status = locals[i]->get(sizes[i], values[i], 0);
-      hpx_gas_unpin(lcos[i]);
-    }
-    else if (remotes[i] != HPX_NULL) {
-      status = hpx_lco_get(remotes[i], sizes[i], values[i]);
-      hpx_lco_delete(remotes[i], HPX_NULL);
-    }
-    else {
-      status = HPX_SUCCESS;
-    }
-
-    if (status != HPX_SUCCESS) {
-      ++errors;
-    }
-
-    if (statuses) {
-      statuses[i] = status;
-    }
-  }
-
-  delete [] remotes;
-  delete [] locals;
-  return errors;
-}
-
 int
 hpx_lco_delete_all(int n, hpx_addr_t *lcos, hpx_addr_t rsync)
 {
@@ -73,6 +73,9 @@ class LCO {
   virtual int set(size_t size, const void *value) = 0;
   virtual hpx_status_t get(size_t size, void *value, int reset) = 0;
   virtual hpx_status_t wait(int reset) = 0;
+
+  /// Send @p p once the LCO is set. An LCO in an error state releases the
+  /// parcel and returns the error.
   virtual hpx_status_t attach(hpx_parcel_t *p) = 0;
   virtual void reset() = 0;
   /// @}
@@ -82,6 +85,14 @@ class LCO {
   /// @{
   virtual hpx_status_t getRef(size_t size, void **out, int *unpin);
   virtual bool release(void *out);
+
+  /// Drop any references to the LCO that other localities hold, before it is
+  /// deleted. This runs in the delete handler, so it can't block.
+  ///
+  /// @returns            An LCO that is set once the references are gone, the
+  ///                       LCO's memory isn't freed until then, or HPX_NULL
+  ///                       if there are no such references.
+  virtual hpx_addr_t detach();
   /// @}
 
   /// Static action entry points for remote procedure call handling.
@@ -123,6 +134,8 @@ class LCO {
     LCO_SEMA,
     LCO_USER,
     LCO_DATAFLOW,
+    LCO_WAITER,
+    LCO_TREE,
     LCO_MAX
   };
 
@@ -141,6 +154,14 @@ class LCO {
   /// Used in subclasses to wait for a condition.
   hpx_status_t waitFor(Condition& cond);
 
+  /// Used in subclasses to wait for a condition without holding the lock,
+  /// through the condition's lock-free interface.
+  hpx_status_t waitForUnlocked(Condition& cond);
+
+  /// Used in subclasses to attach a parcel to a condition, releasing the
+  /// parcel if the condition has an error.
+  static hpx_status_t AttachTo(Condition& cond, hpx_parcel_t *p);
+
   /// Used in the operator new() context to try to pin a global address. The
   /// TryPin() operation will throw a NonLocalMemory exception if the gva
   /// represents a non-local address.
@@ -167,6 +188,21 @@ class LCO {
 #define lco_alloc_cyclic(n, size, boundary)                      \
   hpx_gas_alloc_cyclic_attr(n, size, boundary, HPX_GAS_ATTR_LCO)
 
+/// Allocate a sharded array of @p n LCOs of @p bytes each.
+///
+/// This pads the elements to cachelines, binds them to workers according to
+/// @p policy, and places the pages for each worker's elements on its NUMA node
+/// where possible. The caller constructs the elements.
+///
+/// @param            n The number of elements.
+/// @param        bytes The number of bytes in each LCO.
+/// @param       policy The affinity policy for the array.
+/// @param[out]   bsize The padded size of each element.
+///
+/// @returns            The base address of the array.
+hpx_addr_t lco_alloc_sharded(unsigned n, size_t bytes,
+                             hpx_affinity_policy_t policy, size_t& bsize);
+
 } // namespace scheduler
 } // namespace libhpx
 
@@ -17,22 +17,35 @@
 
 /// @file libhpx/scheduler/reduce.c
 /// @brief Defines the reduction LCO.
+///
+/// Small reductions keep one accumulator per worker after the value, each on
+/// its own cachelines. A set from a worker thread combines into its worker's
+/// accumulator without the lock, and the last input combines the accumulators
+/// into the value while holding the lock. Reductions whose accumulators would
+/// take more than SLOTS_LIMIT bytes combine into the value under the lock.
 
 #include "LCO.h"
 #include "Condition.h"
 #include "libhpx/action.h"
 #include "libhpx/debug.h"
+#include "libhpx/locality.h"
 #include "libhpx/memory.h"
+#include "libhpx/Scheduler.h"
+#include "libhpx/Worker.h"
+#include <atomic>
 #include <mutex>
 #include <cstring>
 
 namespace {
 using libhpx::scheduler::Condition;
+using libhpx::self;
 using libhpx::scheduler::LCO;
+using libhpx::scheduler::lco_alloc_sharded;
 
 struct Reduce final : public LCO {
  public:
-  Reduce(unsigned inputs, size_t size, hpx_action_t id, hpx_action_t op);
+  Reduce(unsigned inputs, size_t size, hpx_action_t id, hpx_action_t op,
+         unsigned slots);
 
   ~Reduce() {
     lock();
@@ -59,76 +72,128 @@ struct Reduce final : public LCO {
     resetBarrier();
   }
 
-  size_t size(size_t size) const {
-    return sizeof(Reduce) + size;
+  size_t size(size_t) const {
+    return sizeof(Reduce) + Bytes(size_, slots_);
+  }
+
+  /// The most bytes of per-worker accumulators that a reduction keeps.
+  static constexpr size_t SLOTS_LIMIT = 16384;
+
+  /// The number of per-worker accumulators to use for a value of @p size.
+  static unsigned Slots(size_t size) {
+    unsigned n = here->sched->getNWorkers();
+    if (!size || SLOTS_LIMIT < n * Stride(size)) {
+      return 0;
+    }
+    return n;
+  }
+
+  /// The number of bytes needed after the Reduce object. With accumulators
+  /// this is a whole number of cachelines, so that they stay aligned in arrays.
+  static size_t Bytes(size_t size, unsigned slots) {
+    return (slots) ? (slots + 1) * Stride(size) : size;
   }
 
  public:
   /// Static action interface.
   /// @{
   static int NewHandler(void* buffer, unsigned inputs, size_t size,
-                        hpx_action_t id, hpx_action_t op) {
-    auto lco = new(buffer) Reduce(inputs, size, id, op);
+                        hpx_action_t id, hpx_action_t op, unsigned slots) {
+    auto lco = new(buffer) Reduce(inputs, size, id, op, slots);
     LCO_LOG_NEW(hpx_thread_current_target(), lco);
     return HPX_SUCCESS;
   }
   /// @}
 
  private:
+  /// Accumulators are padded to cache lines to avoid false sharing.
+  static size_t Stride(size_t size) {
+    return (size + HPX_CACHELINE_SIZE - 1) & ~(HPX_CACHELINE_SIZE - 1);
+  }
+
+  /// Get the accumulator for the current worker, or nullptr if the caller
+  /// needs to combine into the value under the lock.
+  char* slot() {
+    if (!slots_ || !self) {
+      return nullptr;
+    }
+    unsigned i = self->getId();
+    return (i < slots_) ? value_ + (i + 1) * Stride(size_) : nullptr;
+  }
+
+  /// Combine all of the per-worker accumulators into the value, and reset
+  /// them for the next epoch.
+  void combine() {
+    for (unsigned i = 0; i < slots_; ++i) {
+      char* acc = value_ + (i + 1) * Stride(size_);
+      op(value_, size_, acc);
+      id(acc);
+    }
+  }
+
   void resetBarrier() {
     barrier_.reset();
-    remaining_ = inputs_;
-    id();
+    remaining_.store(inputs_, std::memory_order_relaxed);
+    full_ = false;
+    id(value_);
+    for (unsigned i = 0; i < slots_; ++i) {
+      id(value_ + (i + 1) * Stride(size_));
+    }
   }
 
-  void op(size_t size, const void* from) {
+  void op(void* value, size_t size, const void* from) {
     if (size) {
       dbg_assert(from && size_ && op_);
       hpx_monoid_op_t f = (hpx_monoid_op_t)actions[op_].handler;
-      f(value_, from, size);
+      f(value, from, size);
     }
   }
 
-  void id() {
+  void id(void* value) {
     if (id_) {
       hpx_monoid_id_t f = (hpx_monoid_id_t)actions[id_].handler;
-      f(value_, size_);
+      f(value, size_);
     }
   }
 
-  Condition           barrier_;
-  const size_t           size_;
-  const hpx_action_t       id_;
-  const hpx_action_t       op_;
-  const unsigned       inputs_;
-  volatile unsigned remaining_;
-  alignas(16) char      value_[];
+  Condition               barrier_;
+  const size_t               size_;
+  const hpx_action_t           id_;
+  const hpx_action_t           op_;
+  const unsigned           inputs_;
+  const unsigned            slots_;             //<! per-worker accumulators
+  std::atomic<unsigned> remaining_;
+  bool                       full_;             //<! protected by the lock
+  alignas(HPX_CACHELINE_SIZE) char value_[];
 };
 
 LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, New, Reduce::NewHandler, HPX_POINTER,
-              HPX_UINT, HPX_SIZE_T, HPX_ACTION_T, HPX_ACTION_T);
+              HPX_UINT, HPX_SIZE_T, HPX_ACTION_T, HPX_ACTION_T, HPX_UINT);
 }
 
-Reduce::Reduce(unsigned inputs, size_t size, hpx_action_t id, hpx_action_t op)
+Reduce::Reduce(unsigned inputs, size_t size, hpx_action_t id, hpx_action_t op,
+               unsigned slots)
     : LCO(LCO_REDUCE),
       barrier_(),
       size_(size),
       id_(id),
       op_(op),
       inputs_(inputs),
-      remaining_(inputs)
+      slots_(slots),
+      remaining_(inputs),
+      full_(false)
 {
   dbg_assert(!size_ || op_);
   dbg_assert(!size_ || id_);
-  this->id();
+  resetBarrier();
 }
 
 hpx_status_t
 Reduce::attach(hpx_parcel_t *p)
 {
   std::lock_guard<LCO> _(*this);
-  if (remaining_) {
-    return barrier_.push(p);
+  if (!full_) {
+    return AttachTo(barrier_, p);
   }
 
   if (auto status = barrier_.getError()) {
@@ -148,21 +213,27 @@ Reduce::set(size_t size, const void *from)
 {
   dbg_assert(size == size_);
   dbg_assert(!size || from);
-  std::lock_guard<LCO> _(*this);
-
-  op(size, from);
 
-  if (0 == --remaining_) {
-    barrier_.signalAll();
-    return 1;
+  if (char* acc = slot()) {
+    op(acc, size, from);
   }
   else {
-    dbg_assert_str(remaining_ > 0, "reduction: too many threads joined (%d).\n",
-                   remaining_);
+    std::lock_guard<LCO> _(*this);
+    op(value_, size, from);
   }
 
-  log_lco("reduce: received input %d\n", remaining_);
-  return 0;
+  unsigned remaining = remaining_.fetch_sub(1, std::memory_order_acq_rel);
+  dbg_assert_str(remaining > 0, "reduction: too many threads joined.\n");
+  if (remaining != 1) {
+    log_lco("reduce: received input %u\n", remaining - 1);
+    return 0;
+  }
+
+  std::lock_guard<LCO> _(*this);
+  combine();
+  full_ = true;
+  barrier_.signalAll();
+  return 1;
 }
 
 /// Get the value of the reduction.
@@ -173,7 +244,7 @@ Reduce::get(size_t size, void *out, int reset)
   dbg_assert(!size || out);
   std::lock_guard<LCO> _(*this);
 
-  while (remaining_) {
+  while (!full_) {
     if (auto status = waitFor(barrier_)) {
       return status;
     }
@@ -219,13 +290,15 @@ hpx_lco_reduce_new(int inputs, size_t size, hpx_action_t id, hpx_action_t op)
   dbg_assert(inputs > 0);
   hpx_addr_t gva = HPX_NULL;
   unsigned writers(inputs);
+  unsigned slots = Reduce::Slots(size);
   try {
-    Reduce* lco = new(size, gva) Reduce(writers, size, id, op);
+    Reduce* lco = new(Reduce::Bytes(size, slots), gva) Reduce(writers, size, id,
+                                                              op, slots);
     hpx_gas_unpin(gva);
     LCO_LOG_NEW(gva, lco);
   }
   catch (const LCO::NonLocalMemory&) {
-    hpx_call_sync(gva, New, nullptr, 0, &writers, &size, &id, &op);
+    hpx_call_sync(gva, New, nullptr, 0, &writers, &size, &id, &op, &slots);
   }
   return gva;
 }
@@ -237,8 +310,9 @@ hpx_lco_reduce_local_array_new(int n, int inputs, size_t size, hpx_action_t id,
   dbg_assert(inputs > 0);
   dbg_assert(n > 0);
   unsigned writers(inputs);
-  size_t bsize = sizeof(Reduce) + size;
-  hpx_addr_t base = lco_alloc_local(n, bsize, 0);
+  unsigned slots = Reduce::Slots(size);
+  size_t bsize = sizeof(Reduce) + Reduce::Bytes(size, slots);
+  hpx_addr_t base = lco_alloc_local(n, bsize, HPX_CACHELINE_SIZE);
   if (!base) {
     throw std::bad_alloc();
   }
@@ -246,7 +320,31 @@ hpx_lco_reduce_local_array_new(int n, int inputs, size_t size, hpx_action_t id,
   hpx_addr_t bcast = hpx_lco_and_new(n);
   for (int i = 0, e = n; i < e; ++i) {
     hpx_addr_t addr = hpx_addr_add(base, i * bsize, bsize);
-    dbg_check( hpx_call(addr, New, bcast, &writers, &size, &id, &op) );
+    dbg_check( hpx_call(addr, New, bcast, &writers, &size, &id, &op, &slots) );
+  }
+  hpx_lco_wait(bcast);
+  hpx_lco_delete_sync(bcast);
+  return base;
+}
+
+hpx_addr_t
+hpx_lco_reduce_sharded_array_new(int n, int inputs, size_t size,
+                                 hpx_action_t id, hpx_action_t op,
+                                 hpx_affinity_policy_t policy)
+{
+  dbg_assert(inputs > 0);
+  dbg_assert(n > 0);
+  unsigned writers(inputs);
+  unsigned slots = Reduce::Slots(size);
+  size_t bsize;
+  hpx_addr_t base = lco_alloc_sharded(n, sizeof(Reduce) +
+                                      Reduce::Bytes(size, slots), policy,
+                                      bsize);
+
+  hpx_addr_t bcast = hpx_lco_and_new(n);
+  for (int i = 0, e = n; i < e; ++i) {
+    hpx_addr_t addr = hpx_addr_add(base, i * bsize, bsize);
+    dbg_check( hpx_call(addr, New, bcast, &writers, &size, &id, &op, &slots) );
   }
   hpx_lco_wait(bcast);
   hpx_lco_delete_sync(bcast);
@@ -17,12 +17,18 @@
 
 /// @file libhpx/scheduler/sema.c
 /// @brief Implements the semaphore LCO.
+///
+/// The semaphore queues its waiters in arrival order, and a v() with waiters
+/// hands its permit straight to the oldest one instead of incrementing the
+/// count. A woken waiter therefore never has to contend with new arrivals for
+/// the count, and the count is only nonzero when nobody is waiting.
 
 #include "LCO.h"
 #include "Condition.h"
 #include "libhpx/action.h"
 #include "libhpx/debug.h"
 #include "libhpx/memory.h"
+#include "libhpx/parcel.h"
 #include <mutex>
 
 namespace {
@@ -38,13 +44,7 @@ class Semaphore final : public LCO
     lock();                                     // Released in ~LCO()
   }
 
-  int set(size_t size, const void *value) {
-    std::lock_guard<LCO> _(*this);
-    if (0 == count_++) {
-      nonZero_.signal();                        // just wake one waiter
-    }
-    return 1;
-  }
+  int set(size_t size, const void *value);
 
   void error(hpx_status_t code) {
     std::lock_guard<LCO> _(*this);
@@ -86,10 +86,15 @@ class Semaphore final : public LCO
     nonZero_.signalAll();                         // wake all waiters
     nonZero_.reset();
     count_ = init_;
+    granted_ = 0;
   }
 
+  /// Wait for a permit to be handed off, with the lock held.
+  hpx_status_t waitHandoff();
+
   Condition   nonZero_;
   unsigned      count_;
+  unsigned    granted_;                         //<! handed off, not yet taken
   const unsigned init_;
 };
 
@@ -99,23 +104,65 @@ LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, New, Semaphore::NewHandler,
 
 Semaphore::Semaphore(unsigned count)
     : LCO(LCO_SEMA),
-      nonZero_(),
+      nonZero_(Condition::FIFO),
       count_(count),
+      granted_(0),
       init_(count)
 {
 }
 
+int
+Semaphore::set(size_t, const void*)
+{
+  hpx_parcel_t* waiter = nullptr;
+  {
+    std::lock_guard<LCO> _(*this);
+    waiter = nonZero_.pop();
+    if (!waiter) {
+      count_++;
+      return 1;
+    }
+    granted_++;
+  }
+
+  // Launch the waiter after dropping the lock, so that the spawn isn't
+  // deferred and the waiter can run on this worker right away.
+  parcel_launch(waiter);
+  return 1;
+}
+
 hpx_status_t
-Semaphore::wait(int reset)
+Semaphore::waitHandoff()
 {
-  std::lock_guard<LCO> _(*this);
-  while (count_ == 0) {
+  // Only a reset wakes waiters without handing them a permit, and it refills
+  // the count.
+  while (true) {
     if (auto status = waitFor(nonZero_)) {
       return status;
     }
+
+    if (granted_) {
+      granted_--;
+      return HPX_SUCCESS;
+    }
+
+    if (count_) {
+      count_--;
+      return HPX_SUCCESS;
+    }
   }
+}
 
-  count_--;
+hpx_status_t
+Semaphore::wait(int reset)
+{
+  std::lock_guard<LCO> _(*this);
+  if (count_) {
+    count_--;
+  }
+  else if (auto status = waitHandoff()) {
+    return status;
+  }
 
   if (reset) {
     resetNonZero();
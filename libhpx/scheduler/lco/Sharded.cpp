@@ -0,0 +1,145 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/// @file libhpx/scheduler/lco/Sharded.cpp
+/// @brief Allocation and placement for sharded LCO arrays.
+
+#include "LCO.h"
+#include "libhpx/action.h"
+#include "libhpx/debug.h"
+#include "libhpx/GAS.h"
+#include "libhpx/locality.h"
+#include "libhpx/Scheduler.h"
+#include "libhpx/system.h"
+#include "libhpx/Topology.h"
+#include "libhpx/Worker.h"
+#include <cstdint>
+
+namespace {
+using libhpx::scheduler::LCO;
+
+/// Pad an element to a whole number of cachelines.
+size_t
+Stride(size_t bytes)
+{
+  return (bytes + HPX_CACHELINE_SIZE - 1) & ~size_t(HPX_CACHELINE_SIZE - 1);
+}
+
+/// Find the OS NUMA node of the worker bound to @p gva, or -1.
+int
+NodeOf(hpx_addr_t gva)
+{
+  int worker = here->gas->getAffinity(gva);
+  if (worker < 0) {
+    return -1;
+  }
+  const Topology* topo = here->topology;
+  int node = here->sched->getWorker(worker)->getNumaNode();
+  return (topo->numa_nodes) ? topo->numa_nodes[node]->os_index : node;
+}
+
+/// Place the pages of a sharded array on the NUMA nodes of their workers.
+///
+/// Only whole pages can be placed, so runs of elements that share a node are
+/// placed together and pages that straddle two runs are left alone. This means
+/// that cyclic placement has no effect.
+void
+Place(hpx_addr_t base, unsigned n, size_t bsize)
+{
+  const Topology* topo = here->topology;
+  if (!topo || topo->nnodes < 2) {
+    return;
+  }
+
+  char* lva = nullptr;
+  if (!hpx_gas_try_pin(base, (void**)&lva)) {
+    return;
+  }
+
+  for (unsigned i = 0, j; i < n; i = j) {
+    int node = NodeOf(hpx_addr_add(base, i * bsize, bsize));
+    for (j = i + 1; j < n; ++j) {
+      if (NodeOf(hpx_addr_add(base, j * bsize, bsize)) != node) {
+        break;
+      }
+    }
+
+    uintptr_t lo = (uintptr_t)(lva + i * bsize);
+    uintptr_t hi = (uintptr_t)(lva + j * bsize);
+    lo = (lo + HPX_PAGE_SIZE - 1) & ~uintptr_t(HPX_PAGE_SIZE - 1);
+    hi = hi & ~uintptr_t(HPX_PAGE_SIZE - 1);
+    if (0 <= node && lo < hi) {
+      system_numa_place((void*)lo, hi - lo, node, topo->nnodes);
+    }
+  }
+
+  hpx_gas_unpin(base);
+}
+
+int
+DeleteHandler(unsigned n, size_t size)
+{
+  hpx_addr_t base = hpx_thread_current_target();
+  size_t bsize = Stride(hpx_lco_size(base, size));
+  for (unsigned i = 0; i < n; ++i) {
+    hpx_addr_t gva = hpx_addr_add(base, i * bsize, bsize);
+    LCO* lco = nullptr;
+    if (hpx_gas_try_pin(gva, (void**)&lco)) {
+      lco->~LCO();
+      hpx_gas_unpin(gva);
+    }
+  }
+  hpx_gas_clear_affinity_range(base);
+  return hpx_call_cc(base, hpx_gas_free_action);
+}
+LIBHPX_ACTION(HPX_DEFAULT, 0, Delete, DeleteHandler, HPX_UINT, HPX_SIZE_T);
+}
+
+hpx_addr_t
+libhpx::scheduler::lco_alloc_sharded(unsigned n, size_t bytes,
+                                     hpx_affinity_policy_t policy,
+                                     size_t& bsize)
+{
+  dbg_assert(n > 0);
+  bsize = Stride(bytes);
+  hpx_addr_t base = lco_alloc_local(n, bsize, HPX_CACHELINE_SIZE);
+  if (!base) {
+    throw std::bad_alloc();
+  }
+
+  hpx_gas_set_affinity_range(base, n, bsize, policy);
+  if (policy != HPX_AFFINITY_CYCLIC) {
+    Place(base, n, bsize);
+  }
+  return base;
+}
+
+hpx_addr_t
+hpx_lco_sharded_array_at(hpx_addr_t base, int i, size_t size)
+{
+  size_t bsize = Stride(hpx_lco_size(base, size));
+  return hpx_addr_add(base, i * bsize, bsize);
+}
+
+void
+hpx_lco_sharded_array_delete(hpx_addr_t base, int n, size_t size,
+                             hpx_addr_t rsync)
+{
+  dbg_assert(n > 0);
+  unsigned elements = n;
+  dbg_check( hpx_call(base, Delete, rsync, &elements, &size) );
+}
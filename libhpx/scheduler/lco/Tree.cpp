@@ -0,0 +1,591 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/// @file libhpx/scheduler/lco/Tree.cpp
+/// @brief Defines the combining-tree and and reduce LCOs.
+///
+/// A combining tree has one node per locality, allocated cyclically, with the
+/// root in the first block. The address of the root is the address of the
+/// tree. Each non-root node registers itself in a locality-local table, and
+/// parcel_launch() redirects remote hpx_lco_set_action parcels for the root to
+/// the node on the sending locality. Nodes combine the inputs they receive and
+/// forward the partial result to their parent in a single message, using a
+/// flush that is scheduled when a node goes from empty to non-empty.
+///
+/// A set that has a continuation, e.g., from hpx_lco_set_rsync(), flushes the
+/// node synchronously instead, all the way to the root, so that it can report
+/// whether it completed the tree.
+///
+/// The table is probed for every remote set, so lookups don't lock. It's a
+/// fixed-size open-addressed table whose slots are only written under a lock.
+/// A node that doesn't fit isn't registered, and sets through it go straight
+/// to the root.
+
+#include "LCO.h"
+#include "Condition.h"
+#include "libhpx/action.h"
+#include "libhpx/debug.h"
+#include "libhpx/locality.h"
+#include "libhpx/parcel.h"
+#include <atomic>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace {
+using libhpx::scheduler::Condition;
+using libhpx::scheduler::LCO;
+
+/// The locality-local map from tree roots to the local tree node.
+class Registry {
+ public:
+  /// Register @p node for @p root, returns false if the table is full.
+  bool insert(hpx_addr_t root, hpx_addr_t node);
+
+  /// Drop the node for @p root, if it's registered.
+  void remove(hpx_addr_t root);
+
+  /// Find the node for @p root, or HPX_NULL, without locking.
+  hpx_addr_t lookup(hpx_addr_t root) const;
+
+ private:
+  static constexpr unsigned BITS = 10;
+  static constexpr unsigned SLOTS = 1u << BITS;
+
+  /// Removed slots keep probes going until the table is empty again.
+  static constexpr hpx_addr_t TOMBSTONE = ~hpx_addr_t(0);
+
+  /// A slot is only reused after its root is overwritten by a tombstone, and
+  /// the root is checked again after reading the node, so a lookup never
+  /// pairs a root with another tree's node.
+  struct Slot {
+    std::atomic<hpx_addr_t> root;
+    std::atomic<hpx_addr_t> node;
+  };
+
+  static unsigned Hash(hpx_addr_t root) {
+    return (root * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - BITS);
+  }
+
+  std::mutex              lock_;                //!< serializes updates
+  std::atomic<unsigned>  count_;                //!< registered nodes
+  Slot          slots_[SLOTS];
+};
+
+Registry Nodes;
+
+class Tree final : public LCO {
+ public:
+  Tree(hpx_addr_t base, hpx_addr_t self, hpx_addr_t parent, uint64_t inputs,
+       size_t size, hpx_action_t id, hpx_action_t op);
+  ~Tree();
+
+  hpx_status_t attach(hpx_parcel_t *p);
+  hpx_status_t get(size_t size, void *value, int reset);
+  hpx_status_t getRef(size_t size, void **out, int *unpin);
+  bool release(void *out);
+  int set(size_t size, const void *value);
+
+  void error(hpx_status_t code) {
+    std::lock_guard<LCO> _(*this);
+    barrier_.signalError(code);
+  }
+
+  hpx_status_t wait(int reset) {
+    return get(0, NULL, reset);
+  }
+
+  void reset() {
+    std::lock_guard<LCO> _(*this);
+    resetBarrier();
+  }
+
+  hpx_addr_t detach();
+
+  size_t size(size_t) const {
+    return sizeof(Tree) + size_;
+  }
+
+ public:
+  /// Static action interface.
+  /// @{
+  static int NewHandler(void* buffer, hpx_addr_t base, hpx_addr_t parent,
+                        uint64_t inputs, size_t size, hpx_action_t id,
+                        hpx_action_t op);
+  static int CombineHandler(Tree* node, void* data, size_t n);
+  static int FlushHandler(Tree* node);
+  static int UnregisterHandler(hpx_addr_t base);
+  /// @}
+
+ private:
+  /// Combine @p n inputs, with the partial value @p from, into this node.
+  ///
+  /// @param       sync Forward the result to the root before returning.
+  ///
+  /// @returns          1 if this completed the tree, which is only known at
+  ///                   the root or for a synchronous combine.
+  int combine(uint64_t n, const void* from, bool sync);
+
+  /// Copy the partial result at this node into @p data, and clear it.
+  void pack(char* data);
+
+  /// Forward the partial result at this node to the parent.
+  void flush();
+
+  /// Forward the partial result at this node to the parent, and wait for it
+  /// to reach the root.
+  int flushSync();
+
+  bool isRoot() const {
+    return (parent_ == HPX_NULL);
+  }
+
+  void resetBarrier() {
+    dbg_assert(isRoot());
+    barrier_.reset();
+    units_ = 0;
+    id();
+  }
+
+  void op(const void* from) {
+    if (size_ && from) {
+      dbg_assert(op_);
+      hpx_monoid_op_t f = (hpx_monoid_op_t)actions[op_].handler;
+      f(value_, from, size_);
+    }
+  }
+
+  void id() {
+    if (id_) {
+      hpx_monoid_id_t f = (hpx_monoid_id_t)actions[id_].handler;
+      f(value_, size_);
+    }
+  }
+
+  Condition        barrier_;                    //<! the root's condition
+  const hpx_addr_t    base_;                    //<! the root address
+  const hpx_addr_t    self_;                    //<! this node's address
+  const hpx_addr_t  parent_;                    //<! HPX_NULL at the root
+  const uint64_t    inputs_;                    //<! total inputs (root only)
+  const size_t        size_;
+  const hpx_action_t    id_;
+  const hpx_action_t    op_;
+  uint64_t           units_;                    //<! inputs combined here
+  bool            flushing_;                    //<! a flush is scheduled
+  alignas(16) char value_[];
+};
+
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, New, Tree::NewHandler, HPX_POINTER,
+              HPX_ADDR, HPX_ADDR, HPX_UINT64, HPX_SIZE_T, HPX_ACTION_T,
+              HPX_ACTION_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED | HPX_MARSHALLED, Combine,
+              Tree::CombineHandler, HPX_POINTER, HPX_POINTER, HPX_SIZE_T);
+LIBHPX_ACTION(HPX_DEFAULT, HPX_PINNED, Flush, Tree::FlushHandler, HPX_POINTER);
+LIBHPX_ACTION(HPX_INTERRUPT, 0, Unregister, Tree::UnregisterHandler,
+              HPX_ADDR);
+}
+
+Tree::Tree(hpx_addr_t base, hpx_addr_t self, hpx_addr_t parent,
+           uint64_t inputs, size_t size, hpx_action_t id, hpx_action_t op)
+    : LCO(LCO_TREE),
+      barrier_(),
+      base_(base),
+      self_(self),
+      parent_(parent),
+      inputs_(inputs),
+      size_(size),
+      id_(id),
+      op_(op),
+      units_(0),
+      flushing_(false)
+{
+  dbg_assert(!size_ || op_);
+  dbg_assert(!size_ || id_);
+  this->id();
+}
+
+Tree::~Tree()
+{
+  dbg_assert(isRoot());
+  lock();                                       // released in ~LCO()
+}
+
+/// Only the root is ever deleted, the other nodes live in the same cyclic
+/// allocation and are dropped from their localities' tables. The allocation
+/// isn't freed until they all have been, otherwise a stale entry could
+/// redirect sets for an LCO that reuses the root's address, and a late
+/// unregister could drop that LCO's entry.
+hpx_addr_t
+Tree::detach()
+{
+  dbg_assert(isRoot());
+  if (here->ranks == 1) {
+    return HPX_NULL;
+  }
+
+  hpx_addr_t done = hpx_lco_and_new(here->ranks - 1);
+  for (unsigned i = 0, e = here->ranks; i < e; ++i) {
+    if (i != here->rank) {
+      hpx_addr_t base = base_;
+      dbg_check( hpx_call(HPX_THERE(i), Unregister, done, &base) );
+    }
+  }
+  return done;
+}
+
+int
+Tree::combine(uint64_t n, const void* from, bool sync)
+{
+  {
+    std::lock_guard<LCO> _(*this);
+    op(from);
+    units_ += n;
+    if (isRoot()) {
+      dbg_assert_str(units_ <= inputs_, "tree: too many inputs joined.\n");
+      if (units_ < inputs_) {
+        return 0;
+      }
+      barrier_.signalAll();
+      return 1;
+    }
+
+    if (sync) {
+      // A scheduled flush will find nothing to send.
+    }
+    else if (flushing_) {
+      return 0;
+    }
+    else {
+      flushing_ = true;
+    }
+  }
+
+  if (sync) {
+    return flushSync();
+  }
+
+  // Everything that arrives before the flush runs is combined into its
+  // message.
+  dbg_check( hpx_call(self_, Flush, HPX_NULL) );
+  return 0;
+}
+
+void
+Tree::pack(char* data)
+{
+  memcpy(data, &units_, sizeof(units_));
+  if (size_) {
+    memcpy(data + sizeof(units_), value_, size_);
+  }
+  units_ = 0;
+  id();
+}
+
+void
+Tree::flush()
+{
+  hpx_parcel_t *p = hpx_parcel_acquire(NULL, sizeof(units_) + size_);
+  {
+    std::lock_guard<LCO> _(*this);
+    flushing_ = false;
+    if (!units_) {
+      hpx_parcel_release(p);
+      return;
+    }
+    pack(static_cast<char*>(hpx_parcel_get_data(p)));
+  }
+
+  p->target = parent_;
+  p->action = Combine;
+  dbg_check( hpx_parcel_send(p, HPX_NULL) );
+}
+
+int
+Tree::flushSync()
+{
+  const size_t bytes = sizeof(units_) + size_;
+  std::unique_ptr<char[]> data(new char[bytes]);
+  {
+    std::lock_guard<LCO> _(*this);
+    pack(data.get());
+  }
+
+  int set = 0;
+  dbg_check( hpx_call_sync(parent_, Combine, &set, sizeof(set), data.get(),
+                           bytes) );
+  return set;
+}
+
+hpx_status_t
+Tree::attach(hpx_parcel_t *p)
+{
+  std::lock_guard<LCO> _(*this);
+  dbg_assert(isRoot());
+  if (units_ < inputs_) {
+    return AttachTo(barrier_, p);
+  }
+
+  if (auto status = barrier_.getError()) {
+    parcel_delete(p);
+    return status;
+  }
+
+  parcel_launch(p);
+  return HPX_SUCCESS;
+}
+
+int
+Tree::set(size_t size, const void *from)
+{
+  // Sets only reach other nodes through parcel_launch(), so a set there that
+  // has a continuation wants to know if it completed the tree.
+  bool sync = !isRoot() && hpx_thread_current_cont_target();
+
+  // The and variant counts like And::set(), the reduce variant takes exactly
+  // one input per set.
+  if (!size_) {
+    dbg_assert(!size || from);
+    auto* p = static_cast<const int*>(from);
+    return combine((p) ? *p : 1, nullptr, sync);
+  }
+
+  dbg_assert(size == size_ && from);
+  return combine(1, from, sync);
+}
+
+hpx_status_t
+Tree::get(size_t size, void *out, int reset)
+{
+  dbg_assert(!size || (size == size_));
+  dbg_assert(!size || out);
+  std::lock_guard<LCO> _(*this);
+  dbg_assert(isRoot());
+
+  while (units_ < inputs_) {
+    if (auto status = waitFor(barrier_)) {
+      return status;
+    }
+  }
+
+  if (auto status = barrier_.getError()) {
+    return status;
+  }
+
+  if (size && out) {
+    memcpy(out, value_, size);
+  }
+
+  if (reset) {
+    resetBarrier();
+  }
+
+  return HPX_SUCCESS;
+}
+
+hpx_status_t
+Tree::getRef(size_t size, void **out, int *unpin)
+{
+  dbg_assert(size == size_);
+  dbg_assert(size && out);
+
+  if (hpx_status_t status = wait(0)) {
+    return status;
+  }
+
+  *out = value_;
+  *unpin = 0;
+  return HPX_SUCCESS;
+}
+
+bool
+Tree::release(void *out)
+{
+  dbg_assert(out == value_);
+  return true;
+}
+
+int
+Tree::NewHandler(void* buffer, hpx_addr_t base, hpx_addr_t parent,
+                 uint64_t inputs, size_t size, hpx_action_t id,
+                 hpx_action_t op)
+{
+  hpx_addr_t self = hpx_thread_current_target();
+  auto lco = new(buffer) Tree(base, self, parent, inputs, size, id, op);
+  LCO_LOG_NEW(self, lco);
+
+  if (parent != HPX_NULL && !Nodes.insert(base, self)) {
+    log_lco("tree: too many trees to register the node for %" PRIu64 "\n",
+            base);
+  }
+  return HPX_SUCCESS;
+}
+
+int
+Tree::CombineHandler(Tree* node, void* data, size_t n)
+{
+  dbg_assert(n == sizeof(uint64_t) + node->size_);
+  uint64_t units;
+  memcpy(&units, data, sizeof(units));
+  const char *value = static_cast<const char*>(data) + sizeof(units);
+  bool sync = (hpx_thread_current_cont_target() != HPX_NULL);
+  int set = node->combine(units, (node->size_) ? value : nullptr, sync);
+  return HPX_THREAD_CONTINUE(set);
+}
+
+int
+Tree::FlushHandler(Tree* node)
+{
+  node->flush();
+  return HPX_SUCCESS;
+}
+
+int
+Tree::UnregisterHandler(hpx_addr_t base)
+{
+  Nodes.remove(base);
+  return HPX_SUCCESS;
+}
+
+bool
+Registry::insert(hpx_addr_t root, hpx_addr_t node)
+{
+  std::lock_guard<std::mutex> _(lock_);
+  Slot* free = nullptr;
+  for (unsigned i = Hash(root), n = 0; n < SLOTS; i = (i + 1) % SLOTS, ++n) {
+    hpx_addr_t r = slots_[i].root.load(std::memory_order_relaxed);
+    if (r == root) {
+      return true;
+    }
+    if (r == TOMBSTONE && !free) {
+      free = &slots_[i];
+    }
+    if (r == HPX_NULL) {
+      free = (free) ? free : &slots_[i];
+      break;
+    }
+  }
+
+  if (!free) {
+    return false;
+  }
+  free->node.store(node, std::memory_order_release);
+  free->root.store(root, std::memory_order_release);
+  count_.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+void
+Registry::remove(hpx_addr_t root)
+{
+  std::lock_guard<std::mutex> _(lock_);
+  Slot* slot = nullptr;
+  for (unsigned i = Hash(root), n = 0; n < SLOTS; i = (i + 1) % SLOTS, ++n) {
+    hpx_addr_t r = slots_[i].root.load(std::memory_order_relaxed);
+    if (r == root) {
+      slot = &slots_[i];
+    }
+    if (r == root || r == HPX_NULL) {
+      break;
+    }
+  }
+
+  if (!slot) {
+    return;
+  }
+  slot->root.store(TOMBSTONE, std::memory_order_release);
+
+  // Once the table is empty, no probe can need the tombstones.
+  if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    for (Slot& s : slots_) {
+      s.root.store(HPX_NULL, std::memory_order_relaxed);
+    }
+  }
+}
+
+hpx_addr_t
+Registry::lookup(hpx_addr_t root) const
+{
+  if (!count_.load(std::memory_order_acquire)) {
+    return HPX_NULL;
+  }
+
+  for (unsigned i = Hash(root), n = 0; n < SLOTS; i = (i + 1) % SLOTS, ++n) {
+    const Slot& slot = slots_[i];
+    hpx_addr_t r = slot.root.load(std::memory_order_acquire);
+    if (r == HPX_NULL) {
+      return HPX_NULL;
+    }
+    if (r == root) {
+      hpx_addr_t node = slot.node.load(std::memory_order_acquire);
+      return (slot.root.load(std::memory_order_relaxed) == root) ? node :
+             HPX_NULL;
+    }
+  }
+  return HPX_NULL;
+}
+
+hpx_addr_t
+lco_tree_local(hpx_addr_t root)
+{
+  return Nodes.lookup(root);
+}
+
+/// Allocate and initialize a combining tree with one node per locality.
+static hpx_addr_t
+_tree_new(uint64_t inputs, size_t size, hpx_action_t id, hpx_action_t op,
+          int arity)
+{
+  dbg_assert(arity > 1);
+  const unsigned nodes = here->ranks;
+  const size_t bsize = sizeof(Tree) + size;
+  hpx_addr_t base = lco_alloc_cyclic(nodes, bsize, 0);
+  if (!base) {
+    log_error("could not allocate a combining tree of %u nodes\n", nodes);
+    return HPX_NULL;
+  }
+
+  hpx_addr_t bcast = hpx_lco_and_new(nodes);
+  for (unsigned i = 0; i < nodes; ++i) {
+    hpx_addr_t node = hpx_addr_add(base, i * bsize, bsize);
+    hpx_addr_t parent = HPX_NULL;
+    uint64_t n = inputs;
+    if (i) {
+      parent = hpx_addr_add(base, ((i - 1) / arity) * bsize, bsize);
+      n = 0;
+    }
+    dbg_check( hpx_call(node, New, bcast, &base, &parent, &n, &size, &id, &op) );
+  }
+  hpx_lco_wait(bcast);
+  hpx_lco_delete_sync(bcast);
+  return base;
+}
+
+hpx_addr_t
+hpx_lco_and_tree_new(int64_t inputs, int arity)
+{
+  dbg_assert(inputs >= 0);
+  return _tree_new(inputs, 0, HPX_ACTION_NULL, HPX_ACTION_NULL, arity);
+}
+
+hpx_addr_t
+hpx_lco_reduce_tree_new(int inputs, size_t size, hpx_action_t id,
+                        hpx_action_t op, int arity)
+{
+  dbg_assert(inputs > 0);
+  return _tree_new(inputs, size, id, op, arity);
+}
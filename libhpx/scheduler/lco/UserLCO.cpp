@@ -262,7 +262,7 @@ UserLCO::attach(hpx_parcel_t *p)
 {
   std::lock_guard<LCO> _(*this);
   if (!getTriggered()) {
-    return cvar_.push(p);
+    return AttachTo(cvar_, p);
   }
 
   if (auto status = cvar_.getError()) {
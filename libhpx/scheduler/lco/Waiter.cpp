@@ -0,0 +1,190 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/// @file libhpx/scheduler/lco/Waiter.cpp
+/// Defines the stack-resident waiter LCO used by the synchronous interfaces.
+
+#include "LCO.h"
+#include "Condition.h"
+#include "libhpx/debug.h"
+#include "libhpx/locality.h"
+#include "libhpx/GAS.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace {
+using libhpx::scheduler::Condition;
+using libhpx::scheduler::LCO;
+
+/// A single-use future that lives on the waiting thread's stack.
+///
+/// The waiter writes its value directly into the caller's output buffer, so
+/// the synchronous interfaces avoid both the global allocation and the extra
+/// copy out of the future.
+class Waiter final : public LCO
+{
+ public:
+  Waiter(size_t size, void *out)
+      : LCO(LCO_WAITER),
+        full_(),
+        claimed_(false),
+        out_(out),
+        size_((out) ? size : 0)
+  {
+  }
+
+  ~Waiter() {
+    lock();                                     // release in ~LCO()
+  }
+
+  int set(size_t size, const void *value) {
+    if (claimed_.exchange(true, std::memory_order_acquire)) {
+      dbg_error("cannot set an already set waiter\n");
+      return 0;
+    }
+    if (value && size && size_) {
+      memcpy(out_, value, std::min(size, size_));
+    }
+    return full_.close(HPX_SUCCESS);
+  }
+
+  hpx_status_t get(size_t size, void *value, int reset) {
+    if (!reset) {
+      if (hpx_status_t status = waitFull()) {
+        return status;
+      }
+      copy(size, value);
+      return HPX_SUCCESS;
+    }
+
+    // see Future::get()
+    std::unique_lock<LCO> lock(*this);
+    while (!full_.closed()) {
+      lock.unlock();
+      waitFull();
+      lock.lock();
+    }
+    if (hpx_status_t status = full_.getError()) {
+      return status;
+    }
+    copy(size, value);
+    resetFull();
+    return HPX_SUCCESS;
+  }
+
+  hpx_status_t getRef(size_t size, void **out, int *unpin) {
+    dbg_assert(size && out);
+    if (hpx_status_t status = wait(0)) {
+      return status;
+    }
+    *out = out_;
+    *unpin = 0;
+    return HPX_SUCCESS;
+  }
+
+  bool release(void *out) {
+    dbg_assert(out && out == out_);
+    return true;
+  }
+
+  hpx_status_t attach(hpx_parcel_t *p) {
+    if (full_.tryPush(p)) {
+      return HPX_SUCCESS;
+    }
+    if (hpx_status_t status = full_.getError()) {
+      hpx_parcel_release(p);
+      return status;
+    }
+    hpx_parcel_send(p, HPX_NULL);
+    return HPX_SUCCESS;
+  }
+
+  void error(hpx_status_t code) {
+    full_.close(code);
+  }
+
+  hpx_status_t wait(int reset) {
+    return get(0, NULL, reset);
+  }
+
+  void reset() {
+    std::lock_guard<LCO> _(*this);
+    resetFull();
+  }
+
+  size_t size(size_t) const {
+    return sizeof(Waiter);
+  }
+
+ private:
+  /// Reset the full condition.
+  ///
+  /// Like the future, the waiter uses its condition through the lock-free
+  /// interface, where a closed condition means the waiter is triggered, and
+  /// a setter claims the waiter before it writes the value. This must be
+  /// called while holding the LCO lock.
+  void resetFull() {
+    full_.reset();
+    claimed_.store(false, std::memory_order_release);
+  }
+
+  /// Copy the value out, unless it was written directly to @p value.
+  void copy(size_t size, void *value) const {
+    if (value && value != out_ && size_) {
+      memcpy(value, out_, std::min(size, size_));
+    }
+  }
+
+  /// Wait until the full condition is true.
+  hpx_status_t waitFull() {
+    return (full_.closed()) ? full_.getError() : waitForUnlocked(full_);
+  }
+
+  Condition            full_;
+  std::atomic<bool> claimed_;                   //!< a setter owns the value
+  void                *out_;
+  size_t              size_;
+};
+
+static_assert(sizeof(Waiter) <= sizeof(hpx_lco_waiter_t),
+              "Waiter does not fit in hpx_lco_waiter_t");
+static_assert(alignof(hpx_lco_waiter_t) >= libhpx::GAS::WAITER_ALIGN,
+              "hpx_lco_waiter_t alignment is too small for its address form");
+}
+
+hpx_addr_t
+hpx_lco_waiter_init(hpx_lco_waiter_t *waiter, size_t size, void *out)
+{
+  dbg_assert(here && here->gas);
+  new(waiter) Waiter(size, out);
+  return here->gas->waiterToGVA(here->rank, waiter);
+}
+
+hpx_status_t
+hpx_lco_waiter_wait(hpx_lco_waiter_t *waiter)
+{
+  return reinterpret_cast<Waiter*>(waiter)->wait(0);
+}
+
+void
+hpx_lco_waiter_fini(hpx_lco_waiter_t *waiter)
+{
+  reinterpret_cast<Waiter*>(waiter)->~Waiter();
+}
@@ -15,61 +15,93 @@
 #include "config.h"
 #endif
 
-/// @file libhpx/scheduler/lco/monoid.c
+/// @file libhpx/scheduler/lco/monoid.cpp
 /// @brief Implements reductions for "reduce" LCOs.
+///
+/// The built-in operators treat their buffers as arrays of bytes /
+/// sizeof(dtype) elements, so the same operator reduces scalars and vectors.
+/// The loops are instantiated per type and written over restricted pointers
+/// so that the compiler can vectorize them.
 
-#include <cstdlib>
-#include <float.h>
-#include <climits>
+#include "libhpx/action.h"
+#include "hpx/hpx.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 
-#define _HPX_REDUCTION_SUM_DEF(TYPE, dtype, initializer)  \
-  void HPX_##TYPE##_SUM_ID(dtype *i, size_t UNUSED) {     \
-    *i = initializer;                                     \
-  }                                                       \
-  void HPX_##TYPE##_SUM_OP(dtype *i, const dtype *j,      \
-                           size_t UNUSED) {               \
-    *i += *j;                                             \
+namespace {
+struct Sum {
+  template <typename T>
+  T operator()(T lhs, T rhs) const {
+    return lhs + rhs;
   }
+};
 
-_HPX_REDUCTION_SUM_DEF(INT, int, 0);
-_HPX_REDUCTION_SUM_DEF(DOUBLE, double, 0.0);
-_HPX_REDUCTION_SUM_DEF(FLOAT, float, 0.0);
-
-#define _HPX_REDUCTION_PROD_DEF(TYPE, dtype, initializer) \
-  void HPX_##TYPE##_PROD_ID(dtype *i, size_t UNUSED) {    \
-    *i = initializer;                                     \
-  }                                                       \
-  void HPX_##TYPE##_PROD_OP(dtype *i, const dtype *j,     \
-                            size_t UNUSED) {              \
-    *i *= *j;                                             \
+struct Prod {
+  template <typename T>
+  T operator()(T lhs, T rhs) const {
+    return lhs * rhs;
   }
+};
 
-_HPX_REDUCTION_PROD_DEF(INT, int, 1);
-_HPX_REDUCTION_PROD_DEF(DOUBLE, double, 1.0);
-_HPX_REDUCTION_PROD_DEF(FLOAT, float, 1.0);
+struct Max {
+  template <typename T>
+  T operator()(T lhs, T rhs) const {
+    return (lhs > rhs) ? lhs : rhs;
+  }
+};
 
-#define _HPX_REDUCTION_MAX_DEF(TYPE, dtype, initializer)  \
-  void HPX_##TYPE##_MAX_ID(dtype *i, size_t UNUSED) {     \
-    *i = initializer;                                     \
-  }                                                       \
-  void HPX_##TYPE##_MAX_OP(dtype *i, const dtype *j,      \
-                           size_t UNUSED) {               \
-    *i = (*i > *j) ? *i : *j;                             \
+struct Min {
+  template <typename T>
+  T operator()(T lhs, T rhs) const {
+    return (lhs < rhs) ? lhs : rhs;
   }
+};
 
-_HPX_REDUCTION_MAX_DEF(INT, int, -INT_MAX);
-_HPX_REDUCTION_MAX_DEF(DOUBLE, double, -DBL_MAX);
-_HPX_REDUCTION_MAX_DEF(FLOAT, float, -FLT_MAX);
+template <typename T>
+inline void
+Fill(T* __restrict__ i, size_t bytes, const T value)
+{
+  for (size_t n = 0, e = bytes / sizeof(T); n < e; ++n) {
+    i[n] = value;
+  }
+}
 
-#define _HPX_REDUCTION_MIN_DEF(TYPE, dtype, initializer)  \
-  void HPX_##TYPE##_MIN_ID(dtype *i, size_t UNUSED) {     \
-    *i = initializer;                                     \
-  }                                                       \
-  void HPX_##TYPE##_MIN_OP(dtype *i, const dtype *j,      \
-                           size_t UNUSED) {               \
-    *i = (*i < *j) ? *i : *j;                             \
+template <typename T, typename Op>
+inline void
+Apply(T* __restrict__ i, const T* __restrict__ j, size_t bytes, Op&& op)
+{
+  for (size_t n = 0, e = bytes / sizeof(T); n < e; ++n) {
+    i[n] = op(i[n], j[n]);
   }
+}
+}
+
+#define _HPX_MONOID_DEF(TYPE, R, dtype, Op, identity)                   \
+  void HPX_##TYPE##R##ID(dtype *i, size_t bytes) {                      \
+    Fill<dtype>(i, bytes, identity);                                    \
+  }                                                                     \
+  void HPX_##TYPE##R##OP(dtype *i, const dtype *j, size_t bytes) {      \
+    Apply<dtype>(i, j, bytes, Op());                                    \
+  }                                                                     \
+  LIBHPX_ACTION(HPX_FUNCTION, 0, HPX_##TYPE##R##ID_ACTION,              \
+                HPX_##TYPE##R##ID);                                     \
+  LIBHPX_ACTION(HPX_FUNCTION, 0, HPX_##TYPE##R##OP_ACTION,              \
+                HPX_##TYPE##R##OP)
+
+#define _HPX_REDUCTION_DEF(R, Op, identity)                             \
+  _HPX_MONOID_DEF(INT_,    R, int,     Op, identity(int));              \
+  _HPX_MONOID_DEF(INT32_,  R, int32_t, Op, identity(int32_t));          \
+  _HPX_MONOID_DEF(INT64_,  R, int64_t, Op, identity(int64_t));          \
+  _HPX_MONOID_DEF(DOUBLE_, R, double,  Op, identity(double));           \
+  _HPX_MONOID_DEF(FLOAT_,  R, float,   Op, identity(float))
+
+#define _ZERO(T) T(0)
+#define _ONE(T) T(1)
+#define _LOWEST(T) std::numeric_limits<T>::lowest()
+#define _HIGHEST(T) std::numeric_limits<T>::max()
 
-_HPX_REDUCTION_MIN_DEF(INT, int, INT_MAX);
-_HPX_REDUCTION_MIN_DEF(DOUBLE, double, DBL_MAX);
-_HPX_REDUCTION_MIN_DEF(FLOAT, float, FLT_MAX);
+_HPX_REDUCTION_DEF(SUM_, Sum, _ZERO);
+_HPX_REDUCTION_DEF(PROD_, Prod, _ONE);
+_HPX_REDUCTION_DEF(MAX_, Max, _LOWEST);
+_HPX_REDUCTION_DEF(MIN_, Min, _HIGHEST);
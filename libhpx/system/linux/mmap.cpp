@@ -16,6 +16,7 @@
 #endif
 
 #include "libhpx/debug.h"
+#include "libhpx/locality.h"
 #include "libhpx/system.h"
 #include <errno.h>
 #ifdef HAVE_HUGETLBFS
@@ -28,8 +29,13 @@ extern "C" {
 #include <cstring>
 #include <unistd.h>
 #include <sys/mman.h>
+#include <algorithm>
 #include <atomic>
 
+#ifndef MAP_HUGE_SHIFT
+# define MAP_HUGE_SHIFT 26
+#endif
+
 /// We use the hugetlbfs interface. In order to avoid locking around the huge
 /// page fd, we simply open the file once at startup.
 #ifdef HAVE_HUGETLBFS
@@ -145,7 +151,143 @@ void *system_mmap(void *UNUSED, void *addr, size_t n, size_t align) {
   return p;
 }
 
+/// Support for --hpx-heap-hugepages.
+///
+/// Explicit hugetlb pages are tried first, then transparent huge pages, and
+/// finally normal pages. Requests are rounded up and aligned to the selected
+/// page size so that heap chunks start on huge page boundaries. The page size
+/// depends only on the mode and the requested size, so munmap can recompute the
+/// mapped length.
+/// @{
+static const size_t _2M = size_t(1) << 21;
+static const size_t _1G = size_t(1) << 30;
+
+static libhpx_heap_hugepages_t _hugepages_mode(void) {
+  if (here && here->config) {
+    return here->config->heap_hugepages;
+  }
+  return HPX_HEAP_HUGEPAGES_DEFAULT;
+}
+
+static size_t _hugepages_size(libhpx_heap_hugepages_t mode, size_t n) {
+  switch (mode) {
+   case HPX_HEAP_HUGEPAGES_1G:
+    // Small mappings (e.g., registered chunks) would waste most of a 1GB page.
+    if (n >= _1G) {
+      return _1G;
+    }
+    // fall through
+   case HPX_HEAP_HUGEPAGES_2M:
+   case HPX_HEAP_HUGEPAGES_THP:
+    return _2M;
+   default:
+    return 0;
+  }
+}
+
+/// Report each distinct outcome once, so fallbacks aren't silent.
+static void _hugepages_report(libhpx_heap_hugepages_t mode, int outcome) {
+  static const char * const outcomes[] = {
+    "1G hugetlb pages",
+    "2M hugetlb pages",
+    "transparent huge pages",
+    "normal pages"
+  };
+  static std::atomic<unsigned> reported(0);
+  unsigned bit = 1u << outcome;
+  if (reported.fetch_or(bit, std::memory_order_relaxed) & bit) {
+    return;
+  }
+  log_dflt("--hpx-heap-hugepages=%s backed by %s\n",
+           HPX_HEAP_HUGEPAGES_TO_STRING[mode], outcomes[outcome]);
+}
+
+/// Map @p n bytes of hugetlb pages of size @p page aligned to @p align.
+///
+/// We reserve an over-sized region of address space, map the huge pages at
+/// the aligned address inside of it, and trim the reservation. This does not
+/// consume huge pages for the slack like _mmap_aligned() would.
+///
+/// @returns The mapped region, or NULL if there weren't enough huge pages.
+static void *_mmap_hugetlb(void *addr, size_t n, size_t align, size_t page) {
+#ifndef MAP_HUGETLB
+  return NULL;
+#else
+  static const int prot = PROT_READ | PROT_WRITE;
+  static const int reserve = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB |
+                    (__builtin_ctzl(page) << MAP_HUGE_SHIFT);
+
+  char *r = static_cast<char*>(mmap(addr, n + align, PROT_NONE, reserve, -1, 0));
+  if (r == MAP_FAILED) {
+    return NULL;
+  }
+
+  uintptr_t  mask = align - 1;
+  char      *base = (char*)(((uintptr_t)r + mask) & ~mask);
+  uintptr_t prefix = base - r;
+  uintptr_t suffix = align - prefix;
+  if (mmap(base, n, prot, flags, -1, 0) == MAP_FAILED) {
+    log_mem("could not map %zu bytes of %zu byte huge pages: %s\n", n, page,
+            strerror(errno));
+    dbg_check( munmap(r, n + align) );
+    return NULL;
+  }
+
+  if (prefix) {
+    dbg_check( munmap(r, prefix) );
+  }
+  if (suffix) {
+    dbg_check( munmap(base + n, suffix) );
+  }
+  log_mem("mmap %zu bytes at %p from %zu byte huge pages for a total of %zu\n",
+          n, base, page, _update_total(n));
+  return base;
+#endif
+}
+
+static void *_mmap_hugepages(void *addr, size_t n, size_t align,
+                             libhpx_heap_hugepages_t mode) {
+  if (mode == HPX_HEAP_HUGEPAGES_NONE) {
+    return system_mmap(NULL, addr, n, align);
+  }
+
+  size_t page = _hugepages_size(mode, n);
+  n = (n + page - 1) & ~(page - 1);
+  align = std::max(align, page);
+
+  if (mode != HPX_HEAP_HUGEPAGES_THP) {
+    if (page == _1G) {
+      if (void *p = _mmap_hugetlb(addr, n, align, _1G)) {
+        _hugepages_report(mode, 0);
+        return p;
+      }
+    }
+    if (void *p = _mmap_hugetlb(addr, n, align, _2M)) {
+      _hugepages_report(mode, 1);
+      return p;
+    }
+  }
+
+  void *p = system_mmap(NULL, addr, n, align);
+#ifdef MADV_HUGEPAGE
+  if (madvise(p, n, MADV_HUGEPAGE) == 0) {
+    _hugepages_report(mode, 2);
+    return p;
+  }
+  log_mem("madvise(MADV_HUGEPAGE) failed: %s\n", strerror(errno));
+#endif
+  _hugepages_report(mode, 3);
+  return p;
+}
+/// @}
+
 void *system_mmap_huge_pages(void *UNUSED, void *addr, size_t n, size_t align) {
+  libhpx_heap_hugepages_t mode = _hugepages_mode();
+  if (mode != HPX_HEAP_HUGEPAGES_DEFAULT) {
+    return _mmap_hugepages(addr, n, align, mode);
+  }
+
 #ifndef HAVE_HUGETLBFS
   return system_mmap(UNUSED, addr, n, align);
 #else
@@ -186,6 +328,15 @@ void system_munmap(void *UNUSED, void *addr, size_t size) {
 }
 
 void system_munmap_huge_pages(void *UNUSED, void *addr, size_t size) {
+  libhpx_heap_hugepages_t mode = _hugepages_mode();
+  if (mode != HPX_HEAP_HUGEPAGES_DEFAULT) {
+    if (size_t page = _hugepages_size(mode, size)) {
+      size = (size + page - 1) & ~(page - 1);
+    }
+    system_munmap(UNUSED, addr, size);
+    return;
+  }
+
 #ifdef HAVE_HUGETLBFS
   if (size & _hugepage_mask) {
     long r = size & _hugepage_mask;
@@ -0,0 +1,58 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "libhpx/debug.h"
+#include "libhpx/system.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+/// We issue mbind directly rather than depending on libnuma, so we need the
+/// relevant constants from <numaif.h>.
+namespace {
+constexpr int MPOL_PREFERRED_ = 1;
+constexpr int MPOL_INTERLEAVE_ = 3;
+constexpr unsigned MPOL_MF_MOVE_ = (1 << 1);
+constexpr int BITS = sizeof(unsigned long) * CHAR_BIT;
+}
+
+void system_numa_place(void *addr, size_t n, int node, int nodes) {
+  std::vector<unsigned long> mask(nodes / BITS + 1, 0);
+  int mode = MPOL_INTERLEAVE_;
+  if (node < 0) {
+    for (int i = 0; i < nodes; ++i) {
+      mask[i / BITS] |= 1ul << (i % BITS);
+    }
+  }
+  else {
+    mode = MPOL_PREFERRED_;
+    mask.resize(node / BITS + 1, 0);
+    mask[node / BITS] |= 1ul << (node % BITS);
+  }
+
+  // The kernel ignores the last bit of maxnode, so pass one extra.
+  unsigned long maxnode = mask.size() * BITS + 1;
+  if (syscall(SYS_mbind, addr, n, mode, &mask[0], maxnode, MPOL_MF_MOVE_)) {
+    log_mem("mbind of %zu bytes at %p to node %d failed: %s\n", n, addr, node,
+            strerror(errno));
+    return;
+  }
+  log_mem("placed %zu bytes at %p on node %d\n", n, addr, node);
+}
@@ -20,10 +20,16 @@
 #include <hpx/hpx.h>
 #include <libhpx/debug.h>
 #include <libhpx/libhpx.h>
+#include <libhpx/system.h>
 #include <libhpx/time.h>
+#ifdef LIBHPX_HAVE_TSC
+# include <cpuid.h>
+#endif
 
 static hpx_time_t _beginning_of_time;
 
+libhpx_trace_clock_t libhpx_trace_clock = { 0, 0, 1.0 };
+
 void libhpx_time_start(void) {
   _beginning_of_time = hpx_time_now();
 }
@@ -86,3 +92,83 @@ hpx_time_t hpx_time_add(hpx_time_t time1, hpx_time_t time2) {
   int64_t s = (total / 1e9);
   return hpx_time_construct(s, ns);
 }
+
+#ifdef LIBHPX_HAVE_TSC
+/// Check for an invariant TSC, i.e., one that ticks at a constant rate in all
+/// P-, C- and T-states.
+static bool _tsc_invariant(void) {
+  unsigned eax, ebx, ecx, edx;
+  if (__get_cpuid_max(0x80000000, NULL) < 0x80000007) {
+    return false;
+  }
+  __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+  return (edx >> 8) & 1;
+}
+
+/// Read the TSC along with the time since the beginning of time.
+///
+/// The TSC is read between two clock reads, and the tightest of a few tries
+/// is used, with the TSC assigned to the midpoint.
+static uint64_t _tsc_sample(double *ns, double *error) {
+  uint64_t tsc = 0;
+  *error = 1e9;
+  for (int i = 0; i < 5; ++i) {
+    unsigned aux;
+    uint64_t t0 = hpx_time_from_start_ns(hpx_time_now());
+    uint64_t c = __rdtscp(&aux);
+    uint64_t t1 = hpx_time_from_start_ns(hpx_time_now());
+    if (t1 - t0 < *error) {
+      *error = t1 - t0;
+      *ns = (t0 + t1) / 2.0;
+      tsc = c;
+    }
+  }
+  return tsc;
+}
+#endif
+
+void libhpx_time_calibrate(void) {
+#ifdef LIBHPX_HAVE_TSC
+  if (libhpx_trace_clock.tsc) {
+    return;
+  }
+
+  if (!_tsc_invariant()) {
+    log_dflt("TSC is not invariant, tracing with clock_gettime()\n");
+    return;
+  }
+
+  double ns0, ns1, e0, e1;
+  uint64_t c0 = _tsc_sample(&ns0, &e0);
+  system_usleep(10000);
+  uint64_t c1 = _tsc_sample(&ns1, &e1);
+
+  double ticks_per_ns = (c1 - c0) / (ns1 - ns0);
+  libhpx_trace_clock.zero = c0 - (uint64_t)(ns0 * ticks_per_ns);
+  libhpx_trace_clock.ticks_per_ns = ticks_per_ns;
+  libhpx_trace_clock.tsc = 1;
+  log_dflt("tracing with the TSC at %.6f ticks/ns (+/- %.0f ns)\n",
+           ticks_per_ns, e0 + e1);
+#endif
+}
+
+void libhpx_time_check(int worker) {
+#ifdef LIBHPX_HAVE_TSC
+  if (!libhpx_trace_clock.tsc) {
+    return;
+  }
+
+  // Allow for the error in the sample and in the calibration.
+  double ns, error;
+  uint64_t tsc = _tsc_sample(&ns, &error) - libhpx_trace_clock.zero;
+  double skew = tsc / libhpx_trace_clock.ticks_per_ns - ns;
+  if (skew < 0) {
+    skew = -skew;
+  }
+  if (skew > 1000 + 2 * error + ns * 1e-5) {
+    log_dflt("WARNING: worker %d TSC is skewed by %.0f ns. "
+             "Trace timestamps from this worker may be out of order.\n",
+             worker, skew);
+  }
+#endif
+}
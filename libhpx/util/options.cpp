@@ -339,7 +339,10 @@ void config_print(const config_t *cfg, FILE *f) {
              "------------------------\n");
   fprintf(f, "General\n");
   fprintf(f, "  heapsize\t\t%zu\n", cfg->heapsize);
+  fprintf(f, "  hugepages\t\t\"%s\"\n",
+          HPX_HEAP_HUGEPAGES_TO_STRING[cfg->heap_hugepages]);
   fprintf(f, "  gas\t\t\t\"%s\"\n", HPX_GAS_TO_STRING[cfg->gas]);
+  fprintf(f, "  gas numa\t\t\"%s\"\n", HPX_GAS_NUMA_TO_STRING[cfg->gas_numa]);
   fprintf(f, "  boot\t\t\t\"%s\"\n", HPX_BOOT_TO_STRING[cfg->boot]);
   fprintf(f, "  transport\t\t\"%s\"\n", HPX_TRANSPORT_TO_STRING[cfg->transport]);
   fprintf(f, "  network\t\t\"%s\"\n", HPX_NETWORK_TO_STRING[cfg->network]);
@@ -407,6 +410,9 @@ void config_print(const config_t *cfg, FILE *f) {
   fprintf(f, "\nTracinf\n");
   fprintf(f, "  dir\t\t\t\"%s\"\n", cfg->trace_dir);
   fprintf(f, "  trace buffer size\t%zu\n", cfg->trace_buffersize);
+  fprintf(f, "  metrics\t\t\"%s\"\n", cfg->trace_metrics);
+  fprintf(f, "  sample\t\t\"%s\"\n", cfg->trace_sample);
+  fprintf(f, "  counters\t\t\"%s\"\n", cfg->trace_counters);
   fprintf(f, "  trace classes\t\t");
   for (int i = 0, e = _HPX_NELEM(HPX_TRACE_CLASS_TO_STRING); i < e; ++i) {
     uint64_t type = (1lu << i);
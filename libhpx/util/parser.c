@@ -38,6 +38,7 @@ const char *hpx_options_t_help[] = {
   "      --hpx-help                print HPX help  (default=off)",
   "      --hpx-version             print HPX version  (default=off)",
   "      --hpx-heapsize=bytes      set HPX per-PE global heap size",
+  "      --hpx-heap-hugepages=type back the global heap and registered memory with\n                                  huge pages  (possible values=\"default\",\n                                  \"none\", \"thp\", \"2M\", \"1G\")",
   "      --hpx-gas=type            type of Global Address Space (GAS)  (possible\n                                  values=\"default\", \"smp\", \"pgas\",\n                                  \"agas\")",
   "      --hpx-boot=type           HPX bootstrap method to use  (possible\n                                  values=\"default\", \"smp\", \"mpi\",\n                                  \"pmi\")",
   "      --hpx-transport=type      type of transport to use  (possible\n                                  values=\"default\", \"mpi\", \"photon\")",
@@ -54,6 +55,9 @@ const char *hpx_options_t_help[] = {
   "      --hpx-progress-period=nanoseconds\n                                async network progess period",
   "\nGAS Options:",
   "      --hpx-gas-affinity=type   GAS affinity implementation  (possible\n                                  values=\"none\", \"urcu\", \"cuckoo\")",
+  "      --hpx-gas-numa=policy     NUMA placement of global heap chunks  (possible\n                                  values=\"none\", \"local\", \"interleave\")",
+  "      --hpx-rebalancer-sample=accesses\n                                record one of every N load-balanced block\n                                  accesses",
+  "      --hpx-rebalancer-blocks=blocks\n                                per-worker bound on tracked blocks (0 for exact\n                                  statistics)",
   "\nLog options:",
   "      --hpx-log-at=localities   filter by locality, -1 for all (default none)",
   "      --hpx-log-level[=levels]  set the logging level  (possible\n                                  values=\"default\", \"boot\", \"sched\",\n                                  \"gas\", \"lco\", \"net\", \"trans\",\n                                  \"parcel\", \"action\", \"config\",\n                                  \"memory\", \"coll\", \"all\" default=`all')",
@@ -69,6 +73,9 @@ const char *hpx_options_t_help[] = {
   "      --hpx-trace-classes=class filter by class  (possible values=\"parcel\",\n                                  \"network\", \"sched\", \"lco\", \"process\",\n                                  \"memory\", \"trace\", \"gas\",\n                                  \"collective\", \"all\")",
   "      --hpx-trace-dir=dir       output directory (file backend)",
   "      --hpx-trace-buffersize=bytes\n                                size of trace buffers (file backend)",
+  "      --hpx-trace-metrics=path  publish live metrics (stats backend)",
+  "      --hpx-trace-sample=1/N    trace a random 1/N of the root parcels and their descendants",
+  "      --hpx-trace-counters=names count hardware events per worker and action (cycles,instructions,llc-misses,branch-misses,...)",
   "      --hpx-trace-off           disable tracing at startup  (default=off)",
   "\nISIR Network Options:",
   "      --hpx-isir-testwindow=requests\n                                number of ISIR requests to test in progress\n                                  loop",
@@ -150,6 +157,7 @@ free_cmd_list(void)
 }
 
 
+const char *hpx_option_parser_hpx_heap_hugepages_values[] = {"default", "none", "thp", "2M", "1G", 0}; /*< Possible values for hpx-heap-hugepages. */
 const char *hpx_option_parser_hpx_gas_values[] = {"default", "smp", "pgas", "agas", 0}; /*< Possible values for hpx-gas. */
 const char *hpx_option_parser_hpx_boot_values[] = {"default", "smp", "mpi", "pmi", 0}; /*< Possible values for hpx-boot. */
 const char *hpx_option_parser_hpx_transport_values[] = {"default", "mpi", "photon", 0}; /*< Possible values for hpx-transport. */
@@ -157,6 +165,7 @@ const char *hpx_option_parser_hpx_network_values[] = {"default", "smp", "pwc", "
 const char *hpx_option_parser_hpx_thread_affinity_values[] = {"default", "hwthread", "core", "numa", "none", 0}; /*< Possible values for hpx-thread-affinity. */
 const char *hpx_option_parser_hpx_sched_policy_values[] = {"default", "random", "hier", 0}; /*< Possible values for hpx-sched-policy. */
 const char *hpx_option_parser_hpx_gas_affinity_values[] = {"none", "urcu", "cuckoo", 0}; /*< Possible values for hpx-gas-affinity. */
+const char *hpx_option_parser_hpx_gas_numa_values[] = {"none", "local", "interleave", 0}; /*< Possible values for hpx-gas-numa. */
 const char *hpx_option_parser_hpx_log_level_values[] = {"default", "boot", "sched", "gas", "lco", "net", "trans", "parcel", "action", "config", "memory", "coll", "all", 0}; /*< Possible values for hpx-log-level. */
 const char *hpx_option_parser_hpx_dbg_waitonsig_values[] = {"segv", "abrt", "fpe", "ill", "bus", "iot", "sys", "trap", "all", 0}; /*< Possible values for hpx-dbg-waitonsig. */
 const char *hpx_option_parser_hpx_trace_backend_values[] = {"default", "file", "console", "stats", 0}; /*< Possible values for hpx-trace-backend. */
@@ -174,6 +183,7 @@ void clear_given (struct hpx_options_t *args_info)
   args_info->hpx_help_given = 0 ;
   args_info->hpx_version_given = 0 ;
   args_info->hpx_heapsize_given = 0 ;
+  args_info->hpx_heap_hugepages_given = 0 ;
   args_info->hpx_gas_given = 0 ;
   args_info->hpx_boot_given = 0 ;
   args_info->hpx_transport_given = 0 ;
@@ -187,6 +197,9 @@ void clear_given (struct hpx_options_t *args_info)
   args_info->hpx_sched_stackcachelimit_given = 0 ;
   args_info->hpx_progress_period_given = 0 ;
   args_info->hpx_gas_affinity_given = 0 ;
+  args_info->hpx_gas_numa_given = 0 ;
+  args_info->hpx_rebalancer_sample_given = 0 ;
+  args_info->hpx_rebalancer_blocks_given = 0 ;
   args_info->hpx_log_at_given = 0 ;
   args_info->hpx_log_level_given = 0 ;
   args_info->hpx_dbg_waitat_given = 0 ;
@@ -199,6 +212,9 @@ void clear_given (struct hpx_options_t *args_info)
   args_info->hpx_trace_classes_given = 0 ;
   args_info->hpx_trace_dir_given = 0 ;
   args_info->hpx_trace_buffersize_given = 0 ;
+  args_info->hpx_trace_metrics_given = 0 ;
+  args_info->hpx_trace_sample_given = 0 ;
+  args_info->hpx_trace_counters_given = 0 ;
   args_info->hpx_trace_off_given = 0 ;
   args_info->hpx_isir_testwindow_given = 0 ;
   args_info->hpx_isir_sendlimit_given = 0 ;
@@ -237,6 +253,8 @@ void clear_args (struct hpx_options_t *args_info)
   args_info->hpx_help_flag = 0;
   args_info->hpx_version_flag = 0;
   args_info->hpx_heapsize_orig = NULL;
+  args_info->hpx_heap_hugepages_arg = hpx_heap_hugepages__NULL;
+  args_info->hpx_heap_hugepages_orig = NULL;
   args_info->hpx_gas_arg = hpx_gas__NULL;
   args_info->hpx_gas_orig = NULL;
   args_info->hpx_boot_arg = hpx_boot__NULL;
@@ -258,6 +276,10 @@ void clear_args (struct hpx_options_t *args_info)
   args_info->hpx_progress_period_orig = NULL;
   args_info->hpx_gas_affinity_arg = hpx_gas_affinity__NULL;
   args_info->hpx_gas_affinity_orig = NULL;
+  args_info->hpx_gas_numa_arg = hpx_gas_numa__NULL;
+  args_info->hpx_gas_numa_orig = NULL;
+  args_info->hpx_rebalancer_sample_orig = NULL;
+  args_info->hpx_rebalancer_blocks_orig = NULL;
   args_info->hpx_log_at_arg = NULL;
   args_info->hpx_log_at_orig = NULL;
   args_info->hpx_log_level_arg = NULL;
@@ -278,6 +300,12 @@ void clear_args (struct hpx_options_t *args_info)
   args_info->hpx_trace_dir_arg = NULL;
   args_info->hpx_trace_dir_orig = NULL;
   args_info->hpx_trace_buffersize_orig = NULL;
+  args_info->hpx_trace_metrics_arg = NULL;
+  args_info->hpx_trace_metrics_orig = NULL;
+  args_info->hpx_trace_sample_arg = NULL;
+  args_info->hpx_trace_sample_orig = NULL;
+  args_info->hpx_trace_counters_arg = NULL;
+  args_info->hpx_trace_counters_orig = NULL;
   args_info->hpx_trace_off_flag = 0;
   args_info->hpx_isir_testwindow_orig = NULL;
   args_info->hpx_isir_sendlimit_orig = NULL;
@@ -325,72 +353,79 @@ void init_args_info(struct hpx_options_t *args_info)
   args_info->hpx_help_help = hpx_options_t_help[2] ;
   args_info->hpx_version_help = hpx_options_t_help[3] ;
   args_info->hpx_heapsize_help = hpx_options_t_help[4] ;
-  args_info->hpx_gas_help = hpx_options_t_help[5] ;
-  args_info->hpx_boot_help = hpx_options_t_help[6] ;
-  args_info->hpx_transport_help = hpx_options_t_help[7] ;
-  args_info->hpx_network_help = hpx_options_t_help[8] ;
-  args_info->hpx_configfile_help = hpx_options_t_help[9] ;
-  args_info->hpx_threads_help = hpx_options_t_help[11] ;
-  args_info->hpx_thread_affinity_help = hpx_options_t_help[12] ;
-  args_info->hpx_stacksize_help = hpx_options_t_help[13] ;
-  args_info->hpx_sched_policy_help = hpx_options_t_help[14] ;
-  args_info->hpx_sched_wfthreshold_help = hpx_options_t_help[15] ;
-  args_info->hpx_sched_stackcachelimit_help = hpx_options_t_help[16] ;
-  args_info->hpx_progress_period_help = hpx_options_t_help[18] ;
-  args_info->hpx_gas_affinity_help = hpx_options_t_help[20] ;
-  args_info->hpx_log_at_help = hpx_options_t_help[22] ;
+  args_info->hpx_heap_hugepages_help = hpx_options_t_help[5] ;
+  args_info->hpx_gas_help = hpx_options_t_help[6] ;
+  args_info->hpx_boot_help = hpx_options_t_help[7] ;
+  args_info->hpx_transport_help = hpx_options_t_help[8] ;
+  args_info->hpx_network_help = hpx_options_t_help[9] ;
+  args_info->hpx_configfile_help = hpx_options_t_help[10] ;
+  args_info->hpx_threads_help = hpx_options_t_help[12] ;
+  args_info->hpx_thread_affinity_help = hpx_options_t_help[13] ;
+  args_info->hpx_stacksize_help = hpx_options_t_help[14] ;
+  args_info->hpx_sched_policy_help = hpx_options_t_help[15] ;
+  args_info->hpx_sched_wfthreshold_help = hpx_options_t_help[16] ;
+  args_info->hpx_sched_stackcachelimit_help = hpx_options_t_help[17] ;
+  args_info->hpx_progress_period_help = hpx_options_t_help[19] ;
+  args_info->hpx_gas_affinity_help = hpx_options_t_help[21] ;
+  args_info->hpx_gas_numa_help = hpx_options_t_help[22] ;
+  args_info->hpx_rebalancer_sample_help = hpx_options_t_help[23] ;
+  args_info->hpx_rebalancer_blocks_help = hpx_options_t_help[24] ;
+  args_info->hpx_log_at_help = hpx_options_t_help[26] ;
   args_info->hpx_log_at_min = 0;
   args_info->hpx_log_at_max = 0;
-  args_info->hpx_log_level_help = hpx_options_t_help[23] ;
+  args_info->hpx_log_level_help = hpx_options_t_help[27] ;
   args_info->hpx_log_level_min = 0;
   args_info->hpx_log_level_max = 0;
-  args_info->hpx_dbg_waitat_help = hpx_options_t_help[25] ;
+  args_info->hpx_dbg_waitat_help = hpx_options_t_help[29] ;
   args_info->hpx_dbg_waitat_min = 0;
   args_info->hpx_dbg_waitat_max = 0;
-  args_info->hpx_dbg_waitonabort_help = hpx_options_t_help[26] ;
-  args_info->hpx_dbg_waitonsig_help = hpx_options_t_help[27] ;
+  args_info->hpx_dbg_waitonabort_help = hpx_options_t_help[30] ;
+  args_info->hpx_dbg_waitonsig_help = hpx_options_t_help[31] ;
   args_info->hpx_dbg_waitonsig_min = 0;
   args_info->hpx_dbg_waitonsig_max = 0;
-  args_info->hpx_dbg_mprotectstacks_help = hpx_options_t_help[28] ;
-  args_info->hpx_dbg_syncfree_help = hpx_options_t_help[29] ;
-  args_info->hpx_trace_backend_help = hpx_options_t_help[31] ;
-  args_info->hpx_trace_at_help = hpx_options_t_help[32] ;
+  args_info->hpx_dbg_mprotectstacks_help = hpx_options_t_help[32] ;
+  args_info->hpx_dbg_syncfree_help = hpx_options_t_help[33] ;
+  args_info->hpx_trace_backend_help = hpx_options_t_help[35] ;
+  args_info->hpx_trace_at_help = hpx_options_t_help[36] ;
   args_info->hpx_trace_at_min = 0;
   args_info->hpx_trace_at_max = 0;
-  args_info->hpx_trace_classes_help = hpx_options_t_help[33] ;
+  args_info->hpx_trace_classes_help = hpx_options_t_help[37] ;
   args_info->hpx_trace_classes_min = 0;
   args_info->hpx_trace_classes_max = 0;
-  args_info->hpx_trace_dir_help = hpx_options_t_help[34] ;
-  args_info->hpx_trace_buffersize_help = hpx_options_t_help[35] ;
-  args_info->hpx_trace_off_help = hpx_options_t_help[36] ;
-  args_info->hpx_isir_testwindow_help = hpx_options_t_help[38] ;
-  args_info->hpx_isir_sendlimit_help = hpx_options_t_help[39] ;
-  args_info->hpx_isir_recvlimit_help = hpx_options_t_help[40] ;
-  args_info->hpx_pwc_parcelbuffersize_help = hpx_options_t_help[42] ;
-  args_info->hpx_pwc_parceleagerlimit_help = hpx_options_t_help[43] ;
-  args_info->hpx_coll_network_help = hpx_options_t_help[45] ;
-  args_info->hpx_photon_comporder_help = hpx_options_t_help[47] ;
-  args_info->hpx_photon_backend_help = hpx_options_t_help[48] ;
-  args_info->hpx_photon_coll_help = hpx_options_t_help[49] ;
-  args_info->hpx_photon_ibdev_help = hpx_options_t_help[50] ;
-  args_info->hpx_photon_ethdev_help = hpx_options_t_help[51] ;
-  args_info->hpx_photon_ibport_help = hpx_options_t_help[52] ;
-  args_info->hpx_photon_usecma_help = hpx_options_t_help[53] ;
-  args_info->hpx_photon_ibsrq_help = hpx_options_t_help[54] ;
-  args_info->hpx_photon_btethresh_help = hpx_options_t_help[55] ;
-  args_info->hpx_photon_fiprov_help = hpx_options_t_help[56] ;
-  args_info->hpx_photon_fidev_help = hpx_options_t_help[57] ;
-  args_info->hpx_photon_ledgersize_help = hpx_options_t_help[58] ;
-  args_info->hpx_photon_pwcbufsize_help = hpx_options_t_help[59] ;
-  args_info->hpx_photon_eagerbufsize_help = hpx_options_t_help[60] ;
-  args_info->hpx_photon_smallpwcsize_help = hpx_options_t_help[61] ;
-  args_info->hpx_photon_maxrd_help = hpx_options_t_help[62] ;
-  args_info->hpx_photon_defaultrd_help = hpx_options_t_help[63] ;
-  args_info->hpx_photon_numcq_help = hpx_options_t_help[64] ;
-  args_info->hpx_photon_usercq_help = hpx_options_t_help[65] ;
-  args_info->hpx_opt_smp_help = hpx_options_t_help[67] ;
-  args_info->hpx_parcel_compression_help = hpx_options_t_help[68] ;
-  args_info->hpx_coalescing_buffersize_help = hpx_options_t_help[69] ;
+  args_info->hpx_trace_dir_help = hpx_options_t_help[38] ;
+  args_info->hpx_trace_buffersize_help = hpx_options_t_help[39] ;
+  args_info->hpx_trace_metrics_help = hpx_options_t_help[40] ;
+  args_info->hpx_trace_sample_help = hpx_options_t_help[41] ;
+  args_info->hpx_trace_counters_help = hpx_options_t_help[42] ;
+  args_info->hpx_trace_off_help = hpx_options_t_help[43] ;
+  args_info->hpx_isir_testwindow_help = hpx_options_t_help[45] ;
+  args_info->hpx_isir_sendlimit_help = hpx_options_t_help[46] ;
+  args_info->hpx_isir_recvlimit_help = hpx_options_t_help[47] ;
+  args_info->hpx_pwc_parcelbuffersize_help = hpx_options_t_help[49] ;
+  args_info->hpx_pwc_parceleagerlimit_help = hpx_options_t_help[50] ;
+  args_info->hpx_coll_network_help = hpx_options_t_help[52] ;
+  args_info->hpx_photon_comporder_help = hpx_options_t_help[54] ;
+  args_info->hpx_photon_backend_help = hpx_options_t_help[55] ;
+  args_info->hpx_photon_coll_help = hpx_options_t_help[56] ;
+  args_info->hpx_photon_ibdev_help = hpx_options_t_help[57] ;
+  args_info->hpx_photon_ethdev_help = hpx_options_t_help[58] ;
+  args_info->hpx_photon_ibport_help = hpx_options_t_help[59] ;
+  args_info->hpx_photon_usecma_help = hpx_options_t_help[60] ;
+  args_info->hpx_photon_ibsrq_help = hpx_options_t_help[61] ;
+  args_info->hpx_photon_btethresh_help = hpx_options_t_help[62] ;
+  args_info->hpx_photon_fiprov_help = hpx_options_t_help[63] ;
+  args_info->hpx_photon_fidev_help = hpx_options_t_help[64] ;
+  args_info->hpx_photon_ledgersize_help = hpx_options_t_help[65] ;
+  args_info->hpx_photon_pwcbufsize_help = hpx_options_t_help[66] ;
+  args_info->hpx_photon_eagerbufsize_help = hpx_options_t_help[67] ;
+  args_info->hpx_photon_smallpwcsize_help = hpx_options_t_help[68] ;
+  args_info->hpx_photon_maxrd_help = hpx_options_t_help[69] ;
+  args_info->hpx_photon_defaultrd_help = hpx_options_t_help[70] ;
+  args_info->hpx_photon_numcq_help = hpx_options_t_help[71] ;
+  args_info->hpx_photon_usercq_help = hpx_options_t_help[72] ;
+  args_info->hpx_opt_smp_help = hpx_options_t_help[74] ;
+  args_info->hpx_parcel_compression_help = hpx_options_t_help[75] ;
+  args_info->hpx_coalescing_buffersize_help = hpx_options_t_help[76] ;
   
 }
 
@@ -521,6 +556,7 @@ hpx_option_parser_release (struct hpx_options_t *args_info)
 {
 
   free_string_field (&(args_info->hpx_heapsize_orig));
+  free_string_field (&(args_info->hpx_heap_hugepages_orig));
   free_string_field (&(args_info->hpx_gas_orig));
   free_string_field (&(args_info->hpx_boot_orig));
   free_string_field (&(args_info->hpx_transport_orig));
@@ -535,6 +571,9 @@ hpx_option_parser_release (struct hpx_options_t *args_info)
   free_string_field (&(args_info->hpx_sched_stackcachelimit_orig));
   free_string_field (&(args_info->hpx_progress_period_orig));
   free_string_field (&(args_info->hpx_gas_affinity_orig));
+  free_string_field (&(args_info->hpx_gas_numa_orig));
+  free_string_field (&(args_info->hpx_rebalancer_sample_orig));
+  free_string_field (&(args_info->hpx_rebalancer_blocks_orig));
   free_multiple_field (args_info->hpx_log_at_given, (void *)(args_info->hpx_log_at_arg), &(args_info->hpx_log_at_orig));
   args_info->hpx_log_at_arg = 0;
   free_multiple_field (args_info->hpx_log_level_given, (void *)(args_info->hpx_log_level_arg), &(args_info->hpx_log_level_orig));
@@ -551,6 +590,12 @@ hpx_option_parser_release (struct hpx_options_t *args_info)
   free_string_field (&(args_info->hpx_trace_dir_arg));
   free_string_field (&(args_info->hpx_trace_dir_orig));
   free_string_field (&(args_info->hpx_trace_buffersize_orig));
+  free_string_field (&(args_info->hpx_trace_metrics_arg));
+  free_string_field (&(args_info->hpx_trace_metrics_orig));
+  free_string_field (&(args_info->hpx_trace_sample_arg));
+  free_string_field (&(args_info->hpx_trace_sample_orig));
+  free_string_field (&(args_info->hpx_trace_counters_arg));
+  free_string_field (&(args_info->hpx_trace_counters_orig));
   free_string_field (&(args_info->hpx_isir_testwindow_orig));
   free_string_field (&(args_info->hpx_isir_sendlimit_orig));
   free_string_field (&(args_info->hpx_isir_recvlimit_orig));
@@ -665,6 +710,8 @@ hpx_option_parser_dump(FILE *outfile, struct hpx_options_t *args_info)
     write_into_file(outfile, "hpx-version", 0, 0 );
   if (args_info->hpx_heapsize_given)
     write_into_file(outfile, "hpx-heapsize", args_info->hpx_heapsize_orig, 0);
+  if (args_info->hpx_heap_hugepages_given)
+    write_into_file(outfile, "hpx-heap-hugepages", args_info->hpx_heap_hugepages_orig, hpx_option_parser_hpx_heap_hugepages_values);
   if (args_info->hpx_gas_given)
     write_into_file(outfile, "hpx-gas", args_info->hpx_gas_orig, hpx_option_parser_hpx_gas_values);
   if (args_info->hpx_boot_given)
@@ -691,6 +738,12 @@ hpx_option_parser_dump(FILE *outfile, struct hpx_options_t *args_info)
     write_into_file(outfile, "hpx-progress-period", args_info->hpx_progress_period_orig, 0);
   if (args_info->hpx_gas_affinity_given)
     write_into_file(outfile, "hpx-gas-affinity", args_info->hpx_gas_affinity_orig, hpx_option_parser_hpx_gas_affinity_values);
+  if (args_info->hpx_gas_numa_given)
+    write_into_file(outfile, "hpx-gas-numa", args_info->hpx_gas_numa_orig, hpx_option_parser_hpx_gas_numa_values);
+  if (args_info->hpx_rebalancer_sample_given)
+    write_into_file(outfile, "hpx-rebalancer-sample", args_info->hpx_rebalancer_sample_orig, 0);
+  if (args_info->hpx_rebalancer_blocks_given)
+    write_into_file(outfile, "hpx-rebalancer-blocks", args_info->hpx_rebalancer_blocks_orig, 0);
   write_multiple_into_file(outfile, args_info->hpx_log_at_given, "hpx-log-at", args_info->hpx_log_at_orig, 0);
   write_multiple_into_file(outfile, args_info->hpx_log_level_given, "hpx-log-level", args_info->hpx_log_level_orig, hpx_option_parser_hpx_log_level_values);
   write_multiple_into_file(outfile, args_info->hpx_dbg_waitat_given, "hpx-dbg-waitat", args_info->hpx_dbg_waitat_orig, 0);
@@ -709,6 +762,12 @@ hpx_option_parser_dump(FILE *outfile, struct hpx_options_t *args_info)
     write_into_file(outfile, "hpx-trace-dir", args_info->hpx_trace_dir_orig, 0);
   if (args_info->hpx_trace_buffersize_given)
     write_into_file(outfile, "hpx-trace-buffersize", args_info->hpx_trace_buffersize_orig, 0);
+  if (args_info->hpx_trace_metrics_given)
+    write_into_file(outfile, "hpx-trace-metrics", args_info->hpx_trace_metrics_orig, 0);
+  if (args_info->hpx_trace_sample_given)
+    write_into_file(outfile, "hpx-trace-sample", args_info->hpx_trace_sample_orig, 0);
+  if (args_info->hpx_trace_counters_given)
+    write_into_file(outfile, "hpx-trace-counters", args_info->hpx_trace_counters_orig, 0);
   if (args_info->hpx_trace_off_given)
     write_into_file(outfile, "hpx-trace-off", 0, 0 );
   if (args_info->hpx_isir_testwindow_given)
@@ -1966,6 +2025,7 @@ hpx_option_parser_internal (
         { "hpx-help",	0, NULL, 0 },
         { "hpx-version",	0, NULL, 0 },
         { "hpx-heapsize",	1, NULL, 0 },
+        { "hpx-heap-hugepages",	1, NULL, 0 },
         { "hpx-gas",	1, NULL, 0 },
         { "hpx-boot",	1, NULL, 0 },
         { "hpx-transport",	1, NULL, 0 },
@@ -1979,6 +2039,9 @@ hpx_option_parser_internal (
         { "hpx-sched-stackcachelimit",	1, NULL, 0 },
         { "hpx-progress-period",	1, NULL, 0 },
         { "hpx-gas-affinity",	1, NULL, 0 },
+        { "hpx-gas-numa",	1, NULL, 0 },
+        { "hpx-rebalancer-sample",	1, NULL, 0 },
+        { "hpx-rebalancer-blocks",	1, NULL, 0 },
         { "hpx-log-at",	1, NULL, 0 },
         { "hpx-log-level",	2, NULL, 0 },
         { "hpx-dbg-waitat",	1, NULL, 0 },
@@ -1991,6 +2054,9 @@ hpx_option_parser_internal (
         { "hpx-trace-classes",	1, NULL, 0 },
         { "hpx-trace-dir",	1, NULL, 0 },
         { "hpx-trace-buffersize",	1, NULL, 0 },
+        { "hpx-trace-metrics",	1, NULL, 0 },
+        { "hpx-trace-sample",	1, NULL, 0 },
+        { "hpx-trace-counters",	1, NULL, 0 },
         { "hpx-trace-off",	0, NULL, 0 },
         { "hpx-isir-testwindow",	1, NULL, 0 },
         { "hpx-isir-sendlimit",	1, NULL, 0 },
@@ -2078,6 +2144,20 @@ hpx_option_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* back the global heap and registered memory with huge pages.  */
+          else if (strcmp (long_options[option_index].name, "hpx-heap-hugepages") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->hpx_heap_hugepages_arg), 
+                 &(args_info->hpx_heap_hugepages_orig), &(args_info->hpx_heap_hugepages_given),
+                &(local_args_info.hpx_heap_hugepages_given), optarg, hpx_option_parser_hpx_heap_hugepages_values, 0, ARG_ENUM,
+                check_ambiguity, override, 0, 0,
+                "hpx-heap-hugepages", '-',
+                additional_error))
+              goto failure;
+          
           }
           /* type of Global Address Space (GAS).  */
           else if (strcmp (long_options[option_index].name, "hpx-gas") == 0)
@@ -2260,6 +2340,48 @@ hpx_option_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* NUMA placement of global heap chunks.  */
+          else if (strcmp (long_options[option_index].name, "hpx-gas-numa") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->hpx_gas_numa_arg), 
+                 &(args_info->hpx_gas_numa_orig), &(args_info->hpx_gas_numa_given),
+                &(local_args_info.hpx_gas_numa_given), optarg, hpx_option_parser_hpx_gas_numa_values, 0, ARG_ENUM,
+                check_ambiguity, override, 0, 0,
+                "hpx-gas-numa", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* record one of every N load-balanced block accesses.  */
+          else if (strcmp (long_options[option_index].name, "hpx-rebalancer-sample") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->hpx_rebalancer_sample_arg), 
+                 &(args_info->hpx_rebalancer_sample_orig), &(args_info->hpx_rebalancer_sample_given),
+                &(local_args_info.hpx_rebalancer_sample_given), optarg, 0, 0, ARG_LONG,
+                check_ambiguity, override, 0, 0,
+                "hpx-rebalancer-sample", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* per-worker bound on tracked blocks (0 for exact statistics).  */
+          else if (strcmp (long_options[option_index].name, "hpx-rebalancer-blocks") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->hpx_rebalancer_blocks_arg), 
+                 &(args_info->hpx_rebalancer_blocks_orig), &(args_info->hpx_rebalancer_blocks_given),
+                &(local_args_info.hpx_rebalancer_blocks_given), optarg, 0, 0, ARG_LONG,
+                check_ambiguity, override, 0, 0,
+                "hpx-rebalancer-blocks", '-',
+                additional_error))
+              goto failure;
+          
           }
           /* filter by locality, -1 for all (default none).  */
           else if (strcmp (long_options[option_index].name, "hpx-log-at") == 0)
@@ -2404,6 +2526,48 @@ hpx_option_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* publish live metrics (stats backend).  */
+          else if (strcmp (long_options[option_index].name, "hpx-trace-metrics") == 0)
+          {
+
+
+            if (update_arg( (void *)&(args_info->hpx_trace_metrics_arg), 
+                 &(args_info->hpx_trace_metrics_orig), &(args_info->hpx_trace_metrics_given),
+                &(local_args_info.hpx_trace_metrics_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "hpx-trace-metrics", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* trace a random 1/N of the root parcels and their descendants.  */
+          else if (strcmp (long_options[option_index].name, "hpx-trace-sample") == 0)
+          {
+
+
+            if (update_arg( (void *)&(args_info->hpx_trace_sample_arg), 
+                 &(args_info->hpx_trace_sample_orig), &(args_info->hpx_trace_sample_given),
+                &(local_args_info.hpx_trace_sample_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "hpx-trace-sample", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* count hardware events per worker and action (cycles,instructions,llc-misses,branch-misses,...).  */
+          else if (strcmp (long_options[option_index].name, "hpx-trace-counters") == 0)
+          {
+
+
+            if (update_arg( (void *)&(args_info->hpx_trace_counters_arg), 
+                 &(args_info->hpx_trace_counters_orig), &(args_info->hpx_trace_counters_given),
+                &(local_args_info.hpx_trace_counters_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "hpx-trace-counters", '-',
+                additional_error))
+              goto failure;
+          
           }
           /* disable tracing at startup.  */
           else if (strcmp (long_options[option_index].name, "hpx-trace-off") == 0)
@@ -38,6 +38,7 @@ extern "C" {
 #define HPX_OPTION_PARSER_VERSION VERSION
 #endif
 
+enum enum_hpx_heap_hugepages { hpx_heap_hugepages__NULL = -1, hpx_heap_hugepages_arg_default = 0, hpx_heap_hugepages_arg_none, hpx_heap_hugepages_arg_thp, hpx_heap_hugepages_arg_2M, hpx_heap_hugepages_arg_1G };
 enum enum_hpx_gas { hpx_gas__NULL = -1, hpx_gas_arg_default = 0, hpx_gas_arg_smp, hpx_gas_arg_pgas, hpx_gas_arg_agas };
 enum enum_hpx_boot { hpx_boot__NULL = -1, hpx_boot_arg_default = 0, hpx_boot_arg_smp, hpx_boot_arg_mpi, hpx_boot_arg_pmi };
 enum enum_hpx_transport { hpx_transport__NULL = -1, hpx_transport_arg_default = 0, hpx_transport_arg_mpi, hpx_transport_arg_photon };
@@ -45,6 +46,7 @@ enum enum_hpx_network { hpx_network__NULL = -1, hpx_network_arg_default = 0, hpx
 enum enum_hpx_thread_affinity { hpx_thread_affinity__NULL = -1, hpx_thread_affinity_arg_default = 0, hpx_thread_affinity_arg_hwthread, hpx_thread_affinity_arg_core, hpx_thread_affinity_arg_numa, hpx_thread_affinity_arg_none };
 enum enum_hpx_sched_policy { hpx_sched_policy__NULL = -1, hpx_sched_policy_arg_default = 0, hpx_sched_policy_arg_random, hpx_sched_policy_arg_hier };
 enum enum_hpx_gas_affinity { hpx_gas_affinity__NULL = -1, hpx_gas_affinity_arg_none = 0, hpx_gas_affinity_arg_urcu, hpx_gas_affinity_arg_cuckoo };
+enum enum_hpx_gas_numa { hpx_gas_numa__NULL = -1, hpx_gas_numa_arg_none = 0, hpx_gas_numa_arg_local, hpx_gas_numa_arg_interleave };
 enum enum_hpx_log_level { hpx_log_level__NULL = -1, hpx_log_level_arg_default = 0, hpx_log_level_arg_boot, hpx_log_level_arg_sched, hpx_log_level_arg_gas, hpx_log_level_arg_lco, hpx_log_level_arg_net, hpx_log_level_arg_trans, hpx_log_level_arg_parcel, hpx_log_level_arg_action, hpx_log_level_arg_config, hpx_log_level_arg_memory, hpx_log_level_arg_coll, hpx_log_level_arg_all };
 enum enum_hpx_dbg_waitonsig { hpx_dbg_waitonsig__NULL = -1, hpx_dbg_waitonsig_arg_segv = 0, hpx_dbg_waitonsig_arg_abrt, hpx_dbg_waitonsig_arg_fpe, hpx_dbg_waitonsig_arg_ill, hpx_dbg_waitonsig_arg_bus, hpx_dbg_waitonsig_arg_iot, hpx_dbg_waitonsig_arg_sys, hpx_dbg_waitonsig_arg_trap, hpx_dbg_waitonsig_arg_all };
 enum enum_hpx_trace_backend { hpx_trace_backend__NULL = -1, hpx_trace_backend_arg_default = 0, hpx_trace_backend_arg_file, hpx_trace_backend_arg_console, hpx_trace_backend_arg_stats };
@@ -63,6 +65,9 @@ struct hpx_options_t
   long hpx_heapsize_arg;	/**< @brief set HPX per-PE global heap size.  */
   char * hpx_heapsize_orig;	/**< @brief set HPX per-PE global heap size original value given at command line.  */
   const char *hpx_heapsize_help; /**< @brief set HPX per-PE global heap size help description.  */
+  enum enum_hpx_heap_hugepages hpx_heap_hugepages_arg;	/**< @brief back the global heap and registered memory with huge pages.  */
+  char * hpx_heap_hugepages_orig;	/**< @brief back the global heap and registered memory with huge pages original value given at command line.  */
+  const char *hpx_heap_hugepages_help; /**< @brief back the global heap and registered memory with huge pages help description.  */
   enum enum_hpx_gas hpx_gas_arg;	/**< @brief type of Global Address Space (GAS).  */
   char * hpx_gas_orig;	/**< @brief type of Global Address Space (GAS) original value given at command line.  */
   const char *hpx_gas_help; /**< @brief type of Global Address Space (GAS) help description.  */
@@ -102,6 +107,15 @@ struct hpx_options_t
   enum enum_hpx_gas_affinity hpx_gas_affinity_arg;	/**< @brief GAS affinity implementation.  */
   char * hpx_gas_affinity_orig;	/**< @brief GAS affinity implementation original value given at command line.  */
   const char *hpx_gas_affinity_help; /**< @brief GAS affinity implementation help description.  */
+  enum enum_hpx_gas_numa hpx_gas_numa_arg;	/**< @brief NUMA placement of global heap chunks.  */
+  char * hpx_gas_numa_orig;	/**< @brief NUMA placement of global heap chunks original value given at command line.  */
+  const char *hpx_gas_numa_help; /**< @brief NUMA placement of global heap chunks help description.  */
+  long hpx_rebalancer_sample_arg;	/**< @brief record one of every N load-balanced block accesses.  */
+  char * hpx_rebalancer_sample_orig;	/**< @brief record one of every N load-balanced block accesses original value given at command line.  */
+  const char *hpx_rebalancer_sample_help; /**< @brief record one of every N load-balanced block accesses help description.  */
+  long hpx_rebalancer_blocks_arg;	/**< @brief per-worker bound on tracked blocks (0 for exact statistics).  */
+  char * hpx_rebalancer_blocks_orig;	/**< @brief per-worker bound on tracked blocks (0 for exact statistics) original value given at command line.  */
+  const char *hpx_rebalancer_blocks_help; /**< @brief per-worker bound on tracked blocks (0 for exact statistics) help description.  */
   int* hpx_log_at_arg;	/**< @brief filter by locality, -1 for all (default none).  */
   char ** hpx_log_at_orig;	/**< @brief filter by locality, -1 for all (default none) original value given at command line.  */
   unsigned int hpx_log_at_min; /**< @brief filter by locality, -1 for all (default none)'s minimum occurreces */
@@ -147,6 +161,15 @@ struct hpx_options_t
   long hpx_trace_buffersize_arg;	/**< @brief size of trace buffers (file backend).  */
   char * hpx_trace_buffersize_orig;	/**< @brief size of trace buffers (file backend) original value given at command line.  */
   const char *hpx_trace_buffersize_help; /**< @brief size of trace buffers (file backend) help description.  */
+  char * hpx_trace_metrics_arg;	/**< @brief publish live metrics (stats backend).  */
+  char * hpx_trace_metrics_orig;	/**< @brief publish live metrics (stats backend) original value given at command line.  */
+  const char *hpx_trace_metrics_help; /**< @brief publish live metrics (stats backend) help description.  */
+  char * hpx_trace_sample_arg;	/**< @brief trace a random 1/N of the root parcels and their descendants.  */
+  char * hpx_trace_sample_orig;	/**< @brief trace a random 1/N of the root parcels and their descendants original value given at command line.  */
+  const char *hpx_trace_sample_help; /**< @brief trace a random 1/N of the root parcels and their descendants help description.  */
+  char * hpx_trace_counters_arg;	/**< @brief count hardware events per worker and action (cycles,instructions,llc-misses,branch-misses,...).  */
+  char * hpx_trace_counters_orig;	/**< @brief count hardware events per worker and action (cycles,instructions,llc-misses,branch-misses,...) original value given at command line.  */
+  const char *hpx_trace_counters_help; /**< @brief count hardware events per worker and action (cycles,instructions,llc-misses,branch-misses,...) help description.  */
   int hpx_trace_off_flag;	/**< @brief disable tracing at startup (default=off).  */
   const char *hpx_trace_off_help; /**< @brief disable tracing at startup help description.  */
   long hpx_isir_testwindow_arg;	/**< @brief number of ISIR requests to test in progress loop.  */
@@ -234,6 +257,7 @@ struct hpx_options_t
   unsigned int hpx_help_given ;	/**< @brief Whether hpx-help was given.  */
   unsigned int hpx_version_given ;	/**< @brief Whether hpx-version was given.  */
   unsigned int hpx_heapsize_given ;	/**< @brief Whether hpx-heapsize was given.  */
+  unsigned int hpx_heap_hugepages_given ;	/**< @brief Whether hpx-heap-hugepages was given.  */
   unsigned int hpx_gas_given ;	/**< @brief Whether hpx-gas was given.  */
   unsigned int hpx_boot_given ;	/**< @brief Whether hpx-boot was given.  */
   unsigned int hpx_transport_given ;	/**< @brief Whether hpx-transport was given.  */
@@ -247,6 +271,9 @@ struct hpx_options_t
   unsigned int hpx_sched_stackcachelimit_given ;	/**< @brief Whether hpx-sched-stackcachelimit was given.  */
   unsigned int hpx_progress_period_given ;	/**< @brief Whether hpx-progress-period was given.  */
   unsigned int hpx_gas_affinity_given ;	/**< @brief Whether hpx-gas-affinity was given.  */
+  unsigned int hpx_gas_numa_given ;	/**< @brief Whether hpx-gas-numa was given.  */
+  unsigned int hpx_rebalancer_sample_given ;	/**< @brief Whether hpx-rebalancer-sample was given.  */
+  unsigned int hpx_rebalancer_blocks_given ;	/**< @brief Whether hpx-rebalancer-blocks was given.  */
   unsigned int hpx_log_at_given ;	/**< @brief Whether hpx-log-at was given.  */
   unsigned int hpx_log_level_given ;	/**< @brief Whether hpx-log-level was given.  */
   unsigned int hpx_dbg_waitat_given ;	/**< @brief Whether hpx-dbg-waitat was given.  */
@@ -259,6 +286,9 @@ struct hpx_options_t
   unsigned int hpx_trace_classes_given ;	/**< @brief Whether hpx-trace-classes was given.  */
   unsigned int hpx_trace_dir_given ;	/**< @brief Whether hpx-trace-dir was given.  */
   unsigned int hpx_trace_buffersize_given ;	/**< @brief Whether hpx-trace-buffersize was given.  */
+  unsigned int hpx_trace_metrics_given ;	/**< @brief Whether hpx-trace-metrics was given.  */
+  unsigned int hpx_trace_sample_given ;	/**< @brief Whether hpx-trace-sample was given.  */
+  unsigned int hpx_trace_counters_given ;	/**< @brief Whether hpx-trace-counters was given.  */
   unsigned int hpx_trace_off_given ;	/**< @brief Whether hpx-trace-off was given.  */
   unsigned int hpx_isir_testwindow_given ;	/**< @brief Whether hpx-isir-testwindow was given.  */
   unsigned int hpx_isir_sendlimit_given ;	/**< @brief Whether hpx-isir-sendlimit was given.  */
@@ -475,6 +505,7 @@ int hpx_option_parser_string_ext (const char *cmdline, struct hpx_options_t *arg
 int hpx_option_parser_required (struct hpx_options_t *args_info,
   const char *prog_name);
 
+extern const char *hpx_option_parser_hpx_heap_hugepages_values[];  /**< @brief Possible values for hpx-heap-hugepages. */
 extern const char *hpx_option_parser_hpx_gas_values[];  /**< @brief Possible values for hpx-gas. */
 extern const char *hpx_option_parser_hpx_boot_values[];  /**< @brief Possible values for hpx-boot. */
 extern const char *hpx_option_parser_hpx_transport_values[];  /**< @brief Possible values for hpx-transport. */
@@ -482,6 +513,7 @@ extern const char *hpx_option_parser_hpx_network_values[];  /**< @brief Possible
 extern const char *hpx_option_parser_hpx_thread_affinity_values[];  /**< @brief Possible values for hpx-thread-affinity. */
 extern const char *hpx_option_parser_hpx_sched_policy_values[];  /**< @brief Possible values for hpx-sched-policy. */
 extern const char *hpx_option_parser_hpx_gas_affinity_values[];  /**< @brief Possible values for hpx-gas-affinity. */
+extern const char *hpx_option_parser_hpx_gas_numa_values[];  /**< @brief Possible values for hpx-gas-numa. */
 extern const char *hpx_option_parser_hpx_log_level_values[];  /**< @brief Possible values for hpx-log-level. */
 extern const char *hpx_option_parser_hpx_dbg_waitonsig_values[];  /**< @brief Possible values for hpx-dbg-waitonsig. */
 extern const char *hpx_option_parser_hpx_trace_backend_values[];  /**< @brief Possible values for hpx-trace-backend. */
@@ -0,0 +1,198 @@
+#!/usr/bin/env python
+
+# Runs the performance tests in tests/perf over a suite of parameters, and
+# compares the results with a baseline.
+#
+# The tests report their results through tests/perf/bench.h, which appends one
+# JSON object per case to the file given with --bench-json. A suite is a JSON
+# file that lists the programs to run, with their arguments, and the threads,
+# ranks and arguments to sweep them over:
+#
+#   {
+#     "threads": [1, 4],
+#     "ranks": [1],
+#     "benchmarks": [
+#       {"program": "thread_switch", "args": ["10000"]},
+#       {"program": "gasbench", "args": ["-i", "1000"],
+#        "sweep": {"-s": [64, 8192]}}
+#     ]
+#   }
+#
+# A benchmark can override the suite's threads and ranks. Runs with more than
+# one rank need a launcher, e.g., --launcher "mpirun -np {ranks}", otherwise
+# they are skipped.
+#
+# usage: hpxbench.py run [options] suite.json
+#        hpxbench.py compare [options] baseline.json results.json
+
+from __future__ import print_function, division
+import argparse, itertools, json, os, shlex, subprocess, sys, tempfile
+
+def load_suite(filename):
+    with open(filename) as f:
+        return json.load(f)
+
+def points(suite, bench):
+    """Generate the (ranks, threads, args) points for a benchmark."""
+    ranks = bench.get("ranks", suite.get("ranks", [1]))
+    threads = bench.get("threads", suite.get("threads", [1]))
+    sweep = bench.get("sweep", {})
+    flags = sorted(sweep)
+    for r in ranks:
+        for t in threads:
+            for values in itertools.product(*[sweep[k] for k in flags]):
+                args = list(bench.get("args", []))
+                for flag, value in zip(flags, values):
+                    args += [flag, str(value)]
+                yield (r, t, args)
+
+def command(launcher, bindir, program, ranks, threads, args, json_file, opts):
+    cmd = []
+    if launcher:
+        cmd = shlex.split(launcher.format(ranks=ranks))
+    cmd.append(os.path.join(bindir, program))
+    cmd += args
+    cmd += ["--hpx-threads=%d" % threads,
+            "--bench-json=" + json_file,
+            "--bench-reps=%d" % opts.reps,
+            "--bench-warmup=%d" % opts.warmup]
+    return cmd
+
+def run(opts):
+    """Run a suite and write the results as JSON lines, returns the number of
+    programs that failed."""
+    suite = load_suite(opts.suite)
+    (fd, tmp) = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+    failed = 0
+    results = []
+    try:
+        for bench in suite["benchmarks"]:
+            program = bench["program"]
+            if opts.only and program not in opts.only:
+                continue
+            if not os.path.exists(os.path.join(opts.bindir, program)):
+                print("%s: not built, skipping" % program, file=sys.stderr)
+                continue
+            for (r, t, args) in points(suite, bench):
+                if r > 1 and not opts.launcher:
+                    print("%s: %d ranks needs a --launcher, skipping" %
+                          (program, r), file=sys.stderr)
+                    continue
+                open(tmp, "w").close()
+                cmd = command(opts.launcher, opts.bindir, program, r, t, args,
+                              tmp, opts)
+                print("#", " ".join(cmd))
+                sys.stdout.flush()
+                if subprocess.call(cmd):
+                    print("%s: failed" % program, file=sys.stderr)
+                    failed += 1
+                    continue
+                with open(tmp) as f:
+                    results += [json.loads(l) for l in f if l.strip()]
+    finally:
+        os.remove(tmp)
+
+    with open(opts.output, "w") as f:
+        for r in results:
+            f.write(json.dumps(r, sort_keys=True) + "\n")
+    print("wrote %d results to %s" % (len(results), opts.output))
+    return failed
+
+def key(result):
+    params = tuple(sorted(result["params"].items()))
+    return (result["benchmark"], result["case"], params)
+
+def load_results(filename):
+    """Load JSON lines results, keeping the best median for repeated cases."""
+    results = {}
+    with open(filename) as f:
+        for line in f:
+            if not line.strip():
+                continue
+            r = json.loads(line)
+            k = key(r)
+            if k not in results or r["median"] < results[k]["median"]:
+                results[k] = r
+    return results
+
+def _number(v):
+    return str(int(v)) if float(v).is_integer() else "%g" % v
+
+def compare(opts):
+    """Compare results with a baseline, returns the number of regressions.
+
+    A case regresses when its median is more than the threshold slower than
+    the baseline's median, and slower than the baseline's 90th percentile, so
+    that noisy cases need a consistent slowdown to be flagged."""
+    base = load_results(opts.baseline)
+    new = load_results(opts.results)
+    regressions = 0
+    print("%-14s %-24s %-36s %12s %12s %8s" %
+          ("# benchmark", "case", "params", "base (us)", "new (us)", "change"))
+    for k in sorted(base):
+        (bench, case, params) = k
+        b = base[k]
+        label = " ".join("%s=%s" % (p, _number(v)) for (p, v) in params)
+        if k not in new:
+            if opts.verbose:
+                print("%-14s %-24s %-36s %12.3f %12s" %
+                      (bench, case, label, b["median"], "missing"))
+            continue
+        n = new[k]
+        change = (n["median"] / b["median"] - 1) if b["median"] > 0 else 0
+        flag = ""
+        if change > opts.threshold and n["median"] > b.get("p90", 0):
+            flag = "  REGRESSION"
+            regressions += 1
+        elif change < -opts.threshold:
+            flag = "  faster"
+        if flag or opts.verbose:
+            print("%-14s %-24s %-36s %12.3f %12.3f %+7.1f%%%s" %
+                  (bench, case, label, b["median"], n["median"], 100 * change,
+                   flag))
+    compared = len(set(base) & set(new))
+    print("%d cases compared, %d regressions (threshold %.0f%%)" %
+          (compared, regressions, 100 * opts.threshold))
+    return regressions
+
+def main():
+    parser = argparse.ArgumentParser(description="Run and compare the HPX "
+                                     "performance tests.")
+    sub = parser.add_subparsers(dest="command")
+
+    p = sub.add_parser("run", help="run a suite")
+    p.add_argument("suite", help="the suite JSON file")
+    p.add_argument("-o", "--output", default="results.json",
+                   help="the JSON lines file to write (default results.json)")
+    p.add_argument("-b", "--bindir", default=".",
+                   help="the directory with the test programs")
+    p.add_argument("-l", "--launcher",
+                   default=os.environ.get("HPXBENCH_LAUNCHER", ""),
+                   help="the launch command, {ranks} is replaced by the number "
+                        "of ranks, e.g., \"mpirun -np {ranks}\"")
+    p.add_argument("-r", "--reps", type=int, default=5,
+                   help="timed repetitions of each case (default 5)")
+    p.add_argument("-w", "--warmup", type=int, default=1,
+                   help="untimed repetitions of each case (default 1)")
+    p.add_argument("--only", type=lambda s: s.split(","),
+                   help="only run these comma-separated programs")
+
+    p = sub.add_parser("compare", help="compare results with a baseline")
+    p.add_argument("baseline")
+    p.add_argument("results")
+    p.add_argument("-t", "--threshold", type=float, default=0.10,
+                   help="the relative slowdown to flag (default 0.10)")
+    p.add_argument("-v", "--verbose", action="store_true",
+                   help="show every case, not only the changed ones")
+
+    opts = parser.parse_args()
+    if opts.command == "run":
+        return 1 if run(opts) else 0
+    if opts.command == "compare":
+        return 1 if compare(opts) else 0
+    parser.print_help()
+    return 2
+
+if __name__ == '__main__':
+    sys.exit(main())
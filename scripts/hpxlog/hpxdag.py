@@ -0,0 +1,486 @@
+#!/usr/bin/env python
+
+#Streaming analysis of HPX trace streams (the per-worker "HPXtrc" files)
+#Rebuilds the parcel spawn DAG from PARCEL_CREATE parent ids, and reports the
+#critical path, the parallelism profile over time, and what idle workers were
+#waiting for. Only the parcels that are still running are kept in memory, so
+#this works on traces that are much larger than memory.
+#
+#The PARCEL class is required. The SCHED, NETWORK and LCO classes refine the
+#idle time attribution when they are traced.
+#
+#To use as a script: python hpxdag.py [options] trace files...
+
+from __future__ import print_function, division
+import ast, collections, glob, heapq, os, struct, sys
+
+TRACE_DROPPED = 0xffffffff
+
+_CODES = {"b": "b", "i1": "b", "u1": "B", "i2": "h", "u2": "H", "i4": "i",
+          "u4": "I", "i8": "q", "u8": "Q", "f4": "f", "f8": "d"}
+
+def _record_struct(descr):
+    """Convert a numpy descr list into a struct and the names of its fields."""
+    fmt = "<"
+    names = []
+    for (name, code) in descr:
+        code = code.lstrip("<>|=")
+        if code.startswith("a"):
+            fmt += code[1:] + "x"
+        else:
+            fmt += _CODES[code]
+            names.append(name)
+    return (struct.Struct(fmt), names)
+
+def read_header(f):
+    """Read the header of a trace stream, returns its metadata dictionary."""
+    magic = f.read(6)
+    if magic != b"HPXtrc":
+        raise IOError(f.name + " does not appear to be an HPX trace stream.")
+    fmt = "<BBI"
+    (major, minor, meta_len) = struct.unpack(fmt, f.read(struct.calcsize(fmt)))
+    return ast.literal_eval(f.read(meta_len).decode("latin-1").strip("\x00"))
+
+def read_stream(filename, index=0, chunk=1 << 22):
+    """
+    Generate the records in a trace stream, in order, reading it in chunks.
+
+    Each record is a tuple (nanoseconds, index, sequence, rank, worker, event
+    name, fields dictionary). The index and sequence number make records
+    unique so that streams can be merged with heapq.merge. Records that count
+    dropped records have the name "DROPPED" and a "count" field.
+    """
+    with open(filename, "rb") as f:
+        meta = read_header(f)
+        consts = meta.get("consts", {})
+        rank = consts.get("rank", (0,))[0]
+        worker = consts.get("worker", (0,))[0]
+        ticks_per_ns = meta.get("clock", {}).get("ticks_per_ns", 1.0)
+        names = meta.get("names", {})
+        events = {}
+        for (event, header) in meta["events"].items():
+            (s, fields) = _record_struct(header["descr"])
+            events[event] = (names.get(event, "EVENT_%d" % event), s, fields)
+
+        prefix = struct.Struct("<II")
+        dropped = struct.Struct("<QQ")
+        buf = b""
+        offset = 0
+        seq = 0
+        while True:
+            if len(buf) - offset < 8 or \
+               len(buf) - offset < 8 + prefix.unpack_from(buf, offset)[1]:
+                data = f.read(chunk)
+                if not data:
+                    return
+                buf = buf[offset:] + data
+                offset = 0
+                continue
+
+            (event, size) = prefix.unpack_from(buf, offset)
+            offset += 8
+            if event == TRACE_DROPPED:
+                (ns, count) = dropped.unpack_from(buf, offset)
+                record = ("DROPPED", ns, {"count": count})
+            else:
+                (name, s, fields) = events[event]
+                values = s.unpack_from(buf, offset)
+                record = (name, values[0], dict(zip(fields[1:], values[1:])))
+            offset += size
+            seq += 1
+            (name, ns, fields) = record
+            yield (ns / ticks_per_ns, index, seq, rank, worker, name, fields)
+
+def read_all(filenames):
+    """Merge the records from several trace streams in time order."""
+    return heapq.merge(*[read_stream(name, i) for (i, name) in enumerate(filenames)])
+
+def read_actions(filename):
+    """Read an actions.N.csv file into a dictionary of action names."""
+    actions = {}
+    with open(filename) as f:
+        for line in f:
+            fields = line.strip().split(",")
+            if len(fields) >= 2:
+                actions[int(fields[0])] = fields[1]
+    return actions
+
+
+class Node(object):
+    """A parcel in the spawn DAG."""
+    __slots__ = ("id", "action", "parent", "offset", "work", "start", "path",
+                 "created", "ended")
+
+    def __init__(self, id):
+        self.id = id
+        self.action = None
+        self.parent = None                      # the spawning parcel
+        self.offset = 0                         # parent's work before the spawn
+        self.work = 0                           # time spent running
+        self.start = None                       # when it last started running
+        self.path = None                        # critical path to the spawn
+        self.created = False
+        self.ended = False
+
+    def work_at(self, ns):
+        return self.work + (ns - self.start if self.start is not None else 0)
+
+
+class Worker(object):
+    """The idle time accounting for one worker."""
+    __slots__ = ("running", "cause", "saved", "since", "lco")
+
+    def __init__(self, ns):
+        self.running = None
+        self.cause = "sched"
+        self.saved = []
+        self.since = ns
+        self.lco = False
+
+
+class Analysis(object):
+    """
+    Incrementally analyze merged trace records.
+
+    The critical path is the longest chain of parcel execution through the
+    spawn DAG, where a child starts after the work that its parent did before
+    spawning it. Time that parcels spend suspended, e.g., waiting for LCOs, is
+    not work, so this is the critical path of the computation, not of the run.
+
+    A worker is idle when it isn't running a parcel. Idle time is attributed to
+    the last thing the worker did: network progress and probes are "network",
+    the time after a failed steal is "steal", the time after a parcel suspends
+    on an LCO is "lco", and everything else is "sched".
+    """
+    def __init__(self, bin_ns=1e6):
+        self.bin_ns = bin_ns
+        self.live = {}
+        self.deferred = []
+        self.workers = {}
+        self.best = (0, None)
+        self.parcels = 0
+        self.work = 0
+        self.dropped = 0
+        self.idle = collections.defaultdict(float)
+        self.busy = collections.defaultdict(float)
+        self.first = None
+        self.last = None
+
+    def add(self, record):
+        (ns, _, _, rank, worker, name, fields) = record
+        if self.first is None:
+            self.first = ns
+        self.last = ns
+        key = (rank, worker)
+        w = self.workers.get(key)
+        if w is None:
+            w = self.workers[key] = Worker(ns)
+        if w.running is None:
+            self.idle[w.cause] += ns - w.since
+        w.since = ns
+
+        handler = getattr(self, "_" + name, None)
+        if handler:
+            handler(ns, w, fields)
+
+    def _node(self, id):
+        node = self.live.get(id)
+        if node is None:
+            node = self.live[id] = Node(id)
+        return node
+
+    def _release(self, node):
+        if node.created and node.ended:
+            del self.live[node.id]
+
+    def _interval(self, start, end):
+        """Add a busy interval to the parallelism profile."""
+        self.work += end - start
+        b = int(start // self.bin_ns)
+        while start < end:
+            edge = min(end, (b + 1) * self.bin_ns)
+            self.busy[b] += edge - start
+            start = edge
+            b += 1
+
+    def _resolve(self, node):
+        """Find the critical path to @p node's spawn, or None if it's unknown."""
+        chain = []
+        n = node
+        while n.path is None:
+            if not n.created:
+                return None
+            if n.parent is None:
+                n.path = 0
+                break
+            chain.append(n)
+            n = n.parent
+        for c in reversed(chain):
+            c.path = c.parent.path + c.offset
+        return node.path
+
+    def _finish(self, node):
+        path = self._resolve(node)
+        if path is None:
+            self.deferred.append(node)
+        elif path + node.work > self.best[0]:
+            self.best = (path + node.work, node)
+
+    def _DROPPED(self, ns, w, fields):
+        self.dropped += fields["count"]
+
+    def _PARCEL_CREATE(self, ns, w, fields):
+        node = self._node(fields["id"])
+        node.action = fields["action"]
+        node.created = True
+        parent = self.live.get(fields["parent_id"]) if fields["parent_id"] else None
+        if parent is not None:
+            node.parent = parent
+            node.offset = parent.work_at(ns)
+        self._release(node)
+
+    def _PARCEL_RUN(self, ns, w, fields):
+        node = self._node(fields["id"])
+        if node.action is None:
+            node.action = fields["action"]
+        node.start = ns
+        w.running = node
+        w.lco = False
+        self.parcels += 1
+
+    def _PARCEL_RESUME(self, ns, w, fields):
+        node = self._node(fields["id"])
+        node.start = ns
+        w.running = node
+        w.lco = False
+
+    def _stop(self, ns, w, fields):
+        node = self._node(fields["id"])
+        if node.start is not None:
+            node.work += ns - node.start
+            self._interval(node.start, ns)
+            node.start = None
+        w.running = None
+        w.cause = "lco" if w.lco else "sched"
+        w.saved = []
+        return node
+
+    def _PARCEL_SUSPEND(self, ns, w, fields):
+        self._stop(ns, w, fields)
+
+    def _PARCEL_END(self, ns, w, fields):
+        node = self._stop(ns, w, fields)
+        node.ended = True
+        self._finish(node)
+        self._release(node)
+
+    def _LCO_WAIT(self, ns, w, fields):
+        w.lco = True
+
+    def _SCHED_STEAL(self, ns, w, fields):
+        if w.running is None:
+            w.cause = "sched" if fields["id"] else "steal"
+
+    def _network_begin(self, ns, w, fields):
+        if w.running is None:
+            w.saved.append(w.cause)
+            w.cause = "network"
+
+    def _network_end(self, ns, w, fields):
+        if w.running is None and w.saved:
+            w.cause = w.saved.pop()
+
+    _NETWORK_PROGRESS_BEGIN = _network_begin
+    _NETWORK_PROBE_BEGIN = _network_begin
+    _NETWORK_PROGRESS_END = _network_end
+    _NETWORK_PROBE_END = _network_end
+
+    def finish(self):
+        """Resolve the parcels whose spawns were never seen."""
+        for node in self.live.values():
+            node.created = True
+        for node in self.deferred:
+            self._finish(node)
+        self.deferred = []
+        self.live = {}
+        return self
+
+    def critical_path(self):
+        """The parcels on the critical path, root first."""
+        path = []
+        node = self.best[1]
+        while node is not None:
+            path.append(node)
+            node = node.parent
+        return list(reversed(path))
+
+    def profile(self):
+        """The average parallelism in each bin, as (start ns, parallelism)."""
+        if not self.busy:
+            return []
+        lo = min(self.busy)
+        hi = max(self.busy)
+        return [(b * self.bin_ns, self.busy.get(b, 0) / self.bin_ns)
+                for b in range(lo, hi + 1)]
+
+
+def analyze(filenames, bin_ns=1e6):
+    analysis = Analysis(bin_ns)
+    for record in read_all(filenames):
+        analysis.add(record)
+    return analysis.finish()
+
+def report(analysis, actions={}, out=sys.stdout, path_lines=20):
+    ms = 1e6
+    length = analysis.best[0]
+    print("## parcels: {0}".format(analysis.parcels), file=out)
+    print("## work: {0:.3f} ms".format(analysis.work / ms), file=out)
+    print("## critical path: {0:.3f} ms".format(length / ms), file=out)
+    if length:
+        print("## available parallelism: {0:.2f}".format(analysis.work / length), file=out)
+    if analysis.dropped:
+        print("## {0} records were dropped, results are approximate".format(analysis.dropped), file=out)
+
+    path = analysis.critical_path()
+    print("# critical path ({0} parcels, root first)".format(len(path)), file=out)
+    print("{0:>20} {1:>12} {2:>12}  {3}".format("id", "spawn (ms)", "work (ms)", "action"), file=out)
+    for node in path[-path_lines:] if path_lines else path:
+        name = actions.get(node.action, str(node.action))
+        print("{0:>20} {1:>12.3f} {2:>12.3f}  {3}".format(node.id, node.offset / ms, node.work / ms, name), file=out)
+
+    total = sum(analysis.idle.values())
+    print("# idle time by cause", file=out)
+    for (cause, ns) in sorted(analysis.idle.items(), key=lambda e: -e[1]):
+        print("{0:>10} {1:>12.3f} ms {2:>6.1f}%".format(cause, ns / ms, 100 * ns / total if total else 0), file=out)
+
+def save_profile(analysis, filename):
+    with open(filename, "w") as f:
+        print("nanoseconds,parallelism", file=f)
+        for (ns, p) in analysis.profile():
+            print("{0:.0f},{1:.3f}".format(ns, p), file=f)
+
+
+import unittest
+
+def write_stream(filename, rank, worker, records, tsc=0, ticks_per_ns=1.0):
+    """Write a trace stream in the format used by libhpx, for testing."""
+    events = {0: ("PARCEL_CREATE", ["id", "action", "size", "parent_id"]),
+              1: ("PARCEL_RUN", ["id", "action", "size"]),
+              2: ("PARCEL_END", ["id", "action"]),
+              3: ("PARCEL_SUSPEND", ["id", "action"]),
+              4: ("PARCEL_RESUME", ["id", "action"]),
+              5: ("SCHED_STEAL", ["id", "victim"]),
+              6: ("LCO_WAIT", ["addr", "state"]),
+              7: ("NETWORK_PROGRESS_BEGIN", []),
+              8: ("NETWORK_PROGRESS_END", [])}
+    ids = dict((name, (e, fields)) for (e, (name, fields)) in events.items())
+    header = "{'consts': {'rank': (%d, 'i4'), 'worker': (%d, 'i4')}, " \
+             "'clock': {'tsc': %d, 'ticks_per_ns': %f}, 'events': {" % (rank, worker, tsc, ticks_per_ns)
+    for (e, (name, fields)) in sorted(events.items()):
+        descr = [("nanoseconds", "<u8")] + [(n, "<u8") for n in fields]
+        header += "%d: {'descr': %r, 'fortran_order': False, 'consts': {}}, " % (e, descr)
+    header += "}, 'names': {%s}}\n" % ", ".join("%d: %r" % (e, name) for (e, (name, _)) in events.items())
+    header += "\x00" * (16 - (12 + len(header)) % 16)
+    with open(filename, "wb") as f:
+        f.write(b"HPXtrc" + struct.pack("<BBI", 1, 0, len(header)) + header.encode("latin-1"))
+        for (ns, name, args) in records:
+            (e, fields) = ids[name]
+            f.write(struct.pack("<II", e, 8 * (1 + len(args))))
+            f.write(struct.pack("<%dQ" % (1 + len(args)), ns, *args))
+
+class TestDag(unittest.TestCase):
+    def setUp(self):
+        import tempfile
+        self.dir = tempfile.mkdtemp()
+        # Worker 0 runs 1, which spawns 2 and 3 after 10 and 20ns of work.
+        # Worker 1 fails to steal, then runs 3, which spawns 4 after 5ns.
+        # Worker 0 waits on an LCO after 2 ends, then runs 4.
+        self.w0 = os.path.join(self.dir, "00000.000.trace")
+        self.w1 = os.path.join(self.dir, "00000.001.trace")
+        write_stream(self.w0, 0, 0, [
+            (0, "PARCEL_RUN", [1, 7, 0]),
+            (10, "PARCEL_CREATE", [2, 8, 0, 1]),
+            (20, "PARCEL_CREATE", [3, 9, 0, 1]),
+            (30, "PARCEL_END", [1, 7]),
+            (30, "PARCEL_RUN", [2, 8, 0]),
+            (40, "LCO_WAIT", [99, 0]),
+            (40, "PARCEL_SUSPEND", [2, 8]),
+            (60, "PARCEL_RUN", [4, 9, 0]),
+            (160, "PARCEL_END", [4, 9]),
+            (160, "NETWORK_PROGRESS_BEGIN", []),
+            (170, "NETWORK_PROGRESS_END", []),
+            (170, "PARCEL_RESUME", [2, 8]),
+            (175, "PARCEL_END", [2, 8])])
+        write_stream(self.w1, 0, 1, [
+            (0, "SCHED_STEAL", [0, 0]),
+            (25, "PARCEL_RUN", [3, 9, 0]),
+            (30, "PARCEL_CREATE", [4, 9, 0, 3]),
+            (50, "PARCEL_END", [3, 9]),
+            (175, "SCHED_STEAL", [0, 0])], tsc=1, ticks_per_ns=1.0)
+
+    def tearDown(self):
+        import shutil
+        shutil.rmtree(self.dir)
+
+    def test_read_stream(self):
+        records = list(read_stream(self.w0))
+        self.assertEqual(len(records), 13)
+        self.assertEqual(records[1][5], "PARCEL_CREATE")
+        self.assertEqual(records[1][6], {"id": 2, "action": 8, "size": 0, "parent_id": 1})
+
+    def test_small_chunks(self):
+        self.assertEqual(list(read_stream(self.w0)), list(read_stream(self.w0, chunk=7)))
+
+    def test_critical_path(self):
+        a = analyze([self.w0, self.w1], bin_ns=50)
+        # 1 (20ns before spawning 3) -> 3 (5ns before spawning 4) -> 4 (100ns)
+        self.assertEqual(a.best[0], 125)
+        self.assertEqual([n.id for n in a.critical_path()], [1, 3, 4])
+        self.assertEqual(a.work, 30 + 15 + 25 + 100)
+        self.assertEqual(len(a.live), 0)
+
+    def test_idle(self):
+        a = analyze([self.w0, self.w1], bin_ns=50)
+        self.assertEqual(a.idle["steal"], 25)
+        self.assertEqual(a.idle["lco"], 20)
+        self.assertEqual(a.idle["network"], 10)
+        self.assertEqual(a.idle["sched"], 125)
+
+    def test_profile(self):
+        a = analyze([self.w0, self.w1], bin_ns=50)
+        self.assertEqual(a.profile(), [(0, 65 / 50), (50, 40 / 50), (100, 50 / 50), (150, 15 / 50)])
+
+def test():
+    suite = unittest.TestLoader().loadTestsFromTestCase(TestDag)
+    return unittest.TextTestRunner(verbosity=2).run(suite).wasSuccessful()
+
+
+def main():
+    import argparse
+    parser = argparse.ArgumentParser(description="""Analyze HPX trace streams: the critical path through
+                                                    the parcel spawn DAG, the parallelism over time, and the
+                                                    causes of idle time.""")
+    parser.add_argument("files", nargs='+',
+                        help="HPX trace streams (e.g., 00000.000.trace), from any number of localities")
+    parser.add_argument("--actions", "-a", nargs='?',
+                        help="actions.N.csv file used to name actions (default: found next to the traces)")
+    parser.add_argument("--bin", "-b", type=float, default=1.0,
+                        help="Parallelism profile bin width in ms (default 1)")
+    parser.add_argument("--profile", "-p", nargs='?',
+                        help="File to save the parallelism profile as csv")
+    parser.add_argument("--path", type=int, default=20,
+                        help="Number of critical path parcels to print, 0 for all (default 20)")
+    args = parser.parse_args()
+
+    actions = {}
+    found = glob.glob(os.path.join(os.path.dirname(args.files[0]), "actions.*.csv"))
+    if args.actions or found:
+        actions = read_actions(args.actions or found[0])
+
+    analysis = analyze(args.files, args.bin * 1e6)
+    report(analysis, actions, path_lines=args.path)
+    if args.profile:
+        save_profile(analysis, args.profile)
+
+if __name__ == '__main__':
+    main()
@@ -54,6 +54,78 @@ def load_as_numpy(filename, filter_pad=True):
 
 
 
+TRACE_DROPPED = 0xffffffff
+
+def is_trace(filename):
+    "Check if a file is a per-worker HPX trace stream."
+    with open(filename, "rb") as f:
+        return f.read(6) == "HPXtrc"
+
+def load_trace(filename, filter_pad=True):
+    """
+    Reads a per-worker HPX trace stream, returns a list of log dictionaries,
+    one per event described in the stream header, in the same form as
+    load_as_numpy.
+
+    Each record in the stream is prefixed by its event id and size. Records
+    with the TRACE_DROPPED id count the records that the worker dropped
+    because the writer fell behind; their sum is stored as "dropped" in each
+    of the returned logs.
+
+    Streams written with the TSC clock record raw ticks, which are converted
+    to nanoseconds using the calibration in the header.
+
+    Options:
+    filter_pad -- Remove "--pad" fields from output before returning. Default True.
+    """
+    fmt = "<BBI"
+    with open(filename, "rb") as f:
+        magic = f.read(6)
+        if magic != "HPXtrc": raise IOError(filename + " does not appear to be an HPX trace stream.")
+
+        (major, minor, meta_len) = struct.unpack(fmt, f.read(struct.calcsize(fmt)))
+        meta = ast.literal_eval(f.read(meta_len).strip('\x00'))
+        body = f.read()
+
+    chunks = {}
+    dropped = 0
+    offset = 0
+    while offset + 8 <= len(body):
+        (event, size) = struct.unpack_from("<II", body, offset)
+        offset += 8
+        if event == TRACE_DROPPED:
+            dropped += struct.unpack_from("<Q", body, offset + 8)[0]
+        else:
+            chunks.setdefault(event, []).append(body[offset:offset + size])
+        offset += size
+
+    consts = meta.get("consts", {})
+    ticks_per_ns = meta.get("clock", {}).get("ticks_per_ns", 1.0)
+    logs = []
+    for (event, header) in sorted(meta["events"].items()):
+        data = np.frombuffer("".join(chunks.get(event, [])), dtype=header["descr"])
+
+        if filter_pad:
+            names = [n for n in data.dtype.names if not n.startswith("--pad")]
+            data = data[names].copy()
+
+        if ticks_per_ns != 1.0:
+            data = data.copy()
+            ns = data["nanoseconds"]
+            data["nanoseconds"] = (ns / ticks_per_ns).astype(ns.dtype)
+
+        const = dict(consts)
+        const.update(header.get("consts", {}))
+        vals = [e[0] for e in const.values()]
+        types = [e[1] for e in const.values()]
+        consts_arr = np.array([tuple(vals)], dtype=zip(const.keys(), types))
+        logs.append({"data": data, "consts": consts_arr,
+                     "source": "{0}:{1}".format(filename, event),
+                     "dropped": dropped})
+    return logs
+
+
+
 def extend_metadata(log):
     """Produce a new log dictionary with standard metadata
     that may have been missing from the original.  Always
@@ -269,8 +341,17 @@ def merge(*logs, **kwargs):
             "source": [log.get("source", "---") for log in logs]}
 
 def load_all(*filenames, **kwargs):
-    "Load and merge all passed files.  kwargs are passed to merge."
-    arrays = [load_as_numpy(name) for name in filenames]
+    """Load and merge all passed files.  kwargs are passed to merge.
+    Trace streams contribute one log per event."""
+    arrays = []
+    for name in filenames:
+        if is_trace(name):
+            logs = load_trace(name)
+            if logs and logs[0]["dropped"] and not kwargs.get("quiet", False):
+                print("## {0}: {1} records dropped".format(name, logs[0]["dropped"]))
+            arrays.extend(logs)
+        else:
+            arrays.append(load_as_numpy(name))
     return merge(*arrays, **kwargs)
 
 
@@ -334,6 +415,29 @@ class TestLogTools(unittest.TestCase):
         self.assertEqual(len(remerged["consts"]), len(merged["consts"]))
     
     
+    def test_trace_stream(self):
+        import tempfile, os
+        header = "{'consts': {'rank': (0, 'i4'), 'worker': (2, 'i4')}, " \
+                 "'clock': {'tsc': 1, 'ticks_per_ns': 2.0}, 'events': {" \
+                 "3: {'descr': [('nanoseconds', '<i8'), ('id', '<u8')], 'fortran_order': False, " \
+                 "'consts': {'class': (1, 'i4'), 'event': (3, 'i4')}}\n, }}\n"
+        header += "\x00" * (16 - (12 + len(header)) % 16)
+        body = struct.pack("<II", 3, 16) + struct.pack("<qQ", 10, 7)
+        body += struct.pack("<II", TRACE_DROPPED, 16) + struct.pack("<qQ", 11, 5)
+        body += struct.pack("<II", 3, 16) + struct.pack("<qQ", 12, 8)
+        (fd, path) = tempfile.mkstemp()
+        with os.fdopen(fd, "wb") as f:
+            f.write("HPXtrc" + struct.pack("<BBI", 1, 0, len(header)) + header + body)
+        try:
+            self.assertTrue(is_trace(path))
+            (log,) = load_trace(path)
+        finally:
+            os.remove(path)
+        self.assertEqual(log["dropped"], 5)
+        self.assertEqual(list(log["data"]["id"]), [7, 8])
+        self.assertEqual(list(log["data"]["nanoseconds"]), [5, 6])
+        self.assertEqual(sorted(log["consts"].dtype.names), ['class', 'event', 'rank', 'worker'])
+
     def test_condition_drop(self):
         (send, run, resend) = merge_precondition([self.send, self.run, self.resend], 
                                                  force_drop=["worker"])      
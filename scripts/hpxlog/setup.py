@@ -5,5 +5,5 @@ setup(name='hpxlog',
       description='Python tools for working with the hpxlog files (numpy or raw hpxlog format)',
       author='Joseph Cottam',
       author_email='jcottam@indiana.edu',
-      py_modules=['hpxlog']
+      py_modules=['hpxlog', 'hpxdag']
      )
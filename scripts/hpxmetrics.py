@@ -0,0 +1,77 @@
+#!/usr/bin/env python
+
+# Reads the metrics files published by the stats trace backend
+# (--hpx-trace-backend=stats --hpx-trace-metrics=path) and prints them as a
+# table. The files are in the Prometheus text format, so they can also be
+# scraped directly, e.g., by the node exporter's textfile collector.
+#
+# usage: hpxmetrics.py [-w seconds] [-m metric] file...
+#   -w to reprint every few seconds
+#   -m to only show metrics whose names start with the given prefix
+
+from __future__ import print_function
+import getopt, re, sys, time
+
+SAMPLE = re.compile(r'^([a-zA-Z_:][a-zA-Z0-9_:]*)(?:\{(.*)\})?\s+(\S+)$')
+LABEL = re.compile(r'([a-zA-Z_][a-zA-Z0-9_]*)="((?:[^"\\]|\\.)*)"')
+
+def parse(text):
+    """Parse Prometheus text into a list of (name, labels, value) samples."""
+    samples = []
+    for line in text.splitlines():
+        if not line or line.startswith('#'):
+            continue
+        m = SAMPLE.match(line)
+        if not m:
+            continue
+        labels = dict((k, re.sub(r'\\(.)', r'\1', v))
+                      for k, v in LABEL.findall(m.group(2) or ''))
+        samples.append((m.group(1), labels, float(m.group(3))))
+    return samples
+
+def load(filenames):
+    samples = []
+    for filename in filenames:
+        try:
+            with open(filename) as f:
+                samples.extend(parse(f.read()))
+        except IOError as e:
+            print(filename + ": " + str(e), file=sys.stderr)
+    return samples
+
+def show(samples, prefix):
+    """Print one row per sample, grouped by metric."""
+    last = None
+    for name, labels, value in sorted(samples, key=lambda s: s[0]):
+        if not name.startswith(prefix):
+            continue
+        if name != last:
+            print(name)
+            last = name
+        key = ",".join("%s=%s" % (k, labels[k]) for k in sorted(labels))
+        print("  %-60s %14.6g" % (key, value))
+
+if __name__ == '__main__':
+    opts, files = getopt.getopt(sys.argv[1:], "w:m:h")
+    watch = 0
+    prefix = ""
+    for flag, arg in opts:
+        if flag == '-w':
+            watch = float(arg)
+        elif flag == '-m':
+            prefix = arg.strip()
+        elif flag == '-h':
+            print("usage: hpxmetrics.py [-w seconds] [-m metric] file...")
+            sys.exit(0)
+
+    if not files:
+        print("usage: hpxmetrics.py [-w seconds] [-m metric] file...",
+              file=sys.stderr)
+        sys.exit(1)
+
+    while True:
+        show(load(files), prefix)
+        if not watch:
+            break
+        time.sleep(watch)
+        print()
@@ -0,0 +1,275 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifndef LIBHPX_TESTS_PERF_BENCH_H_
+#define LIBHPX_TESTS_PERF_BENCH_H_
+
+/// A small harness for the performance tests.
+///
+/// A benchmark case is a block that is run a number of untimed warmup times
+/// and then a number of timed repetitions:
+///
+///   BENCH(b, "alloc+free", iters) {
+///     ...
+///   }
+///
+/// The case reports the median, 10th, 90th, 99th and 99.9th percentiles,
+/// minimum, and maximum time per operation, in microseconds, where each
+/// repetition is @p ops operations. bench_start() and bench_stop() exclude
+/// setup and teardown inside the block from its repetition's time.
+/// bench_record() reports cases that collect their own samples.
+///
+/// Results are printed as a table, and are appended as JSON lines to the file
+/// given with --bench-json, along with the mean, the parameters set with
+/// bench_param(), and the number of threads and localities.
+/// scripts/hpxbench.py sweeps the benchmarks over threads, ranks and arguments,
+/// and compares the results with a baseline (see `make perfcheck`).
+///
+/// Each case runs once, without warmup, by default, so that `make check` stays
+/// quick. scripts/hpxbench.py asks for more repetitions.
+///
+/// bench_init() removes the harness options from the command line, so it must
+/// be called after hpx_init() and before the benchmark parses its options.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hpx/hpx.h>
+
+#define BENCH_MAX_REPS 1000
+#define BENCH_MAX_PARAMS 8
+
+static struct {
+  const char *name;                             //!< the benchmark's name
+  const char *json;                             //!< the JSON lines file
+  int         reps;
+  int       warmup;
+  int       header;                             //!< printed the table header
+  int      nparams;
+  const char *keys[BENCH_MAX_PARAMS];
+  double    values[BENCH_MAX_PARAMS];
+} _bench = { .name = "bench", .reps = 1 };
+
+typedef struct {
+  const char *name;
+  double       ops;
+  int            i;                             //!< the current repetition
+  int      stopped;
+  hpx_time_t start;
+  double   elapsed;
+  double   samples[BENCH_MAX_REPS];
+} bench_t;
+
+static void bench_usage(FILE *f) {
+  fprintf(f, "Benchmark options:\n"
+          "\t--bench-reps=N    timed repetitions of each case (default 1)\n"
+          "\t--bench-warmup=N  untimed repetitions of each case (default 0)\n"
+          "\t--bench-json=FILE append the results to FILE as JSON lines\n");
+}
+
+/// Parse and remove the --bench-* options.
+static void bench_init(int *argc, char ***argv) {
+  const char *name = strrchr((*argv)[0], '/');
+  name = (name) ? name + 1 : (*argv)[0];
+  if (!strncmp(name, "lt-", 3)) {
+    name += 3;
+  }
+  _bench.name = name;
+
+  int n = 1;
+  for (int i = 1; i < *argc; ++i) {
+    char *arg = (*argv)[i];
+    if (strncmp(arg, "--bench-", 8)) {
+      (*argv)[n++] = arg;
+    }
+    else if (!strncmp(arg, "--bench-reps=", 13)) {
+      _bench.reps = atoi(arg + 13);
+    }
+    else if (!strncmp(arg, "--bench-warmup=", 15)) {
+      _bench.warmup = atoi(arg + 15);
+    }
+    else if (!strncmp(arg, "--bench-json=", 13)) {
+      _bench.json = arg + 13;
+    }
+    else {
+      fprintf(stderr, "%s: unknown option %s\n", name, arg);
+      bench_usage(stderr);
+      exit(EXIT_FAILURE);
+    }
+  }
+  (*argv)[n] = NULL;
+  *argc = n;
+
+  if (_bench.reps < 1 || _bench.reps > BENCH_MAX_REPS || _bench.warmup < 0) {
+    fprintf(stderr, "%s: --bench-reps must be in [1, %d]\n", name,
+            BENCH_MAX_REPS);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/// Set a parameter that is reported with the following cases.
+static void bench_param(const char *key, double value) {
+  int i = 0;
+  while (i < _bench.nparams && strcmp(_bench.keys[i], key)) {
+    ++i;
+  }
+  if (i == BENCH_MAX_PARAMS) {
+    fprintf(stderr, "%s: too many parameters\n", _bench.name);
+    exit(EXIT_FAILURE);
+  }
+  _bench.keys[i] = key;
+  _bench.values[i] = value;
+  _bench.nparams += (i == _bench.nparams);
+}
+
+static int _bench_compare(const void *lhs, const void *rhs) {
+  double l = *(const double*)lhs;
+  double r = *(const double*)rhs;
+  return (l > r) - (l < r);
+}
+
+/// The @p q quantile of @p n sorted samples, interpolating between them.
+static double _bench_quantile(const double *sorted, size_t n, double q) {
+  double x = q * (n - 1);
+  size_t i = (size_t)x;
+  if (i + 1 >= n) {
+    return sorted[n - 1];
+  }
+  return sorted[i] + (x - i) * (sorted[i + 1] - sorted[i]);
+}
+
+static void _bench_string(FILE *f, const char *s) {
+  fputc('"', f);
+  for (; *s; ++s) {
+    if (*s == '"' || *s == '\\') {
+      fputc('\\', f);
+    }
+    fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+/// Report a case from @p n samples, in microseconds per operation.
+static void bench_record(const char *name, const double *us, size_t n) {
+  if (!n) {
+    return;
+  }
+
+  double *sorted = malloc(n * sizeof(*sorted));
+  memcpy(sorted, us, n * sizeof(*sorted));
+  qsort(sorted, n, sizeof(*sorted), _bench_compare);
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sum += sorted[i];
+  }
+
+  double stats[] = {
+    _bench_quantile(sorted, n, 0.5),
+    _bench_quantile(sorted, n, 0.1),
+    _bench_quantile(sorted, n, 0.9),
+    _bench_quantile(sorted, n, 0.99),
+    _bench_quantile(sorted, n, 0.999),
+    sorted[0],
+    sorted[n - 1],
+    sum / n
+  };
+  static const char *const STATS[] = {
+    "median", "p10", "p90", "p99", "p99.9", "min", "max", "mean"
+  };
+  free(sorted);
+
+  if (!_bench.header) {
+    printf("# %s (us/op)\n", _bench.name);
+    printf("%-24s %10s %10s %10s %10s %10s %10s %10s  %s\n", "# case",
+           "median", "p10", "p90", "p99", "p99.9", "min", "max", "params");
+    _bench.header = 1;
+  }
+  printf("%-24s %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f ", name,
+         stats[0], stats[1], stats[2], stats[3], stats[4], stats[5], stats[6]);
+  for (int i = 0; i < _bench.nparams; ++i) {
+    printf(" %s=%g", _bench.keys[i], _bench.values[i]);
+  }
+  printf("\n");
+  fflush(stdout);
+
+  if (!_bench.json) {
+    return;
+  }
+
+  FILE *f = fopen(_bench.json, "a");
+  if (!f) {
+    fprintf(stderr, "%s: could not open %s\n", _bench.name, _bench.json);
+    return;
+  }
+  fprintf(f, "{\"benchmark\": ");
+  _bench_string(f, _bench.name);
+  fprintf(f, ", \"case\": ");
+  _bench_string(f, name);
+  fprintf(f, ", \"params\": {\"threads\": %d, \"ranks\": %d", HPX_THREADS,
+          HPX_LOCALITIES);
+  for (int i = 0; i < _bench.nparams; ++i) {
+    fprintf(f, ", ");
+    _bench_string(f, _bench.keys[i]);
+    fprintf(f, ": %.9g", _bench.values[i]);
+  }
+  fprintf(f, "}, \"unit\": \"us\", \"samples\": %zu", n);
+  for (size_t i = 0; i < sizeof(stats) / sizeof(stats[0]); ++i) {
+    fprintf(f, ", \"%s\": %.9g", STATS[i], stats[i]);
+  }
+  fprintf(f, "}\n");
+  fclose(f);
+}
+
+static bench_t *bench_case(const char *name, double ops) {
+  bench_t *b = calloc(1, sizeof(*b));
+  b->name = name;
+  b->ops = (ops > 0) ? ops : 1;
+  return b;
+}
+
+/// Restart the current repetition's clock, to exclude setup.
+static void bench_start(bench_t *b) {
+  b->start = hpx_time_now();
+}
+
+/// Stop the current repetition's clock, to exclude teardown.
+static void bench_stop(bench_t *b) {
+  b->elapsed = hpx_time_elapsed_us(b->start);
+  b->stopped = 1;
+}
+
+/// Finish the current repetition and start the next, or report the case.
+static int bench_next(bench_t *b) {
+  if (b->i > _bench.warmup) {
+    if (!b->stopped) {
+      bench_stop(b);
+    }
+    b->samples[b->i - _bench.warmup - 1] = b->elapsed / b->ops;
+  }
+
+  if (b->i == _bench.warmup + _bench.reps) {
+    bench_record(b->name, b->samples, _bench.reps);
+    free(b);
+    return 0;
+  }
+
+  b->i++;
+  b->stopped = 0;
+  bench_start(b);
+  return 1;
+}
+
+#define BENCH(b, name, ops)                                 \
+  for (bench_t *b = bench_case(name, ops); bench_next(b); )
+
+#endif /* LIBHPX_TESTS_PERF_BENCH_H_ */
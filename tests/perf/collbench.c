@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <hpx/hpx.h>
+#include "bench.h"
 
 /// This is a microbenchmark to evaluate the performance of collective LCO operations in HPX.
 ///
@@ -116,15 +117,18 @@ static HPX_ACTION(HPX_DEFAULT, 0, _fill_node, _fill_node_handler,
 /// A utility that tests a certain leaf function through I iterations.
 static int _benchmark(char *name, hpx_action_t op, int iters, size_t size) {
   int ranks = HPX_LOCALITIES * HPX_THREADS;
-  hpx_addr_t allreduce = hpx_lco_allreduce_new(ranks, ranks, size, _init, _min);
-  hpx_addr_t done = hpx_lco_and_new(ranks);
-  hpx_time_t start = hpx_time_now();
-  hpx_bcast(_fill_node, HPX_NULL, HPX_NULL, &op, &done, &allreduce, &iters, &size);
-  hpx_lco_wait(done);
-  double elapsed = hpx_time_elapsed_ms(start);
-  hpx_lco_delete(allreduce, HPX_NULL);
-  hpx_lco_delete(done, HPX_NULL);
-  printf("%s: %.7f\n", name, elapsed/iters);
+  BENCH(b, name, iters) {
+    hpx_addr_t allreduce = hpx_lco_allreduce_new(ranks, ranks, size, _init,
+                                                 _min);
+    hpx_addr_t done = hpx_lco_and_new(ranks);
+    bench_start(b);
+    hpx_bcast(_fill_node, HPX_NULL, HPX_NULL, &op, &done, &allreduce, &iters,
+              &size);
+    hpx_lco_wait(done);
+    bench_stop(b);
+    hpx_lco_delete_sync(allreduce);
+    hpx_lco_delete_sync(done);
+  }
   return HPX_SUCCESS;
 }
 #define _XSTR(s) _STR(s)
@@ -133,9 +137,8 @@ static int _benchmark(char *name, hpx_action_t op, int iters, size_t size) {
 
 static HPX_ACTION_DECL(_main);
 static int _main_action(int iters, size_t size) {
-  printf("collbench(iters=%d, size=%zu)\n", iters, size);
-  printf("time resolution: milliseconds\n");
-  fflush(stdout);
+  bench_param("iters", iters);
+  bench_param("size", size);
 
   _BENCHMARK(_allreduce_set_get, iters, size);
   _BENCHMARK(_allreduce_join, iters, size);
@@ -150,6 +153,7 @@ static void _usage(FILE *f, int error) {
              "\t -i iters: number of iterations\n"
              "\t -s  size: size of the buffer to use for the collective\n"
              "\t -h      : show help\n");
+  bench_usage(f);
   hpx_print_help();
   fflush(f);
   exit(error);
@@ -161,6 +165,7 @@ int main(int argc, char *argv[]) {
     fprintf(stderr, "HPX: failed to initialize.\n");
     return e;
   }
+  bench_init(&argc, &argv);
 
   int iters = 100;
   size_t size = 8;
@@ -0,0 +1,145 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+/// Run a wavefront task graph through the dataflow LCO.
+///
+/// The graph is an n x n grid of tiles, where tile (i, j) depends on tiles
+/// (i - 1, j) and (i, j - 1) and is their elementwise sum. Tile (0, 0) is all
+/// ones, so every element of tile (i, j) is the binomial coefficient
+/// C(i + j, i), which is used to check the result. Tiles on the anti-diagonals
+/// are placed cyclically over the localities so that the wavefront crosses
+/// them, and the graph is built once and run several times.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <hpx/hpx.h>
+
+static int _n = 32;
+static int _tile = 512;
+static int _runs = 10;
+
+static void _usage(FILE *f, int error) {
+  fprintf(f, "Usage: dataflow [-n tiles] [-t doubles] [-r runs]\n"
+             "\t -n   tiles: tiles on each side of the grid (default 32)\n"
+             "\t -t doubles: doubles in each tile (default 512)\n"
+             "\t -r    runs: number of runs of the graph (default 10)\n"
+             "\t -h        : show help\n");
+  hpx_print_help();
+  fflush(f);
+  exit(error);
+}
+
+static int _tile_handler(double *inputs[], int n) {
+  double out[_tile];
+  for (int k = 0; k < _tile; ++k) {
+    out[k] = (n) ? 0.0 : 1.0;
+  }
+  for (int i = 0; i < n; ++i) {
+    for (int k = 0; k < _tile; ++k) {
+      out[k] += inputs[i][k];
+    }
+  }
+  return hpx_thread_continue(out, sizeof(out));
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _tile_action, _tile_handler, HPX_POINTER,
+                  HPX_INT);
+
+static int _main_handler(void) {
+  size_t bytes = _tile * sizeof(double);
+  int *ids = calloc(_n * _n, sizeof(*ids));
+  printf("dataflow(n=%d, tile=%zu bytes, runs=%d, localities=%d)\n", _n, bytes,
+         _runs, HPX_LOCALITIES);
+
+  hpx_time_t start = hpx_time_now();
+  hpx_addr_t graph = hpx_lco_dataflow_new();
+  for (int i = 0; i < _n; ++i) {
+    for (int j = 0; j < _n; ++j) {
+      int inputs[2];
+      int n = 0;
+      if (i) {
+        inputs[n++] = ids[(i - 1) * _n + j];
+      }
+      if (j) {
+        inputs[n++] = ids[i * _n + j - 1];
+      }
+      hpx_addr_t at = HPX_THERE((i + j) % HPX_LOCALITIES);
+      ids[i * _n + j] = hpx_lco_dataflow_task(graph, _tile_action, bytes, n,
+                                              inputs, at);
+    }
+  }
+  printf("%-12s %12.3f\n", "build (ms)", hpx_time_elapsed_ms(start));
+
+  double total = 0;
+  for (int r = 0; r < _runs; ++r) {
+    start = hpx_time_now();
+    hpx_lco_dataflow_run(graph);
+    hpx_lco_wait(graph);
+    total += hpx_time_elapsed_ms(start);
+  }
+  double tasks = (double)_n * _n * _runs;
+  printf("%-12s %12.3f\n", "run (ms)", total / _runs);
+  printf("%-12s %12.3f\n", "tasks/ms", tasks / total);
+
+  double *out = malloc(bytes);
+  hpx_lco_dataflow_get_output(graph, ids[_n * _n - 1], bytes, out);
+  double expected = 1;
+  for (int k = 1; k < _n; ++k) {
+    expected = expected * (_n - 1 + k) / k;
+  }
+  int errors = 0;
+  for (int k = 0; k < _tile; ++k) {
+    double diff = out[k] - expected;
+    errors += (diff < -1e-6 * expected || 1e-6 * expected < diff);
+  }
+  if (errors) {
+    fprintf(stderr, "dataflow: %d elements differ from %g\n", errors, expected);
+  }
+
+  free(out);
+  free(ids);
+  hpx_lco_delete_sync(graph);
+  hpx_exit((errors) ? EXIT_FAILURE : EXIT_SUCCESS, NULL);
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _main, _main_handler);
+
+int main(int argc, char *argv[]) {
+  if (hpx_init(&argc, &argv)) {
+    fprintf(stderr, "HPX: failed to initialize.\n");
+    return EXIT_FAILURE;
+  }
+
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "n:t:r:h?")) != -1) {
+    switch (opt) {
+     case 'n':
+      _n = atoi(optarg);
+      break;
+     case 't':
+      _tile = atoi(optarg);
+      break;
+     case 'r':
+      _runs = atoi(optarg);
+      break;
+     case 'h':
+      _usage(stdout, EXIT_SUCCESS);
+     default:
+      _usage(stderr, EXIT_FAILURE);
+    }
+  }
+
+  int e = hpx_run(&_main, NULL);
+  hpx_finalize();
+  return e;
+}
@@ -0,0 +1,164 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+/// A STREAM-style triad over global memory to measure the effect of NUMA
+/// placement of the global heap.
+///
+/// One task per worker runs a triad over its own three arrays of doubles. By
+/// default each task allocates its arrays with hpx_gas_alloc_local(), so the
+/// result reflects the --hpx-gas-numa policy. With -r the main thread
+/// allocates and initializes every array before the tasks start, which
+/// approximates the remote-node case.
+///
+/// Compare, e.g., --hpx-gas-numa=none, local, and interleave. The heap must
+/// hold 3 * n doubles per worker (see --hpx-heapsize).
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <hpx/hpx.h>
+
+static int _n = 1 << 20;
+static int _iters = 10;
+static double *_bandwidth = NULL;
+
+static void _usage(FILE *f, int error) {
+  fprintf(f, "Usage: gas_numa [-n doubles] [-i iters] [-r]\n"
+             "\t -n doubles: array size per task (default 1M)\n"
+             "\t -i   iters: number of triad iterations\n"
+             "\t -r        : allocate and touch all arrays on one worker\n"
+             "\t -h        : show help\n");
+  hpx_print_help();
+  fflush(f);
+  exit(error);
+}
+
+static hpx_addr_t _alloc_arrays(void) {
+  size_t bytes = 3 * _n * sizeof(double);
+  hpx_addr_t arrays = hpx_gas_alloc_local(1, bytes, 0);
+  double *a = NULL;
+  if (!hpx_gas_try_pin(arrays, (void**)&a)) {
+    fprintf(stderr, "failed to pin local arrays\n");
+    exit(EXIT_FAILURE);
+  }
+  for (int i = 0, e = 3 * _n; i < e; ++i) {
+    a[i] = 1.0;
+  }
+  hpx_gas_unpin(arrays);
+  return arrays;
+}
+
+static int _triad_handler(int id, hpx_addr_t arrays) {
+  double *a = NULL;
+  if (!hpx_gas_try_pin(arrays, (void**)&a)) {
+    fprintf(stderr, "failed to pin arrays for task %d\n", id);
+    exit(EXIT_FAILURE);
+  }
+
+  double *b = a + _n;
+  double *c = b + _n;
+  hpx_time_t start = hpx_time_now();
+  for (int k = 0; k < _iters; ++k) {
+    for (int i = 0; i < _n; ++i) {
+      a[i] = b[i] + 3.0 * c[i];
+    }
+  }
+  double elapsed = hpx_time_elapsed_ms(start) / 1e3;
+  hpx_gas_unpin(arrays);
+
+  // 3 doubles move per element: 2 reads and 1 write.
+  _bandwidth[id] = (3.0 * sizeof(double) * _n * _iters) / elapsed / 1e9;
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _triad, _triad_handler, HPX_INT, HPX_ADDR);
+
+static int _local_handler(int id) {
+  hpx_addr_t arrays = _alloc_arrays();
+  _triad_handler(id, arrays);
+  hpx_gas_free_sync(arrays);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _local, _local_handler, HPX_INT);
+
+static int _main_handler(int remote) {
+  int ntasks = HPX_THREADS;
+  _bandwidth = calloc(ntasks, sizeof(*_bandwidth));
+  printf("gas_numa(n=%d, iters=%d, tasks=%d, remote=%d)\n", _n, _iters,
+         ntasks, remote);
+
+  hpx_addr_t *arrays = calloc(ntasks, sizeof(*arrays));
+  if (remote) {
+    for (int i = 0; i < ntasks; ++i) {
+      arrays[i] = _alloc_arrays();
+    }
+  }
+
+  hpx_addr_t done = hpx_lco_and_new(ntasks);
+  for (int i = 0; i < ntasks; ++i) {
+    if (remote) {
+      hpx_call(HPX_HERE, _triad, done, &i, &arrays[i]);
+    }
+    else {
+      hpx_call(HPX_HERE, _local, done, &i);
+    }
+  }
+  hpx_lco_wait(done);
+  hpx_lco_delete(done, HPX_NULL);
+
+  double total = 0;
+  for (int i = 0; i < ntasks; ++i) {
+    total += _bandwidth[i];
+    if (remote) {
+      hpx_gas_free_sync(arrays[i]);
+    }
+  }
+  printf("triad bandwidth (GB/s): %.3f total, %.3f per task\n", total,
+         total / ntasks);
+
+  free(arrays);
+  free(_bandwidth);
+  hpx_exit(0, NULL);
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _main, _main_handler, HPX_INT);
+
+int main(int argc, char *argv[]) {
+  if (hpx_init(&argc, &argv)) {
+    fprintf(stderr, "HPX: failed to initialize.\n");
+    return EXIT_FAILURE;
+  }
+
+  int remote = 0;
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "n:i:rh?")) != -1) {
+    switch (opt) {
+     case 'n':
+      _n = atoi(optarg);
+      break;
+     case 'i':
+      _iters = atoi(optarg);
+      break;
+     case 'r':
+      remote = 1;
+      break;
+     case 'h':
+      _usage(stdout, EXIT_SUCCESS);
+     default:
+      _usage(stderr, EXIT_FAILURE);
+    }
+  }
+
+  int e = hpx_run(&_main, NULL, &remote);
+  hpx_finalize();
+  return e;
+}
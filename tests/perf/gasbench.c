@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <hpx/hpx.h>
+#include "bench.h"
 
 static __thread hpx_addr_t *addrs = NULL;
 
@@ -24,6 +25,7 @@ static void _usage(FILE *f, int error) {
              "\t -i iters: number of iterations\n"
              "\t -s size: size of GAS objects to allocate\n"
              "\t -h      : show help\n");
+  bench_usage(f);
   hpx_print_help();
   fflush(f);
   exit(error);
@@ -69,30 +71,41 @@ int _frees(const int tid, void *a) {
   return HPX_SUCCESS;
 }
 
-static void _run(void *f, _alloc_args_t *args, char *fmt) {
-  int iters = args->iters;
-  hpx_time_t start = hpx_time_now();
+static void _run(void *f, _alloc_args_t *args) {
   hpx_par_for_sync(f, 0, HPX_THREADS, args);
-  double elapsed = hpx_time_elapsed_us(start);
-  printf("%s: %.7f\n", fmt, elapsed/iters);
 }
 
 static int _main_action(int iters, size_t size) {
-  printf("gasbench(iters=%d, size=%zu, threads=%d)\n",
-         iters, size, HPX_THREADS);
-  printf("time resolution: microseconds\n");
-  fflush(stdout);
-
-  _alloc_args_t args = { .iters = iters, .size = size, .fn = NULL };
-  args.fn = hpx_gas_alloc_local;
-  _run(_alloc_free, &args, "alloc+free");
-  _run(_allocs, &args, "alloc");
-  _run(_frees, &args, "free");
-
-  args.fn = hpx_gas_calloc_local;
-  _run(_alloc_free, &args, "calloc+free");
-  _run(_allocs, &args, "calloc");
-  _run(_frees, &args, "free");
+  bench_param("iters", iters);
+  bench_param("size", size);
+
+  static const char *names[][3] = {
+    {"alloc+free", "alloc", "free"},
+    {"calloc+free", "calloc", "cfree"}
+  };
+  hpx_addr_t (*fns[])(size_t, size_t, uint32_t) = {
+    hpx_gas_alloc_local,
+    hpx_gas_calloc_local
+  };
+
+  for (int i = 0; i < 2; ++i) {
+    _alloc_args_t args = { .iters = iters, .size = size, .fn = fns[i] };
+    BENCH(b, names[i][0], iters) {
+      _run(_alloc_free, &args);
+    }
+
+    BENCH(b, names[i][1], iters) {
+      _run(_allocs, &args);
+      bench_stop(b);
+      _run(_frees, &args);
+    }
+
+    BENCH(b, names[i][2], iters) {
+      _run(_allocs, &args);
+      bench_start(b);
+      _run(_frees, &args);
+    }
+  }
 
   hpx_exit(0, NULL);
 }
@@ -104,6 +117,7 @@ int main(int argc, char *argv[]) {
     fprintf(stderr, "HPX: failed to initialize.\n");
     return e;
   }
+  bench_init(&argc, &argv);
 
   int iters = 5;
   size_t size = 8192;
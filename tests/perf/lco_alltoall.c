@@ -0,0 +1,137 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+/// Compare the central alltoall LCO with the pairwise alltoall.
+///
+/// Each of n participants scatters a row of n blocks and gathers the n blocks
+/// sent to it, for a number of iterations. Participants are spread cyclically
+/// over the localities.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <hpx/hpx.h>
+#include "bench.h"
+
+static int _n = 32;
+static size_t _block = 1024;
+static int _iters = 10;
+
+static void _usage(FILE *f, int error) {
+  fprintf(f, "Usage: lco_alltoall [-n participants] [-s bytes] [-i iters]\n"
+             "\t -n participants: number of participants (default 32)\n"
+             "\t -s       bytes: bytes per pair (default 1024)\n"
+             "\t -i       iters: number of exchanges (default 10)\n"
+             "\t -h            : show help\n");
+  bench_usage(f);
+  hpx_print_help();
+  fflush(f);
+  exit(error);
+}
+
+static int _central_handler(hpx_addr_t lco, int id) {
+  size_t size = _n * _block;
+  char *row = malloc(size);
+  char *out = malloc(size);
+  for (int i = 0; i < _iters; ++i) {
+    hpx_lco_alltoall_setid(lco, id, size, row, HPX_NULL, HPX_NULL);
+    hpx_lco_alltoall_getid(lco, id, size, out);
+  }
+  free(out);
+  free(row);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _central, _central_handler, HPX_ADDR,
+                  HPX_INT);
+
+static int _pairwise_handler(hpx_addr_t lco, int id) {
+  size_t size = _n * _block;
+  char *row = hpx_malloc_registered(size);
+  char *out = malloc(size);
+  for (int i = 0; i < _iters; ++i) {
+    hpx_lco_alltoall_pairwise_setid(lco, id, size, row, HPX_NULL, HPX_NULL);
+    hpx_lco_alltoall_pairwise_getid(lco, id, size, out);
+  }
+  free(out);
+  hpx_free_registered(row);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _pairwise, _pairwise_handler, HPX_ADDR,
+                  HPX_INT);
+
+static void _run(hpx_action_t participant, hpx_addr_t lco) {
+  hpx_addr_t done = hpx_lco_and_new(_n);
+  for (int i = 0; i < _n; ++i) {
+    hpx_call(HPX_THERE(i % HPX_LOCALITIES), participant, done, &lco, &i);
+  }
+  hpx_lco_wait(done);
+  hpx_lco_delete(done, HPX_NULL);
+}
+
+static int _main_handler(void) {
+  size_t size = _n * _block;
+  bench_param("n", _n);
+  bench_param("size", _block);
+  bench_param("iters", _iters);
+
+  BENCH(b, "central", _iters) {
+    hpx_addr_t lco = hpx_lco_alltoall_new(_n, size);
+    bench_start(b);
+    _run(_central, lco);
+    bench_stop(b);
+    hpx_lco_delete_sync(lco);
+  }
+
+  BENCH(b, "pairwise", _iters) {
+    hpx_addr_t lco = hpx_lco_alltoall_pairwise_new(_n, size);
+    bench_start(b);
+    _run(_pairwise, lco);
+    bench_stop(b);
+    hpx_lco_delete_sync(lco);
+  }
+
+  hpx_exit(0, NULL);
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _main, _main_handler);
+
+int main(int argc, char *argv[]) {
+  if (hpx_init(&argc, &argv)) {
+    fprintf(stderr, "HPX: failed to initialize.\n");
+    return EXIT_FAILURE;
+  }
+  bench_init(&argc, &argv);
+
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "n:s:i:h?")) != -1) {
+    switch (opt) {
+     case 'n':
+      _n = atoi(optarg);
+      break;
+     case 's':
+      _block = strtoul(optarg, NULL, 0);
+      break;
+     case 'i':
+      _iters = atoi(optarg);
+      break;
+     case 'h':
+      _usage(stdout, EXIT_SUCCESS);
+     default:
+      _usage(stderr, EXIT_FAILURE);
+    }
+  }
+
+  int e = hpx_run(&_main, NULL);
+  hpx_finalize();
+  return e;
+}
@@ -16,12 +16,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <hpx/hpx.h>
-
-#define BENCHMARK "HPX COST OF LCO AND"
-
-#define HEADER "# " BENCHMARK "\n"
-#define FIELD_WIDTH 10
-#define HEADER_FIELD_WIDTH 5
+#include "bench.h"
 
 static int num[] = {
   10000,
@@ -34,11 +29,13 @@ static int num[] = {
 static void _usage(FILE *stream) {
   fprintf(stream, "Usage: time_lco_and overhead \n"
           "\t-h, this help display\n");
+  bench_usage(stream);
   hpx_print_help();
   fflush(stream);
 }
 
 static hpx_action_t _lco_set  = 0;
+static hpx_action_t _lco_set_n = 0;
 static hpx_action_t _main = 0;
 static hpx_action_t _empty = 0;
 
@@ -52,44 +49,71 @@ static int _empty_action(hpx_addr_t *args, size_t size) {
   return HPX_SUCCESS;
 }
 
-static int _main_action(void) {
-  printf(HEADER);
-  printf("# Latency in (ms)\n");
-  printf("%s%*s%*s%*s\n", "# Iters " , FIELD_WIDTH, "Init time ",
-          FIELD_WIDTH, "LCO Set", FIELD_WIDTH, "Delete");
+// Set the and @p n times in a loop, so that one task per worker hammers the
+// same LCO concurrently.
+static int _lco_set_n_action(hpx_addr_t lco, int n) {
+  for (int i = 0; i < n; ++i) {
+    hpx_lco_set(lco, 0, NULL, HPX_NULL, HPX_NULL);
+  }
+  return HPX_SUCCESS;
+}
 
+static int _main_action(void) {
   for (int i = 0; i < sizeof(num)/sizeof(num[0]) ; i++) {
-    printf("%d", num[i]);
-
-
-    hpx_time_t t = hpx_time_now();
-    hpx_addr_t setlco = hpx_lco_and_new(num[i]);
-    printf("%*g", FIELD_WIDTH, hpx_time_elapsed_ms(t));
-
-    // Time it takes to set empty action
-    hpx_addr_t completed = hpx_lco_and_new(num[i]);
-    hpx_time_t t1 = hpx_time_now();
-    for (int j = 0; j < num[i]; j++)
-      hpx_call(HPX_HERE, _empty, completed, NULL, 0);
-    hpx_lco_wait(completed);
-    double empty_t = hpx_time_elapsed_ms(t1);
-    hpx_lco_delete(completed, HPX_NULL);
-
-    // Time to set for LCO argument
-    t = hpx_time_now();
-    hpx_addr_t done = hpx_lco_and_new(num[i]);
-    for (int j = 0; j < num[i]; j++)
-      hpx_call(HPX_HERE, _lco_set, done, &setlco, sizeof(setlco));
-    hpx_lco_wait(setlco);
-    double end_t = hpx_time_elapsed_ms(t);
-    printf("%*g",FIELD_WIDTH, end_t - empty_t);
-
-    t = hpx_time_now();
-    hpx_lco_delete(setlco, HPX_NULL);
-    printf("%*g\n",FIELD_WIDTH, hpx_time_elapsed_ms(t));
-
-    hpx_lco_wait(done);
-    hpx_lco_delete(done, HPX_NULL);
+    int n = num[i];
+    bench_param("n", n);
+
+    BENCH(b, "new", 1) {
+      hpx_addr_t lco = hpx_lco_and_new(n);
+      bench_stop(b);
+      hpx_lco_delete_sync(lco);
+    }
+
+    // Time it takes to call an empty action, to compare with the sets
+    BENCH(b, "call", n) {
+      hpx_addr_t completed = hpx_lco_and_new(n);
+      bench_start(b);
+      for (int j = 0; j < n; j++)
+        hpx_call(HPX_HERE, _empty, completed, NULL, 0);
+      hpx_lco_wait(completed);
+      bench_stop(b);
+      hpx_lco_delete_sync(completed);
+    }
+
+    // Time to call an action that sets the LCO argument
+    BENCH(b, "call+set", n) {
+      hpx_addr_t setlco = hpx_lco_and_new(n);
+      hpx_addr_t done = hpx_lco_and_new(n);
+      bench_start(b);
+      for (int j = 0; j < n; j++)
+        hpx_call(HPX_HERE, _lco_set, done, &setlco, sizeof(setlco));
+      hpx_lco_wait(setlco);
+      bench_stop(b);
+      hpx_lco_wait(done);
+      hpx_lco_delete_sync(done);
+      hpx_lco_delete_sync(setlco);
+    }
+
+    BENCH(b, "delete", 1) {
+      hpx_addr_t lco = hpx_lco_and_new(n);
+      bench_start(b);
+      hpx_lco_delete(lco, HPX_NULL);
+    }
+
+    // Time for one setter per worker to set the same and concurrently
+    int per = n / HPX_THREADS;
+    BENCH(b, "contended", per * HPX_THREADS) {
+      hpx_addr_t contended = hpx_lco_and_new(per * HPX_THREADS);
+      hpx_addr_t done = hpx_lco_and_new(HPX_THREADS);
+      bench_start(b);
+      for (int j = 0; j < HPX_THREADS; j++)
+        hpx_call(HPX_HERE, _lco_set_n, done, &contended, &per);
+      hpx_lco_wait(contended);
+      bench_stop(b);
+      hpx_lco_wait(done);
+      hpx_lco_delete_sync(done);
+      hpx_lco_delete_sync(contended);
+    }
   }
 
   hpx_exit(0, NULL);
@@ -98,6 +122,7 @@ static int _main_action(void) {
 int main(int argc, char *argv[]) {
   // register the actions
   HPX_REGISTER_ACTION(HPX_DEFAULT, HPX_MARSHALLED, _lco_set, _lco_set_action, HPX_POINTER, HPX_SIZE_T);
+  HPX_REGISTER_ACTION(HPX_DEFAULT, 0, _lco_set_n, _lco_set_n_action, HPX_ADDR, HPX_INT);
   HPX_REGISTER_ACTION(HPX_DEFAULT, 0, _main, _main_action);
   HPX_REGISTER_ACTION(HPX_DEFAULT, HPX_MARSHALLED, _empty, _empty_action, HPX_POINTER, HPX_SIZE_T);
 
@@ -105,6 +130,7 @@ int main(int argc, char *argv[]) {
     fprintf(stderr, "HPX: failed to initialize.\n");
     return 1;
   }
+  bench_init(&argc, &argv);
 
   int opt = 0;
   while ((opt = getopt(argc, argv, "h?")) != -1) {
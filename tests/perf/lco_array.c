@@ -0,0 +1,143 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+/// Measure set traffic on large arrays of and LCOs.
+///
+/// Each array has n and LCOs with one input per round. One driver task per
+/// worker sends a set parcel to every element j where j % workers is its id,
+/// for each round, and then the main thread waits for all of the elements with
+/// hpx_lco_wait_all(). This is run for a plain local array, and for sharded
+/// arrays with each of the affinity policies.
+///
+/// Affinity only steers parcels when --hpx-gas-affinity is not none.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <hpx/hpx.h>
+#include "bench.h"
+
+static int _n = 1 << 16;
+static int _rounds = 16;
+
+static void _usage(FILE *f, int error) {
+  fprintf(f, "Usage: lco_array [-n elements] [-r rounds]\n"
+             "\t -n elements: number of lcos in the array (default 64K)\n"
+             "\t -r   rounds: number of sets per lco (default 16)\n"
+             "\t -h         : show help\n");
+  bench_usage(f);
+  hpx_print_help();
+  fflush(f);
+  exit(error);
+}
+
+static int _bump_handler(void) {
+  hpx_lco_set(hpx_thread_current_target(), 0, NULL, HPX_NULL, HPX_NULL);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _bump, _bump_handler);
+
+static int _driver_handler(int id, int workers, hpx_addr_t *lcos) {
+  for (int r = 0; r < _rounds; ++r) {
+    for (int j = id; j < _n; j += workers) {
+      hpx_call(lcos[j], _bump, HPX_NULL);
+    }
+  }
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _driver, _driver_handler, HPX_INT, HPX_INT,
+                  HPX_POINTER);
+
+static void _run(hpx_addr_t *lcos) {
+  int workers = HPX_THREADS;
+  hpx_addr_t done = hpx_lco_and_new(workers);
+  for (int i = 0; i < workers; ++i) {
+    hpx_call(HPX_HERE, _driver, done, &i, &workers, &lcos);
+  }
+  hpx_lco_wait(done);
+  hpx_lco_delete(done, HPX_NULL);
+  hpx_lco_wait_all(_n, lcos, NULL);
+}
+
+static int _main_handler(void) {
+  hpx_addr_t *lcos = calloc(_n, sizeof(*lcos));
+  double sets = (double)_n * _rounds;
+  bench_param("n", _n);
+  bench_param("rounds", _rounds);
+
+  BENCH(b, "local", sets) {
+    hpx_addr_t base = hpx_lco_and_local_array_new(_n, _rounds);
+    for (int i = 0; i < _n; ++i) {
+      lcos[i] = hpx_lco_array_at(base, i, 0);
+    }
+    bench_start(b);
+    _run(lcos);
+    bench_stop(b);
+    hpx_lco_delete_sync(base);
+  }
+
+  static const char *names[] = {"cyclic", "blocked", "numa"};
+  hpx_affinity_policy_t policies[] = {
+    HPX_AFFINITY_CYCLIC,
+    HPX_AFFINITY_BLOCKED,
+    HPX_AFFINITY_NUMA
+  };
+  for (int p = 0; p < 3; ++p) {
+    BENCH(b, names[p], sets) {
+      hpx_addr_t base = hpx_lco_and_sharded_array_new(_n, _rounds, policies[p]);
+      for (int i = 0; i < _n; ++i) {
+        lcos[i] = hpx_lco_sharded_array_at(base, i, 0);
+      }
+      bench_start(b);
+      _run(lcos);
+      bench_stop(b);
+      hpx_addr_t sync = hpx_lco_future_new(0);
+      hpx_lco_sharded_array_delete(base, _n, 0, sync);
+      hpx_lco_wait(sync);
+      hpx_lco_delete(sync, HPX_NULL);
+    }
+  }
+
+  free(lcos);
+  hpx_exit(0, NULL);
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _main, _main_handler);
+
+int main(int argc, char *argv[]) {
+  if (hpx_init(&argc, &argv)) {
+    fprintf(stderr, "HPX: failed to initialize.\n");
+    return EXIT_FAILURE;
+  }
+  bench_init(&argc, &argv);
+
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "n:r:h?")) != -1) {
+    switch (opt) {
+     case 'n':
+      _n = atoi(optarg);
+      break;
+     case 'r':
+      _rounds = atoi(optarg);
+      break;
+     case 'h':
+      _usage(stdout, EXIT_SUCCESS);
+     default:
+      _usage(stderr, EXIT_FAILURE);
+    }
+  }
+
+  int e = hpx_run(&_main, NULL);
+  hpx_finalize();
+  return e;
+}
@@ -16,16 +16,12 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <hpx/hpx.h>
-
-#define BENCHMARK "HPX COST OF LCO Future"
-
-#define HEADER "# " BENCHMARK "\n"
-#define FIELD_WIDTH 10
-#define HEADER_FIELD_WIDTH 5
+#include "bench.h"
 
 static void _usage(FILE *stream) {
   fprintf(stream, "Usage: time_lco_future [options] \n"
           "\t-h, this help display\n");
+  bench_usage(stream);
   hpx_print_help();
   fflush(stream);
 }
@@ -33,6 +29,8 @@ static void _usage(FILE *stream) {
 static hpx_action_t _main = 0;
 static hpx_action_t _set_value = 0;
 static hpx_action_t _get_value = 0;
+static hpx_action_t _get_n = 0;
+static hpx_action_t _wait_one = 0;
 
 #define T int
 
@@ -57,37 +55,47 @@ static int action_set_value(void *args, size_t size) {
   return HPX_SUCCESS;
 }
 
-static int _main_action(void) {
-  hpx_time_t t;
-  int count;
-
-  fprintf(stdout, HEADER);
-  fprintf(stdout, "# Latency in (ms)\n");
+// Read an already-set future @p n times, so that one task per worker hammers
+// the same future concurrently.
+static int action_get_n(hpx_addr_t future, int n) {
+  T v;
+  for (int i = 0; i < n; ++i) {
+    hpx_lco_get(future, sizeof(v), &v);
+  }
+  return HPX_SUCCESS;
+}
 
-  t = hpx_time_now();
-  hpx_addr_t done = hpx_lco_future_new(0);
-  fprintf(stdout, "Creation time: %g\n", hpx_time_elapsed_ms(t));
+// Block on a future that has not been set yet.
+static int action_wait_one(hpx_addr_t future) {
+  return hpx_lco_wait(future);
+}
 
+static int _main_action(void) {
   value = 1234;
 
-  t = hpx_time_now();
-  hpx_call(HPX_HERE, _set_value, done, &value, sizeof(value));
-  fprintf(stdout, "Value set time: %g\n", hpx_time_elapsed_ms(t));
-
-  t = hpx_time_now();
-  hpx_lco_wait(done);
-  fprintf(stdout, "Wait time: %g\n", hpx_time_elapsed_ms(t));
+  BENCH(b, "new", 1) {
+    hpx_addr_t done = hpx_lco_future_new(0);
+    bench_stop(b);
+    hpx_lco_delete_sync(done);
+  }
 
-  t = hpx_time_now();
-  hpx_lco_delete(done, HPX_NULL);
-  fprintf(stdout, "Deletion time: %g\n", hpx_time_elapsed_ms(t));
+  BENCH(b, "set+wait", 1) {
+    hpx_addr_t done = hpx_lco_future_new(0);
+    bench_start(b);
+    hpx_call(HPX_HERE, _set_value, done, &value, sizeof(value));
+    hpx_lco_wait(done);
+    bench_stop(b);
+    hpx_lco_delete_sync(done);
+  }
 
-  fprintf(stdout, "%s\t%*s%*s%*s\n", "# NumReaders " , FIELD_WIDTH,
-         "Get_Value ", FIELD_WIDTH, " LCO_Getall ", FIELD_WIDTH, "Delete");
+  BENCH(b, "delete", 1) {
+    hpx_addr_t done = hpx_lco_future_new(0);
+    bench_start(b);
+    hpx_lco_delete(done, HPX_NULL);
+  }
 
   for (int i = 0; i < sizeof(num_readers)/sizeof(num_readers[0]); i++) {
-    fprintf(stdout, "%d\t\t", num_readers[i]);
-    count = num_readers[i];
+    int count = num_readers[i];
     int values[count];
     void *addrs[count];
     size_t sizes[count];
@@ -96,25 +104,78 @@ static int _main_action(void) {
     for (int j = 0; j < count; j++) {
       addrs[j] = &values[j];
       sizes[j] = sizeof(int);
-      futures[j] = hpx_lco_future_new(sizeof(int));
     }
 
-    t = hpx_time_now();
-    for (int j = 0; j < count; j++) {
-      t = hpx_time_now();
-      hpx_call(HPX_HERE, _get_value, futures[j], NULL, 0);
-      hpx_lco_wait(futures[j]);
+    bench_param("readers", count);
+    BENCH(b, "get", count) {
+      for (int j = 0; j < count; j++) {
+        futures[j] = hpx_lco_future_new(sizeof(int));
+      }
+      bench_start(b);
+      for (int j = 0; j < count; j++) {
+        hpx_call(HPX_HERE, _get_value, futures[j], NULL, 0);
+        hpx_lco_wait(futures[j]);
+      }
+      bench_stop(b);
+      for (int j = 0; j < count; j++) {
+        hpx_lco_delete_sync(futures[j]);
+      }
+    }
+
+    BENCH(b, "get-all", count) {
+      for (int j = 0; j < count; j++) {
+        futures[j] = hpx_lco_future_new(sizeof(int));
+        hpx_call(HPX_HERE, _get_value, futures[j], NULL, 0);
+      }
+      hpx_lco_wait_all(count, futures, NULL);
+      bench_start(b);
+      hpx_lco_get_all(count, futures, sizes, addrs, NULL);
+      bench_stop(b);
+      for (int j = 0; j < count; j++) {
+        hpx_lco_delete_sync(futures[j]);
+      }
     }
-    fprintf(stdout, "%*g", FIELD_WIDTH, hpx_time_elapsed_ms(t));
 
-    t = hpx_time_now();
-    hpx_lco_get_all(count, futures, sizes, addrs, NULL);
-    fprintf(stdout, "%*g", FIELD_WIDTH, hpx_time_elapsed_ms(t));
+    BENCH(b, "delete-all", count) {
+      for (int j = 0; j < count; j++) {
+        futures[j] = hpx_lco_future_new(sizeof(int));
+      }
+      bench_start(b);
+      for (int j = 0; j < count; j++) {
+        hpx_lco_delete(futures[j], HPX_NULL);
+      }
+    }
 
-    t = hpx_time_now();
-    for (int j = 0; j < count; j++)
-      hpx_lco_delete(futures[j], HPX_NULL);
-    fprintf(stdout, "%*g\n", FIELD_WIDTH, hpx_time_elapsed_ms(t));
+    // Time to release many threads blocked on one future
+    BENCH(b, "wake-all", count) {
+      hpx_addr_t future = hpx_lco_future_new(sizeof(T));
+      hpx_addr_t waited = hpx_lco_and_new(count);
+      for (int j = 0; j < count; j++) {
+        hpx_call(HPX_HERE, _wait_one, waited, &future);
+      }
+      bench_start(b);
+      hpx_lco_set(future, sizeof(value), &value, HPX_NULL, HPX_NULL);
+      hpx_lco_wait(waited);
+      bench_stop(b);
+      hpx_lco_delete_sync(waited);
+      hpx_lco_delete_sync(future);
+    }
+
+    // Time for one reader per worker to get the set future concurrently
+    int per = count * 1000 / HPX_THREADS;
+    BENCH(b, "contended-get", per * HPX_THREADS) {
+      hpx_addr_t future = hpx_lco_future_new(sizeof(T));
+      hpx_lco_set(future, sizeof(value), &value, HPX_NULL, HPX_NULL);
+      hpx_addr_t done = hpx_lco_and_new(HPX_THREADS);
+      bench_start(b);
+      for (int j = 0; j < HPX_THREADS; j++) {
+        hpx_call(HPX_HERE, _get_n, done, &future, &per);
+      }
+      hpx_lco_wait(done);
+      bench_stop(b);
+      hpx_lco_delete_sync(done);
+      hpx_lco_delete_sync(future);
+    }
   }
   hpx_exit(0, NULL);
 }
@@ -124,11 +185,14 @@ int main(int argc, char *argv[]) {
   HPX_REGISTER_ACTION(HPX_DEFAULT, 0, _main, _main_action);
   HPX_REGISTER_ACTION(HPX_DEFAULT, HPX_MARSHALLED, _set_value, action_set_value, HPX_POINTER, HPX_SIZE_T);
   HPX_REGISTER_ACTION(HPX_DEFAULT, 0, _get_value, action_get_value);
+  HPX_REGISTER_ACTION(HPX_DEFAULT, 0, _get_n, action_get_n, HPX_ADDR, HPX_INT);
+  HPX_REGISTER_ACTION(HPX_DEFAULT, 0, _wait_one, action_wait_one, HPX_ADDR);
 
   if (hpx_init(&argc, &argv)) {
     fprintf(stderr, "HPX: failed to initialize.\n");
     return 1;
   }
+  bench_init(&argc, &argv);
 
   int opt = 0;
   while ((opt = getopt(argc, argv, "h?")) != -1) {
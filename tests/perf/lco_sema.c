@@ -18,12 +18,7 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <hpx/hpx.h>
-
-#define BENCHMARK "HPX COST OF LCO SEMAPHORES"
-
-#define HEADER "# " BENCHMARK "\n"
-#define FIELD_WIDTH 10
-#define HEADER_FIELD_WIDTH 5
+#include "bench.h"
 
 static int num[] = {
   100000,
@@ -37,7 +32,6 @@ static int _thread1_handler(uint32_t iter, hpx_addr_t sem1, hpx_addr_t sem2) {
   assert(sem1 != sem2);
   assert(sem1 != hpx_thread_current_cont_target());
   assert(sem2 != hpx_thread_current_cont_target());
-  hpx_time_t t = hpx_time_now();
   hpx_addr_t and = hpx_lco_and_new(iter);
   for (int j = 0; j < iter; j++) {
     hpx_lco_sema_p(sem1);
@@ -45,7 +39,6 @@ static int _thread1_handler(uint32_t iter, hpx_addr_t sem1, hpx_addr_t sem2) {
   }
   hpx_lco_wait(and);
   hpx_lco_delete(and, HPX_NULL);
-  printf("Thread 1: %d%*g\n", iter, FIELD_WIDTH, hpx_time_elapsed_ms(t));
   return HPX_SUCCESS;
 }
 
@@ -56,8 +49,6 @@ static int _thread2_handler(uint32_t iter, hpx_addr_t sem1, hpx_addr_t sem2) {
   assert(sem1 != sem2);
   assert(sem1 != hpx_thread_current_cont_target());
   assert(sem2 != hpx_thread_current_cont_target());
-
-  hpx_time_t t = hpx_time_now();
   hpx_addr_t and = hpx_lco_and_new(iter);
   for (int j = 0; j < iter; j++) {
     hpx_lco_sema_p(sem2);
@@ -65,57 +56,102 @@ static int _thread2_handler(uint32_t iter, hpx_addr_t sem1, hpx_addr_t sem2) {
   }
   hpx_lco_wait(and);
   hpx_lco_delete(and, HPX_NULL);
-  printf("Thread 2: %d%*g\n", iter, FIELD_WIDTH, hpx_time_elapsed_ms(t));
   return HPX_SUCCESS;
 }
 
 static HPX_ACTION(HPX_DEFAULT, 0, _thread2, _thread2_handler, HPX_UINT32, HPX_ADDR,
                   HPX_ADDR);
 
-static int _main_handler(void) {
-  printf(HEADER);
-  printf("Semaphore non contention performance\n");
-  printf("%s%*s%*s\n", "# Iters " , FIELD_WIDTH, "Init time ", FIELD_WIDTH,
-         " latency (ms)");
+/// The number of contending threads per worker, and the acquires per thread,
+/// for the tail latency test.
+static const int CONTENDERS = 4;
+static const int ACQUIRES = 10000;
+
+/// Acquire and release a mutex repeatedly, recording each acquire's latency
+/// in microseconds.
+static int _contender_handler(hpx_addr_t mutex, double *latencies) {
+  for (int j = 0; j < ACQUIRES; ++j) {
+    hpx_time_t t = hpx_time_now();
+    hpx_lco_sema_p(mutex);
+    latencies[j] = hpx_time_elapsed_us(t);
+    hpx_lco_sema_v_sync(mutex);
+  }
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _contender, _contender_handler, HPX_ADDR,
+                  HPX_POINTER);
+
+static void _tail_latency(void) {
+  int n = CONTENDERS * HPX_THREADS;
+  size_t total = (size_t)n * ACQUIRES;
+  double *latencies = malloc(total * sizeof(*latencies));
+  hpx_addr_t mutex = hpx_lco_sema_new(1);
+  hpx_addr_t and = hpx_lco_and_new(n);
+  for (int i = 0; i < n; ++i) {
+    double *mine = latencies + (size_t)i * ACQUIRES;
+    hpx_call(HPX_HERE, _contender, and, &mutex, &mine);
+  }
+  hpx_lco_wait(and);
+  hpx_lco_delete(and, HPX_NULL);
+  hpx_lco_delete(mutex, HPX_NULL);
 
-  hpx_time_t t;
+  bench_param("contenders", n);
+  bench_record("acquire", latencies, total);
+  free(latencies);
+}
+
+static int _main_handler(void) {
   for (int i = 0, e = sizeof(num)/sizeof(num[0]); i < e; ++i) {
     const int n = num[i];
-    printf("%d", n);
-    t = hpx_time_now();
-    hpx_addr_t mutex = hpx_lco_sema_new(n);
-    printf("%*g", FIELD_WIDTH, hpx_time_elapsed_ms(t));
-    t = hpx_time_now();
-    hpx_addr_t and = hpx_lco_and_new(n);
-    for (int j = 0, e = n; j < e; ++j) {
-      hpx_lco_sema_p(mutex);
-      hpx_lco_sema_v(mutex, and);
+    bench_param("n", n);
+
+    BENCH(b, "new", 1) {
+      hpx_addr_t mutex = hpx_lco_sema_new(n);
+      bench_stop(b);
+      hpx_lco_delete_sync(mutex);
+    }
+
+    BENCH(b, "p+v", n) {
+      hpx_addr_t mutex = hpx_lco_sema_new(n);
+      bench_start(b);
+      hpx_addr_t and = hpx_lco_and_new(n);
+      for (int j = 0, e = n; j < e; ++j) {
+        hpx_lco_sema_p(mutex);
+        hpx_lco_sema_v(mutex, and);
+      }
+      hpx_lco_wait(and);
+      bench_stop(b);
+      hpx_lco_delete_sync(and);
+      hpx_lco_delete_sync(mutex);
     }
-    hpx_lco_wait(and);
-    hpx_lco_delete(and, HPX_NULL);
-    hpx_lco_delete(mutex, HPX_NULL);
-    printf("%*g\n", FIELD_WIDTH,  hpx_time_elapsed_ms(t));
   }
 
-  printf("\nSemaphore contention performance\n");
-  printf("%s%s%*s\n", "# Thread ID ", "Iters " , FIELD_WIDTH, "latency (ms)");
   // Semaphore contention test
   for (int i = 0, e = sizeof(num)/sizeof(num[0]); i < e; ++i) {
     int value = num[i];
-
-    hpx_addr_t s1 = hpx_lco_sema_new(value);
-    hpx_addr_t s2 = hpx_lco_sema_new(value);
-
-    hpx_addr_t and = hpx_lco_and_new(2);
-    hpx_call(HPX_HERE, _thread1, and, &value, &s1, &s2);
-    hpx_call(HPX_HERE, _thread2, and, &value, &s1, &s2);
-    hpx_lco_wait(and);
-
-    hpx_lco_delete(and, HPX_NULL);
-    hpx_lco_delete(s2, HPX_NULL);
-    hpx_lco_delete(s1, HPX_NULL);
+    bench_param("n", value);
+
+    BENCH(b, "contended-p+v", 2.0 * value) {
+      hpx_addr_t s1 = hpx_lco_sema_new(value);
+      hpx_addr_t s2 = hpx_lco_sema_new(value);
+      bench_start(b);
+
+      hpx_addr_t and = hpx_lco_and_new(2);
+      hpx_call(HPX_HERE, _thread1, and, &value, &s1, &s2);
+      hpx_call(HPX_HERE, _thread2, and, &value, &s1, &s2);
+      hpx_lco_wait(and);
+      bench_stop(b);
+
+      hpx_lco_delete_sync(and);
+      hpx_lco_delete_sync(s2);
+      hpx_lco_delete_sync(s1);
+    }
   }
 
+  // The distribution of single acquires, rather than of repetitions
+  bench_param("n", ACQUIRES);
+  _tail_latency();
+
   hpx_exit(0, NULL);
 }
 static HPX_ACTION(HPX_DEFAULT, 0, _main, _main_handler);
@@ -125,6 +161,7 @@ int main(int argc, char *argv[]) {
     fprintf(stderr, "HPX: failed to initialize.\n");
     return 1;
   }
+  bench_init(&argc, &argv);
 
   // run the main action
   int e = hpx_run(&_main, NULL);
@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <hpx/hpx.h>
+#include "bench.h"
 
 #define MAX_BYTES        (1024*1024*1024*1UL)
 #define SKIP_LARGE       10
@@ -24,15 +25,14 @@
 int skip = 1000;
 int loop = 10000;
 
-#define BENCHMARK "HPX COST OF MEMORY ALLOCATIONS (ms)"
+static size_t _max_bytes = MAX_BYTES;
 
-#define HEADER "# " BENCHMARK "\n"
-#define FIELD_WIDTH 10
-#define HEADER_FIELD_WIDTH 5
 /// This file tests cost of memory allocation operations
 static void usage(FILE *stream) {
   fprintf(stream, "Usage: mem_alloc [options]\n"
+          "\t-m, largest allocation in bytes (default 1GB)\n"
           "\t-h, this help display\n");
+  bench_usage(stream);
   hpx_print_help();
   fflush(stream);
 }
@@ -41,36 +41,33 @@ static hpx_action_t _main    = 0;
 
 static int _main_action(void) {
   void *local;
-  hpx_time_t t;
-  int size = HPX_LOCALITIES;
-  int ranks = hpx_get_num_ranks();
-  uint32_t blocks = size;
-
-  fprintf(stdout, HEADER);
-  fprintf(stdout, "localities: %d, ranks and blocks per rank = %d, %d\n",
-                  size, ranks, blocks/ranks);
-
-  fprintf(stdout, "%s\t\t%*s%*s%*s%*s\n", "# Size ", HEADER_FIELD_WIDTH,
-      " MALLOC ", HEADER_FIELD_WIDTH, " FREE ", HEADER_FIELD_WIDTH,
-      " MALLOC_REG ", HEADER_FIELD_WIDTH, " FREE ");
-
-  for (size_t size = 1; size <= MAX_BYTES; size*=2) {
-    t = hpx_time_now();
-    local = malloc(size);
-    fprintf(stdout, "%-*zu%*g", 10,  size, FIELD_WIDTH, hpx_time_elapsed_ms(t));
-
-    t = hpx_time_now();
-    free(local);
-    fprintf(stdout, "%*g", FIELD_WIDTH, hpx_time_elapsed_ms(t));
-
-    t = hpx_time_now();
-    local = hpx_malloc_registered(size);
-    fprintf(stdout, "%*g", FIELD_WIDTH, hpx_time_elapsed_ms(t));
-
-    t = hpx_time_now();
-    hpx_free_registered(local);
-    fprintf(stdout, "%*g", FIELD_WIDTH, hpx_time_elapsed_ms(t));
-    fprintf(stdout, "\n");
+
+  for (size_t size = 1; size <= _max_bytes; size*=2) {
+    bench_param("size", size);
+
+    BENCH(b, "malloc", 1) {
+      local = malloc(size);
+      bench_stop(b);
+      free(local);
+    }
+
+    BENCH(b, "free", 1) {
+      local = malloc(size);
+      bench_start(b);
+      free(local);
+    }
+
+    BENCH(b, "malloc_registered", 1) {
+      local = hpx_malloc_registered(size);
+      bench_stop(b);
+      hpx_free_registered(local);
+    }
+
+    BENCH(b, "free_registered", 1) {
+      local = hpx_malloc_registered(size);
+      bench_start(b);
+      hpx_free_registered(local);
+    }
   }
   hpx_exit(0, NULL);
 }
@@ -83,10 +80,14 @@ int main(int argc, char *argv[]) {
     fprintf(stderr, "HPX: failed to initialize.\n");
     return 1;
   }
+  bench_init(&argc, &argv);
 
   int opt = 0;
-  while ((opt = getopt(argc, argv, "h?")) != -1) {
+  while ((opt = getopt(argc, argv, "m:h?")) != -1) {
     switch (opt) {
+     case 'm':
+      _max_bytes = strtoul(optarg, NULL, 0);
+      break;
      case 'h':
       usage(stdout);
       return 0;
@@ -97,8 +98,6 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  fprintf(stdout, "Starting the cost of Memory Allocation benchmark\n");
-
   // run the main action
   int e = hpx_run(&_main, NULL);
   hpx_finalize();
@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <inttypes.h>
 #include "hpx/hpx.h"
+#include "bench.h"
 
 /// This is a microbenchmark to determine the effectiveness of parallel
 /// execution of tasks.
@@ -40,6 +41,11 @@
 /// task DAG always forms an n-ary tree with depth 1. The parallel
 /// efficiency of the generated DAG is 1.0 where T_{1} = T_{n} =
 /// T_{\inf}.
+///
+/// The -a option binds a dummy block to worker 0 before timing. With an
+/// affinity policy enabled (e.g., --hpx-gas-affinity=cuckoo) this forces every
+/// spawn through the affinity lookup, which shows the cost that the scheduler
+/// avoids when no affinity has been set. Use a small -w to isolate it.
 
 
 int fwq(int work) {
@@ -74,64 +80,74 @@ int _fwq_parfor(const int idx, void *work) {
 }
 
 static void _usage(FILE *f, int error) {
-  fprintf(f, "Usage: parbench -i iters -w work -n tasks\n"
+  fprintf(f, "Usage: parbench -i iters -w work -n tasks [-a]\n"
              "\t -i iters: number of iterations\n"
              "\t -w  work: work per task per iteration\n"
              "\t -n tasks: number of parallel tasks per iteration\n"
+             "\t -a      : set an affinity binding before timing\n"
              "\t -h      : show help\n");
+  bench_usage(f);
   hpx_print_help();
   fflush(f);
   exit(error);
 }
 
 static HPX_ACTION_DECL(_main);
-static int _main_action(int iters, int work, int ntasks) {
+static int _main_action(int iters, int work, int ntasks, int affinity) {
   if (ntasks == 0) {
     ntasks = HPX_THREADS;
   }
 
-  printf("parbench(iters=%d, work=%d, ntasks=%d)\n", iters, work, ntasks);
-  printf("time resolution: microseconds\n");
-  fflush(stdout);
+  hpx_addr_t bound = HPX_NULL;
+  if (affinity) {
+    bound = hpx_gas_alloc_local(1, sizeof(int), 0);
+    hpx_gas_set_affinity(bound, 0);
+  }
+
+  bench_param("iters", iters);
+  bench_param("work", work);
+  bench_param("ntasks", ntasks);
+  bench_param("affinity", affinity);
+
+  BENCH(b, "seq-for", iters) {
+    for (int i = 0; i < iters; ++i) {
+      fwq(work);
+    }
+  }
 
-  hpx_time_t start = hpx_time_now();
-  for (int i = 0; i < iters; ++i) {
-    fwq(work);
+  BENCH(b, "for+hpx_call_async", iters) {
+    for (int i = 0; i < iters; ++i) {
+      hpx_addr_t done = hpx_lco_and_new(ntasks);
+      for (int j = 0; j < ntasks; ++j) {
+        hpx_call_async(HPX_HERE, _fwq, HPX_NULL, done, &work, sizeof(work));
+      }
+      hpx_lco_wait(done);
+      hpx_lco_delete(done, HPX_NULL);
+    }
   }
-  double elapsed = hpx_time_elapsed_us(start);
-  printf("seq-for: %.7f\n", elapsed/iters);
-  printf("perfect-for: %.7f\n", (ntasks*elapsed)/(iters*HPX_THREADS));
-
-  start = hpx_time_now();
-  for (int i = 0; i < iters; ++i) {
-    hpx_addr_t done = hpx_lco_and_new(ntasks);
-    for (int j = 0; j < ntasks; ++j) {
-      hpx_call_async(HPX_HERE, _fwq, HPX_NULL, done, &work, sizeof(work));
+
+  BENCH(b, "hpx_par_for_sync", iters) {
+    for (int i = 0; i < iters; ++i) {
+      hpx_par_for_sync(_fwq_parfor, 0, ntasks, &work);
     }
-    hpx_lco_wait(done);
-    hpx_lco_delete(done, HPX_NULL);
   }
-  elapsed = hpx_time_elapsed_us(start);
-  printf("for+hpx_call_async: %.7f\n", elapsed/iters);
 
-  start = hpx_time_now();
-  for (int i = 0; i < iters; ++i) {
-    hpx_par_for_sync(_fwq_parfor, 0, ntasks, &work);
+  BENCH(b, "hpx_par_call_sync", iters) {
+    for (int i = 0; i < iters; ++i) {
+      hpx_par_call_sync(_fwq, 0, ntasks, ntasks, 1, sizeof(work),
+                        env_to_args, sizeof(work), &work);
+    }
   }
-  elapsed = hpx_time_elapsed_us(start);
-  printf("hpx_par_for_sync: %.7f\n", elapsed/iters);
 
-  start = hpx_time_now();
-  for (int i = 0; i < iters; ++i) {
-    hpx_par_call_sync(_fwq, 0, ntasks, ntasks, 1, sizeof(work),
-                      env_to_args, sizeof(work), &work);
+  if (affinity) {
+    hpx_gas_clear_affinity(bound);
+    hpx_gas_free_sync(bound);
   }
-  elapsed = hpx_time_elapsed_us(start);
-  printf("hpx_par_call_sync: %.7f\n", elapsed/iters);
 
   hpx_exit(0, NULL);
 }
-static HPX_ACTION(HPX_DEFAULT, 0, _main, _main_action, HPX_INT, HPX_INT, HPX_INT);
+static HPX_ACTION(HPX_DEFAULT, 0, _main, _main_action, HPX_INT, HPX_INT, HPX_INT,
+                  HPX_INT);
 
 int main(int argc, char *argv[]) {
   int e = hpx_init(&argc, &argv);
@@ -139,12 +155,14 @@ int main(int argc, char *argv[]) {
     fprintf(stderr, "HPX: failed to initialize.\n");
     return e;
   }
+  bench_init(&argc, &argv);
 
   int iters = 5;
   int work = 5555;
   int ntasks = 0;
+  int affinity = 0;
   int opt = 0;
-  while ((opt = getopt(argc, argv, "i:w:n:h?")) != -1) {
+  while ((opt = getopt(argc, argv, "i:w:n:ah?")) != -1) {
     switch (opt) {
      case 'i':
        iters = atoi(optarg);
@@ -155,6 +173,9 @@ int main(int argc, char *argv[]) {
       case 'n':
        ntasks = atoi(optarg);
        break;
+     case 'a':
+       affinity = 1;
+       break;
      case 'h':
        _usage(stdout, EXIT_SUCCESS);
      default:
@@ -165,7 +186,7 @@ int main(int argc, char *argv[]) {
   argc -= optind;
   argv += optind;
 
-  e = hpx_run(&_main, NULL, &iters, &work, &ntasks);
+  e = hpx_run(&_main, NULL, &iters, &work, &ntasks, &affinity);
   hpx_finalize();
   return e;
 }
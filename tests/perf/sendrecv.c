@@ -17,6 +17,7 @@
 #include <stdlib.h>
 #include <sys/time.h>
 #include "hpx/hpx.h"
+#include "bench.h"
 
 static int counts[24] = {
   1,
@@ -54,10 +55,9 @@ static HPX_ACTION(HPX_DEFAULT, HPX_MARSHALLED, _recv, _recv_handler,
 static int _main_action(int levels, int work) {
   int avg = 10000;
 
-  printf("Running sendrecv on %d levels with %d work\n", levels, work);
-
-  hpx_time_t tick = hpx_time_now();
-  printf(" Tick: %g\n", hpx_time_us(tick));
+  // Send to the next locality, which is ourself when running on one.
+  hpx_addr_t there = HPX_THERE((HPX_LOCALITY_ID + 1) % HPX_LOCALITIES);
+  bench_param("work", work);
 
   for (int i = 0, e = levels; i < e; ++i) {
     size_t bytes = sizeof(double) * counts[i];
@@ -66,27 +66,24 @@ static int _main_action(int levels, int work) {
       buf[j] = j * rand();
     }
 
-    printf("%d, %d: ", i, counts[i]);
-    hpx_time_t t1 = hpx_time_now();
-
-    // for completing the entire loop
-    hpx_addr_t done = hpx_lco_and_new(avg);
+    bench_param("size", bytes);
+    BENCH(b, "send", avg) {
+      // for completing the entire loop
+      hpx_addr_t done = hpx_lco_and_new(avg);
 
-    for (int j = 0, e = avg; j < e; ++j) {
-      hpx_call_async(HPX_HERE, _recv, done, HPX_NULL, buf, bytes);
+      for (int j = 0, e = avg; j < e; ++j) {
+        hpx_call_async(there, _recv, done, HPX_NULL, buf, bytes);
 
-      // do the useless work
-      double volatile d = 0.0;
-      for (int k = 0, e = work; k < e; ++k) {
-        d += 1.0 / (2.0 * k + 1.0);
+        // do the useless work
+        double volatile d = 0.0;
+        for (int k = 0, e = work; k < e; ++k) {
+          d += 1.0 / (2.0 * k + 1.0);
+        }
       }
-    }
 
-    hpx_lco_wait(done);
-    hpx_lco_delete(done, HPX_NULL);
-
-    double elapsed = hpx_time_elapsed_ms(t1);
-    printf("Elapsed: %g\n", elapsed/avg);
+      hpx_lco_wait(done);
+      hpx_lco_delete(done, HPX_NULL);
+    }
     free(buf);
   }
 
@@ -99,6 +96,7 @@ _usage(FILE *f) {
   fprintf(f, "Usage: sendrecv [options] [LEVELS < 24]\n"
           "\t-w, amount of work\n"
           "\t-h, show help\n");
+  bench_usage(f);
   hpx_print_help();
   fflush(f);
 }
@@ -109,6 +107,7 @@ int main(int argc, char *argv[argc]) {
     fprintf(stderr, "HPX failed to initialize.\n");
     return -1;
   }
+  bench_init(&argc, &argv);
 
   int levels = 24;
   int work = 10000;
@@ -16,11 +16,13 @@
 #include <stdlib.h>
 #include <inttypes.h>
 #include "hpx/hpx.h"
+#include "bench.h"
 
 
 static void _usage(FILE *f, int error) {
   fprintf(f, "Usage: cswitch [options] NUMBER\n"
           "\t-h, show help\n");
+  bench_usage(f);
   hpx_print_help();
   fflush(f);
   exit(error);
@@ -52,23 +54,23 @@ static int _getter_action(int n, hpx_addr_t f1, hpx_addr_t f2) {
 
 static int _cswitch_main_action(int *args, size_t size) {
   int n = *args;
-  printf("cswitch(%d)\n", n); fflush(stdout);
-  hpx_addr_t and = hpx_lco_and_new(2);
   hpx_addr_t f1 = hpx_lco_future_new(0);
   hpx_addr_t f2 = hpx_lco_future_new(0);
 
-  hpx_time_t now = hpx_time_now();
-  hpx_call(HPX_HERE, _setter, and, &n, &f1, &f2);
-  hpx_call(HPX_HERE, _getter, and, &n, &f1, &f2);
-  hpx_lco_wait(and);
-  double elapsed = hpx_time_elapsed_ms(now)/1e3;
-  hpx_lco_delete(and, HPX_NULL);
+  // Each round trip is two context switches.
+  bench_param("n", n);
+  BENCH(b, "switch", 2.0 * n) {
+    hpx_addr_t and = hpx_lco_and_new(2);
+    bench_start(b);
+    hpx_call(HPX_HERE, _setter, and, &n, &f1, &f2);
+    hpx_call(HPX_HERE, _getter, and, &n, &f1, &f2);
+    hpx_lco_wait(and);
+    bench_stop(b);
+    hpx_lco_delete_sync(and);
+  }
+
   hpx_lco_delete(f1, HPX_NULL);
   hpx_lco_delete(f2, HPX_NULL);
-
-  printf("seconds: %.7f\n", elapsed);
-  printf("localities: %d\n", HPX_LOCALITIES);
-  printf("threads/locality: %d\n", HPX_THREADS);
   hpx_exit(0, NULL);
 }
 
@@ -86,6 +88,7 @@ int main(int argc, char *argv[]) {
     fprintf(stderr, "HPX: failed to initialize.\n");
     return e;
   }
+  bench_init(&argc, &argv);
 
   // parse the command line
   int opt = 0;
@@ -11,7 +11,7 @@
 //  Extreme Scale Technologies (CREST).
 // =============================================================================
 
-/// Testing the hpx_gas_{set,clear}_affinity functionality doesn't really make
+/// Testing the hpx_gas_{set,clear}_affinity{,_range} functionality doesn't really make
 /// very much sense, in that the call makes no guarantees about behavior. A
 /// no-op is a valid implementation for these functions.
 
@@ -42,6 +42,31 @@ static int _test_handler(void) {
 }
 static HPX_ACTION(HPX_DEFAULT, HPX_ATTR_NONE, _test, _test_handler);
 
+static int _test_range_handler(void) {
+  int n = 4 * hpx_get_num_threads();
+  hpx_addr_t base = hpx_gas_alloc_local(n, 8, 0);
+
+  hpx_gas_set_affinity_range(base, n, 8, HPX_AFFINITY_CYCLIC);
+  for (int i = 0; i < n; ++i) {
+    hpx_addr_t block = hpx_addr_add(base, i * 8, 8);
+    int expected = i % hpx_get_num_threads();
+    CHECK( hpx_call_sync(block, _op, NULL, 0, &expected) );
+  }
+
+  hpx_gas_set_affinity_range(base, n, 8, HPX_AFFINITY_BLOCKED);
+  for (int i = 0; i < n; ++i) {
+    hpx_addr_t block = hpx_addr_add(base, i * 8, 8);
+    int expected = i / 4;
+    CHECK( hpx_call_sync(block, _op, NULL, 0, &expected) );
+  }
+  hpx_gas_clear_affinity_range(base);
+
+  hpx_gas_free_sync(base);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, HPX_ATTR_NONE, _test_range, _test_range_handler);
+
 TEST_MAIN({
     ADD_TEST(_test, 0);
+    ADD_TEST(_test_range, 0);
   });
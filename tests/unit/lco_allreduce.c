@@ -114,6 +114,29 @@ _join_sync_leaf_handler(hpx_addr_t allreduce, int i, int j, hpx_addr_t sum) {
 static HPX_ACTION(HPX_DEFAULT, 0, _join_sync_leaf, _join_sync_leaf_handler,
                   HPX_ADDR, HPX_INT, HPX_INT, HPX_ADDR);
 
+/// Join a persistent allreduce for I back-to-back epochs.
+///
+/// Each epoch adds the epoch number to the input, and the result is checked
+/// both as a copy and through the zero-copy reference.
+static int
+_persistent_leaf_handler(hpx_addr_t allreduce, int i, int j, hpx_addr_t sum) {
+  int n = HPX_LOCALITIES * N;
+  int r = 0;
+  for (int e = 0; e < I; ++e) {
+    int k = j + e;
+    CHECK( hpx_lco_allreduce_join_sync(allreduce, i, sizeof(k), &k, &r) );
+    test_assert(r == HPX_LOCALITIES * N * (N + 1) / 2 + n * e);
+
+    int *ref = NULL;
+    CHECK( hpx_lco_getref(allreduce, sizeof(*ref), (void**)&ref) );
+    test_assert(*ref == r);
+    hpx_lco_release(allreduce, ref);
+  }
+  return hpx_call_cc(sum, hpx_lco_set_action, &r, sizeof(r));
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _persistent_leaf, _persistent_leaf_handler,
+                  HPX_ADDR, HPX_INT, HPX_INT, HPX_ADDR);
+
 /// Spawn the set-get test.
 static int _test_allreduce_set_get_handler(void) {
   return _test(_set_get_leaf);
@@ -142,9 +165,29 @@ static int _test_allreduce_join_sync_handler(void) {
 static HPX_ACTION(HPX_DEFAULT, 0, _test_allreduce_join_sync,
                   _test_allreduce_join_sync_handler);
 
+/// Spawn the persistent test, where the leaves run all of the epochs.
+static int _test_allreduce_persistent_handler(void) {
+  int L = HPX_LOCALITIES;
+  int n = N * L;
+  hpx_addr_t allreduce = hpx_lco_allreduce_persistent_new(n, sizeof(int),
+                                                          _sum);
+  hpx_addr_t sum = hpx_lco_reduce_new(n, sizeof(int), _init, _sum);
+  hpx_action_t leaf = _persistent_leaf;
+  CHECK( hpx_bcast(_test_bcast, HPX_NULL, HPX_NULL, &allreduce, &sum, &leaf) );
+  int r;
+  CHECK( hpx_lco_get(sum, sizeof(r), &r) );
+  test_assert(r == n * (L * N * (N + 1) / 2 + n * (I - 1)));
+  hpx_lco_delete(sum, HPX_NULL);
+  hpx_lco_delete(allreduce, HPX_NULL);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _test_allreduce_persistent,
+                  _test_allreduce_persistent_handler);
+
 TEST_MAIN({
     ADD_TEST(_test_allreduce_set_get, 0);
     ADD_TEST(_test_allreduce_join_async, 0);
     ADD_TEST(_test_allreduce_join_sync, 0);
     ADD_TEST(_test_allreduce_join, 0);
+    ADD_TEST(_test_allreduce_persistent, 0);
   });
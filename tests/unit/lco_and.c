@@ -50,7 +50,22 @@ static int lco_and_num_handler(void) {
 }
 static HPX_ACTION(HPX_DEFAULT, 0, lco_and_num, lco_and_num_handler);
 
+static int lco_and_tree_handler(void) {
+  printf("Test hpx_lco_and_tree_new\n");
+  int n = 4 * HPX_LOCALITIES;
+  hpx_addr_t lco = hpx_lco_and_tree_new(n + 4, 2);
+  for (int i = 0; i < n; ++i) {
+    hpx_call(HPX_THERE(i % HPX_LOCALITIES), _and_set, lco);
+  }
+  hpx_call(HPX_THERE(HPX_LOCALITIES - 1), _and_set_num, HPX_NULL, &lco);
+  hpx_lco_wait(lco);
+  hpx_lco_delete_sync(lco);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_and_tree, lco_and_tree_handler);
+
 TEST_MAIN({
  ADD_TEST(lco_and, 0);
  ADD_TEST(lco_and_num, 0);
+ ADD_TEST(lco_and_tree, 0);
 });
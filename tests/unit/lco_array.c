@@ -65,6 +65,39 @@ static int lco_future_array_handler(void) {
 }
 static HPX_ACTION(HPX_DEFAULT, 0, lco_future_array, lco_future_array_handler);
 
+// The same as above, for a sharded array with each of the placement policies.
+static int lco_future_sharded_array_handler(void) {
+  printf("Starting the sharded array of futures test\n");
+  hpx_affinity_policy_t policies[] = {
+    HPX_AFFINITY_CYCLIC,
+    HPX_AFFINITY_BLOCKED,
+    HPX_AFFINITY_NUMA
+  };
+
+  for (int p = 0; p < 3; ++p) {
+    hpx_addr_t base = hpx_lco_future_sharded_array_new(ARRAY_SIZE,
+                                                       sizeof(uint64_t),
+                                                       policies[p]);
+    for (int i = 0; i < ARRAY_SIZE; i++) {
+      uint64_t value = i + p;
+      hpx_addr_t other = hpx_lco_sharded_array_at(base, i, sizeof(uint64_t));
+      hpx_call_sync(other, _set_future_value, NULL, 0, &value, sizeof(value));
+
+      uint64_t result;
+      CHECK( hpx_lco_get(other, sizeof(result), &result) );
+      test_assert(result == value);
+    }
+
+    hpx_addr_t sync = hpx_lco_future_new(0);
+    hpx_lco_sharded_array_delete(base, ARRAY_SIZE, sizeof(uint64_t), sync);
+    CHECK( hpx_lco_wait(sync) );
+    hpx_lco_delete(sync, HPX_NULL);
+  }
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_future_sharded_array,
+                  lco_future_sharded_array_handler);
+
 static int _set_handler(void) {
   return HPX_SUCCESS;
 }
@@ -140,6 +173,7 @@ static HPX_ACTION(HPX_DEFAULT, 0, lco_reduce_array, lco_reduce_array_handler);
 
 TEST_MAIN({
  ADD_TEST(lco_future_array, 0);
+ ADD_TEST(lco_future_sharded_array, 0);
  ADD_TEST(lco_and_array, 0);
  ADD_TEST(lco_reduce_array, 0);
 });
@@ -171,7 +171,53 @@ static int lco_alltoall_handler(void) {
 }
 static HPX_ACTION(HPX_DEFAULT, 0, lco_alltoall, lco_alltoall_handler);
 
+/// Run one participant of the pairwise alltoall for @p cycles epochs.
+///
+/// Element j of participant i's row in epoch c is i * n + j + c, so the row
+/// that participant i gets back has k * n + i + c in column k.
+static int _pairwise_participant_handler(hpx_addr_t alltoall, int id, int n,
+                                         int cycles) {
+  int row[n];
+  int out[n];
+  for (int c = 0; c < cycles; ++c) {
+    for (int j = 0; j < n; ++j) {
+      row[j] = id * n + j + c;
+    }
+    CHECK( hpx_lco_alltoall_pairwise_setid(alltoall, id, sizeof(row), row,
+                                           HPX_NULL, HPX_NULL) );
+    CHECK( hpx_lco_alltoall_pairwise_getid(alltoall, id, sizeof(out), out) );
+    for (int k = 0; k < n; ++k) {
+      test_assert(out[k] == k * n + id + c);
+    }
+  }
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _pairwise_participant,
+                  _pairwise_participant_handler, HPX_ADDR, HPX_INT, HPX_INT,
+                  HPX_INT);
+
+static int lco_alltoall_pairwise_handler(void) {
+  int n = 16;
+  int cycles = 100;
+
+  hpx_addr_t alltoall = hpx_lco_alltoall_pairwise_new(n, n * sizeof(int));
+  hpx_addr_t done = hpx_lco_and_new(n);
+  for (int i = 0; i < n; ++i) {
+    hpx_addr_t where = HPX_THERE(i % HPX_LOCALITIES);
+    CHECK( hpx_call(where, _pairwise_participant, done, &alltoall, &i, &n,
+                    &cycles) );
+  }
+
+  CHECK( hpx_lco_wait(done) );
+  hpx_lco_delete(done, HPX_NULL);
+  hpx_lco_delete(alltoall, HPX_NULL);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_alltoall_pairwise,
+                  lco_alltoall_pairwise_handler);
+
 TEST_MAIN({
   ADD_TEST(lco_gather, 0);
   ADD_TEST(lco_alltoall, 0);
+  ADD_TEST(lco_alltoall_pairwise, 0);
 });
@@ -0,0 +1,94 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#include "hpx/hpx.h"
+#include "tests.h"
+
+#define THREADS 16
+
+static int _sinks[THREADS];
+
+static int _source_handler(int *inputs[], int n) {
+  int out = 3;
+  return hpx_thread_continue(&out, sizeof(out));
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _source, _source_handler, HPX_POINTER,
+                  HPX_INT);
+
+static int _twice_handler(int *inputs[], int n) {
+  test_assert(n == 1);
+  int out = 2 * *inputs[0];
+  return hpx_thread_continue(&out, sizeof(out));
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _twice, _twice_handler, HPX_POINTER,
+                  HPX_INT);
+
+static int _sum_handler(int *inputs[], int n) {
+  int out = 0;
+  for (int i = 0; i < n; ++i) {
+    out += *inputs[i];
+  }
+  return hpx_thread_continue(&out, sizeof(out));
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _sum, _sum_handler, HPX_POINTER, HPX_INT);
+
+// Every thread adds a consumer of the shared source, and a sink of both.
+static int _add_handler(hpx_addr_t graph, int source, int i) {
+  int consumer = hpx_lco_dataflow_task(graph, _twice, sizeof(int), 1, &source,
+                                       HPX_NULL);
+  test_assert(consumer >= 0);
+  int inputs[] = { source, consumer };
+  int sink = hpx_lco_dataflow_task(graph, _sum, sizeof(int), 2, inputs,
+                                   HPX_NULL);
+  test_assert(sink >= 0);
+  _sinks[i] = sink;
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _add, _add_handler, HPX_ADDR, HPX_INT,
+                  HPX_INT);
+
+static int lco_dataflow_concurrent_handler(void) {
+  printf("Test hpx_lco_dataflow_task from concurrent threads\n");
+  hpx_addr_t graph = hpx_lco_dataflow_new();
+  int source = hpx_lco_dataflow_task(graph, _source, sizeof(int), 0, NULL,
+                                     HPX_NULL);
+  test_assert(source >= 0);
+
+  hpx_addr_t done = hpx_lco_and_new(THREADS);
+  for (int i = 0; i < THREADS; ++i) {
+    hpx_call(HPX_HERE, _add, done, &graph, &source, &i);
+  }
+  hpx_lco_wait(done);
+  hpx_lco_delete_sync(done);
+
+  // Run the graph twice, to check that it's rearmed.
+  for (int r = 0; r < 2; ++r) {
+    CHECK( hpx_lco_dataflow_run(graph) );
+    CHECK( hpx_lco_wait(graph) );
+    for (int i = 0; i < THREADS; ++i) {
+      int out = 0;
+      CHECK( hpx_lco_dataflow_get_output(graph, _sinks[i], sizeof(out),
+                                         &out) );
+      test_assert(out == 9);
+    }
+  }
+
+  hpx_lco_delete_sync(graph);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_dataflow_concurrent,
+                  lco_dataflow_concurrent_handler);
+
+TEST_MAIN({
+ ADD_TEST(lco_dataflow_concurrent, 0);
+});
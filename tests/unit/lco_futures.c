@@ -104,7 +104,63 @@ static int lco_future_array_handler(void) {
 }
 static HPX_ACTION(HPX_DEFAULT, 0, lco_future_array, lco_future_array_handler);
 
+// Set or fail the futures in an array, from a separate thread so that
+// hpx_lco_get_all() sees futures that have not been triggered yet.
+static int _set_futures_handler(hpx_addr_t base, int n) {
+  for (int i = 0; i < n; ++i) {
+    hpx_addr_t f = hpx_lco_future_array_at(base, i, sizeof(uint64_t), 1);
+    if (i == n - 1) {
+      hpx_lco_error(f, HPX_LCO_ERROR, HPX_NULL);
+    }
+    else {
+      uint64_t v = SET_VALUE + i;
+      hpx_lco_set(f, sizeof(v), &v, HPX_NULL, HPX_NULL);
+    }
+  }
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _set_futures, _set_futures_handler,
+                  HPX_ADDR, HPX_INT);
+
+// hpx_lco_get_all() and hpx_lco_wait_all() on futures spread over all of the
+// localities, with one of them in an error state.
+static int lco_future_get_all_handler(void) {
+  printf("Starting the get_all on remote futures test\n");
+  int n = 8 * HPX_LOCALITIES;
+  hpx_addr_t base = hpx_lco_future_array_new(n, sizeof(uint64_t), 1);
+  hpx_addr_t futures[n];
+  uint64_t values[n];
+  void *addresses[n];
+  size_t sizes[n];
+  hpx_status_t statuses[n];
+  for (int i = 0; i < n; ++i) {
+    futures[i] = hpx_lco_future_array_at(base, i, sizeof(uint64_t), 1);
+    values[i] = 0;
+    addresses[i] = &values[i];
+    sizes[i] = sizeof(uint64_t);
+  }
+
+  CHECK( hpx_call(HPX_HERE, _set_futures, HPX_NULL, &base, &n) );
+  int errors = hpx_lco_get_all(n, futures, sizes, addresses, statuses);
+  test_assert(errors == 1);
+  for (int i = 0; i < n - 1; ++i) {
+    test_assert(statuses[i] == HPX_SUCCESS);
+    test_assert(values[i] == (uint64_t)(SET_VALUE + i));
+  }
+  test_assert(statuses[n - 1] == HPX_LCO_ERROR);
+
+  errors = hpx_lco_wait_all(n, futures, statuses);
+  test_assert(errors == 1);
+  test_assert(statuses[n - 1] == HPX_LCO_ERROR);
+
+  hpx_gas_free(base, HPX_NULL);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_future_get_all,
+                  lco_future_get_all_handler);
+
 TEST_MAIN({
  ADD_TEST(lco_future_new, 0);
  ADD_TEST(lco_future_array, 0);
+ ADD_TEST(lco_future_get_all, 0);
 });
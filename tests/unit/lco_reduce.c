@@ -111,6 +111,85 @@ static int lco_reduce_getRef_handler(void) {
 }
 static HPX_ACTION(HPX_DEFAULT, 0, lco_reduce_getRef, lco_reduce_getRef_handler);
 
+// The combining tree has the same interface as the reduce, so repeat the basic
+// test using one.
+static int lco_reduce_tree_handler(void) {
+  static const double data = 3141592653.58979;
+  static const int nDoms = 91;
+  static const int cycles = 10;
+  hpx_addr_t domain = hpx_gas_calloc_cyclic(nDoms, sizeof(int), 0);
+  hpx_addr_t newdt = hpx_lco_reduce_tree_new(nDoms, sizeof(double),
+                                             _initDouble, _addDouble, 2);
+
+  for (int i = 0, e = cycles; i < e; ++i) {
+    printf("tree reducing iteration %d \n", i);
+    hpx_addr_t and = hpx_lco_and_new(nDoms);
+    for (int j = 0, e = nDoms; j < e; ++j) {
+      hpx_addr_t block = hpx_addr_add(domain, sizeof(int) * j, sizeof(int));
+      hpx_call_async(block, _reduce, and, newdt, &data);
+    }
+    hpx_lco_wait(and);
+    hpx_lco_delete(and, HPX_NULL);
+
+    double ans;
+    hpx_lco_get(newdt, sizeof(ans), &ans);
+    double compval = nDoms * data;
+    if (fabs((compval - ans)/compval) > 0.001) {
+      fprintf(stderr, "expected %f, got %f (delta = %f)\n", nDoms * data, ans,
+          fabs(nDoms * data - ans));
+      exit(EXIT_FAILURE);
+    }
+    hpx_lco_reset_sync(newdt);
+  }
+
+  hpx_lco_delete_sync(newdt);
+  hpx_gas_free(domain, HPX_NULL);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_reduce_tree, lco_reduce_tree_handler);
+
+// Use the built-in vector monoids to reduce an array from every thread.
+static int _set_vector_handler(hpx_addr_t lco, int i) {
+  int64_t v[16];
+  for (int j = 0; j < 16; ++j) {
+    v[j] = i + j;
+  }
+  hpx_lco_set_rsync(lco, sizeof(v), v);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _set_vector, _set_vector_handler, HPX_ADDR,
+                  HPX_INT);
+
+static int lco_reduce_vector_handler(void) {
+  static const int n = 64;
+  hpx_addr_t sum = hpx_lco_reduce_new(n, 16 * sizeof(int64_t),
+                                      HPX_INT64_SUM_ID_ACTION,
+                                      HPX_INT64_SUM_OP_ACTION);
+  hpx_addr_t max = hpx_lco_reduce_new(n, 16 * sizeof(int64_t),
+                                      HPX_INT64_MAX_ID_ACTION,
+                                      HPX_INT64_MAX_OP_ACTION);
+  hpx_addr_t and = hpx_lco_and_new(2 * n);
+  for (int i = 0; i < n; ++i) {
+    hpx_call(HPX_HERE, _set_vector, and, &sum, &i);
+    hpx_call(HPX_HERE, _set_vector, and, &max, &i);
+  }
+  hpx_lco_wait(and);
+  hpx_lco_delete(and, HPX_NULL);
+
+  int64_t sums[16], maxs[16];
+  CHECK( hpx_lco_get(sum, sizeof(sums), sums) );
+  CHECK( hpx_lco_get(max, sizeof(maxs), maxs) );
+  for (int j = 0; j < 16; ++j) {
+    test_assert(sums[j] == (int64_t)n * (n - 1) / 2 + (int64_t)n * j);
+    test_assert(maxs[j] == n - 1 + j);
+  }
+
+  hpx_lco_delete_sync(sum);
+  hpx_lco_delete_sync(max);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_reduce_vector, lco_reduce_vector_handler);
+
 struct _par_reduce_args {
   hpx_addr_t rlco;
   double *nums;
@@ -163,5 +242,7 @@ static HPX_ACTION(HPX_DEFAULT, 0, lco_par_reduce, lco_par_reduce_handler);
 TEST_MAIN({
   ADD_TEST(lco_reduce, 0);
   ADD_TEST(lco_reduce_getRef, 0);
+  ADD_TEST(lco_reduce_tree, 0);
+  ADD_TEST(lco_reduce_vector, 0);
   ADD_TEST(lco_par_reduce, 0);
 });
@@ -0,0 +1,88 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#include <inttypes.h>
+#include "hpx/hpx.h"
+#include "tests.h"
+
+#define SET_VALUE 1234
+
+static int _get_rank_handler(void) {
+  uint64_t rank = HPX_LOCALITY_ID + SET_VALUE;
+  return HPX_THREAD_CONTINUE(rank);
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _get_rank, _get_rank_handler);
+
+static int _fail_handler(void) {
+  return HPX_LCO_ERROR;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, _fail, _fail_handler);
+
+// Waiters live on the stack but are addressable from every locality, so use
+// them as the continuation target for calls to each rank.
+static int lco_waiter_remote_handler(void) {
+  printf("Starting the remote waiter test\n");
+  for (int i = 0; i < HPX_LOCALITIES; ++i) {
+    uint64_t value = 0;
+    hpx_lco_waiter_t waiter;
+    hpx_addr_t sync = hpx_lco_waiter_init(&waiter, sizeof(value), &value);
+    CHECK( hpx_call(HPX_THERE(i), _get_rank, sync) );
+    CHECK( hpx_lco_waiter_wait(&waiter) );
+    hpx_lco_waiter_fini(&waiter);
+    test_assert(value == (uint64_t)(i + SET_VALUE));
+  }
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_waiter_remote,
+                  lco_waiter_remote_handler);
+
+// The waiter address works with the generic LCO interface too.
+static int lco_waiter_generic_handler(void) {
+  printf("Starting the generic waiter test\n");
+  uint64_t value = 0;
+  uint64_t set = SET_VALUE;
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t lco = hpx_lco_waiter_init(&waiter, sizeof(value), &value);
+  hpx_lco_set(lco, sizeof(set), &set, HPX_NULL, HPX_NULL);
+
+  uint64_t copy = 0;
+  CHECK( hpx_lco_get(lco, sizeof(copy), &copy) );
+  hpx_lco_waiter_fini(&waiter);
+  test_assert(value == SET_VALUE);
+  test_assert(copy == SET_VALUE);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_waiter_generic,
+                  lco_waiter_generic_handler);
+
+// Errors from remote continuations are reported through the waiter.
+static int lco_waiter_error_handler(void) {
+  printf("Starting the waiter error test\n");
+  hpx_lco_waiter_t waiter;
+  hpx_addr_t sync = hpx_lco_waiter_init(&waiter, 0, NULL);
+  hpx_lco_error(sync, HPX_LCO_ERROR, HPX_NULL);
+  hpx_status_t status = hpx_lco_waiter_wait(&waiter);
+  hpx_lco_waiter_fini(&waiter);
+  test_assert(status == HPX_LCO_ERROR);
+
+  int rank = HPX_LOCALITIES - 1;
+  test_assert(hpx_call_sync(HPX_THERE(rank), _fail, NULL, 0) == HPX_LCO_ERROR);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, lco_waiter_error, lco_waiter_error_handler);
+
+TEST_MAIN({
+ ADD_TEST(lco_waiter_remote, 0);
+ ADD_TEST(lco_waiter_generic, 0);
+ ADD_TEST(lco_waiter_error, 0);
+});
@@ -0,0 +1,115 @@
+// =============================================================================
+//  High Performance ParalleX Library (libhpx)
+//
+//  Copyright (c) 2013-2017, Trustees of Indiana University,
+//  All rights reserved.
+//
+//  This software may be modified and distributed under the terms of the BSD
+//  license.  See the COPYING file for details.
+//
+//  This software was created at the Indiana University Center for Research in
+//  Extreme Scale Technologies (CREST).
+// =============================================================================
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "tests.h"
+#include "Stream.h"
+#include "metadata.h"
+#include "hpx/hpx.h"
+#include <fcntl.h>
+#include <vector>
+
+using libhpx::instrumentation::Stream;
+
+static const size_t BYTES = 4096;
+static const int EVENT = 1;
+
+static size_t remaining(Stream& stream) {
+  return stream.buffer()->end - stream.buffer()->next;
+}
+
+// Fill both halves of a stream without draining it, drop a record, and then
+// append a record that fits in what's left of the buffer but doesn't leave
+// room for the record of the drop. That record must be dropped too, rather
+// than written past the end of the buffer.
+static int libhpx_trace_stream_handler(void) {
+  char path[] = "/tmp/hpx-trace-stream-XXXXXX";
+  int fd = mkstemp(path);
+  test_assert(fd >= 0);
+
+  const uint64_t args[4] = {1, 2, 3, 4};
+  int appended = 0;
+  {
+    Stream stream(fd, BYTES);
+
+    // Fill the first half, and hand it off.
+    while (!stream.append(EVENT, 0, args)) {
+      ++appended;
+    }
+    ++appended;
+
+    // Fill the second half with 16 byte records until there's room for a
+    // small record, but not for a small record and a drop record (24 bytes).
+    while (remaining(stream) >= 40) {
+      test_assert(!stream.append(EVENT, 0, args));
+      ++appended;
+    }
+    test_assert(remaining(stream) >= 16);
+
+    // The first half hasn't been drained, so a 48 byte record is dropped.
+    test_assert(!stream.append(EVENT, 4, args));
+    test_assert(stream.dropped() == 1);
+
+    test_assert(!stream.append(EVENT, 0, args));
+    test_assert(stream.dropped() == 2);
+    test_assert(stream.buffer()->next <= stream.buffer()->end);
+
+    // Once the first half is drained the drops are recorded in the stream.
+    stream.drain();
+    test_assert(stream.append(EVENT, 0, args));
+    ++appended;
+    stream.finish();
+  }
+
+  // Walk the records in the stream.
+  int in = open(path, O_RDONLY);
+  test_assert(in >= 0);
+  unlink(path);
+  std::vector<char> bytes;
+  char buffer[BYTES];
+  for (ssize_t n; (n = read(in, buffer, sizeof(buffer))) > 0; ) {
+    bytes.insert(bytes.end(), buffer, buffer + n);
+  }
+  close(in);
+
+  int records = 0;
+  uint64_t dropped = 0;
+  size_t i = 0;
+  while (i < bytes.size()) {
+    test_assert(i + sizeof(stream_record_t) <= bytes.size());
+    const stream_record_t *r =
+        reinterpret_cast<const stream_record_t*>(&bytes[i]);
+    i += sizeof(*r) + r->bytes;
+    test_assert(i <= bytes.size());
+    if (r->event == TRACE_DROPPED) {
+      dropped += reinterpret_cast<const record_t*>(r + 1)->user[0];
+    }
+    else {
+      test_assert(r->event == EVENT);
+      test_assert(r->bytes == sizeof(record_t));
+      ++records;
+    }
+  }
+  test_assert(records == appended);
+  test_assert(dropped == 2);
+  return HPX_SUCCESS;
+}
+static HPX_ACTION(HPX_DEFAULT, 0, libhpx_trace_stream,
+                  libhpx_trace_stream_handler);
+
+TEST_MAIN({
+    ADD_TEST(libhpx_trace_stream, 0);
+});
@@ -11,6 +11,10 @@
 //  Extreme Scale Technologies (CREST).
 // =============================================================================
 
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
 #include "hpx/hpx.h"
 #include "tests.h"
 
@@ -69,6 +73,28 @@ static int _spmd_handler(int iteration) {
 }
 HPX_ACTION(HPX_DEFAULT, 0, _spmd, _spmd_handler, HPX_INT);
 
+/// Write a report with @p dump, and check that it starts with @p header.
+///
+/// @returns The report, opened after the header.
+static FILE *_dump(const char *what, int (*dump)(const char *),
+                   const char *header) {
+  char path[] = "/tmp/hpx_dump_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+  int success = dump(path);
+  assert(success == HPX_SUCCESS);
+  FILE *f = fopen(path, "r");
+  unlink(path);
+  char line[128];
+  if (!f || !fgets(line, sizeof(line), f) ||
+      strncmp(line, header, strlen(header))) {
+    fprintf(stderr, "%s wrote an unexpected header.\n", what);
+    abort();
+  }
+  return f;
+}
+
 int main(int argc, char *argv[argc]) {
   if (hpx_initialized()) {
     fprintf(stderr, "HPX claims to be initialized before hpx_init.\n");
@@ -118,6 +144,43 @@ int main(int argc, char *argv[argc]) {
     }
   }
 
+  {
+    FILE *f = _dump("hpx_profile_dump", hpx_profile_dump,
+                    "rank,id,action,metric,");
+    fclose(f);
+  }
+
+  {
+    FILE *f = _dump("hpx_sched_dump", hpx_sched_dump,
+                    "rank,worker,metric,value,ratio\n");
+#ifdef ENABLE_INSTRUMENTATION
+    // The workers have run the actions above, so they must have been charged
+    // for some time.
+    double user = -1, sched = -1;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+      int rank;
+      char worker[16], metric[32];
+      double value;
+      if (sscanf(line, "%d,%15[^,],%31[^,],%lf", &rank, worker, metric,
+                 &value) != 4 || strcmp(worker, "all")) {
+        continue;
+      }
+      if (!strcmp(metric, "user_seconds")) {
+        user = value;
+      }
+      else if (!strcmp(metric, "sched_seconds")) {
+        sched = value;
+      }
+    }
+    if (user < 0 || sched < 0 || user + sched <= 0) {
+      fprintf(stderr, "hpx_sched_dump did not account for the workers.\n");
+      abort();
+    }
+#endif
+    fclose(f);
+  }
+
   hpx_finalize();
   printf("hpx_finalize completed %d.\n", 1);
 